@@ -0,0 +1,653 @@
+#include "alarm_engine.h"
+#include <gio/gio.h>
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#define ALARM_ENGINE_RATE_HZ     100
+#define ALARM_ENGINE_PERIOD_US   (G_USEC_PER_SEC / ALARM_ENGINE_RATE_HZ)
+#define ALARM_ENGINE_RING_SIZE   (1 << 18)
+#define ALARM_ENGINE_DRAIN_CHUNK 1024
+#define ALARM_ENGINE_ALL         G_MAXUINT   /* LimitsUpdate for every channel */
+
+enum {
+  SIGNAL_TRANSITIONS,
+  N_SIGNALS
+};
+
+static guint obj_signals[N_SIGNALS] = { 0, };
+
+/* A limits change on its way from the main thread to the worker */
+typedef struct {
+  guint       channel;
+  AlarmLimits limits;
+} LimitsUpdate;
+
+/* Structure of arrays, one lane per channel, padded to a multiple of four
+ * lanes. Padding lanes hold NaN values and never alarm. Worker only. */
+typedef struct {
+  guint    n;
+  float   *value;
+  float   *rate;
+  float   *low_low;
+  float   *low;
+  float   *high;
+  float   *high_high;
+  float   *deadband;
+  float   *rate_limit;
+  float   *rate_deadband;
+  guint32 *state;       /* GaugeAlarm */
+  gint64  *timestamp;   /* of value; G_MININT64 before the first sample */
+} AlarmTables;
+
+struct _AlarmEngine {
+  GObject parent_instance;
+
+  guint          n_channels;
+  TelemetryRing *input;       /* producer thread → worker */
+  GAsyncQueue   *updates;     /* LimitsUpdate, main thread → worker */
+
+  /* Worker only */
+  AlarmTables    tables;
+  GArray        *outbox;      /* AlarmTransition of the current pass */
+
+  GThread       *worker;
+  GMutex         lock;
+  GCond          cond;
+  gboolean       stopping;    /* lock */
+  GArray        *pending;     /* AlarmTransition, lock */
+  guint          delivery_id; /* idle source delivering pending, lock */
+  AlarmEngineStats stats;     /* lock, except in_alarm */
+
+  /* Main thread only */
+  GArray        *delivered;   /* spare array swapped with pending */
+  guint8        *alarms;      /* GaugeAlarm per channel */
+  guint          in_alarm;
+};
+
+G_DEFINE_FINAL_TYPE(AlarmEngine, alarm_engine, G_TYPE_OBJECT)
+
+/* --- Tables --- */
+static float *
+new_lanes(guint n, float fill)
+{
+  float *lanes = g_new(float, n);
+
+  for (guint i = 0; i < n; i++)
+    lanes[i] = fill;
+  return lanes;
+}
+
+static void
+alarm_tables_init(AlarmTables *t, guint n_channels)
+{
+  t->n             = (n_channels + 3) & ~3u;
+  t->value         = new_lanes(t->n, NAN);
+  t->rate          = new_lanes(t->n, 0.0f);
+  t->low_low       = new_lanes(t->n, -INFINITY);
+  t->low           = new_lanes(t->n, -INFINITY);
+  t->high          = new_lanes(t->n, INFINITY);
+  t->high_high     = new_lanes(t->n, INFINITY);
+  t->deadband      = new_lanes(t->n, 0.0f);
+  t->rate_limit    = new_lanes(t->n, INFINITY);
+  t->rate_deadband = new_lanes(t->n, 0.0f);
+  t->state         = g_new0(guint32, t->n);
+  t->timestamp     = g_new(gint64, t->n);
+
+  for (guint i = 0; i < t->n; i++)
+    t->timestamp[i] = G_MININT64;
+}
+
+static void
+alarm_tables_clear(AlarmTables *t)
+{
+  g_free(t->value);
+  g_free(t->rate);
+  g_free(t->low_low);
+  g_free(t->low);
+  g_free(t->high);
+  g_free(t->high_high);
+  g_free(t->deadband);
+  g_free(t->rate_limit);
+  g_free(t->rate_deadband);
+  g_free(t->state);
+  g_free(t->timestamp);
+}
+
+static void
+alarm_tables_set_limits(AlarmTables *t, guint i, const AlarmLimits *l)
+{
+  t->low_low[i]       = l->low_low;
+  t->low[i]           = l->low;
+  t->high[i]          = l->high;
+  t->high_high[i]     = l->high_high;
+  t->deadband[i]      = l->deadband;
+  t->rate_limit[i]    = l->rate_limit;
+  t->rate_deadband[i] = l->rate_deadband;
+}
+
+/* --- Worker: input --- */
+static void
+apply_updates(AlarmEngine *self)
+{
+  LimitsUpdate *update;
+
+  while ((update = g_async_queue_try_pop(self->updates)) != NULL) {
+    if (update->channel == ALARM_ENGINE_ALL) {
+      for (guint i = 0; i < self->n_channels; i++)
+        alarm_tables_set_limits(&self->tables, i, &update->limits);
+    } else {
+      alarm_tables_set_limits(&self->tables, update->channel, &update->limits);
+    }
+    g_free(update);
+  }
+}
+
+/* Scatter the queued samples into the value lanes. At most one ring's
+ * worth per pass, so a producer outrunning us cannot stall evaluation. */
+static guint
+take_samples(AlarmEngine *self)
+{
+  AlarmTables *t = &self->tables;
+  TelemetrySample buf[ALARM_ENGINE_DRAIN_CHUNK];
+  guint total = 0, n;
+
+  while (total < ALARM_ENGINE_RING_SIZE &&
+         (n = telemetry_ring_pop(self->input, buf, G_N_ELEMENTS(buf))) > 0) {
+    for (guint k = 0; k < n; k++) {
+      const TelemetrySample *s = &buf[k];
+      const guint c = s->channel;
+
+      if (c >= self->n_channels)
+        continue;
+
+      if (t->timestamp[c] != G_MININT64 && s->timestamp > t->timestamp[c])
+        t->rate[c] = (float)((s->value - t->value[c]) * G_USEC_PER_SEC /
+                             (double)(s->timestamp - t->timestamp[c]));
+      t->value[c]     = (float)s->value;
+      t->timestamp[c] = s->timestamp;
+    }
+    total += n;
+  }
+
+  return total;
+}
+
+/* --- Worker: evaluation --- */
+static void
+report(AlarmEngine *self, guint i, guint32 old_state, guint32 new_state)
+{
+  const AlarmTransition transition = {
+    .channel   = i,
+    .old_alarm = old_state,
+    .new_alarm = new_state,
+    .value     = self->tables.value[i],
+    .timestamp = self->tables.timestamp[i],
+  };
+
+  g_array_append_val(self->outbox, transition);
+}
+
+#if defined(__GNUC__)
+/* Four channels per step with GCC vector extensions, as in trend_buffer.c.
+ * A comparison yields an all-ones lane where it holds, so every alarm bit
+ * is a few compares and masks with no branches. */
+typedef float  v4sf __attribute__((vector_size(16)));
+typedef gint32 v4si __attribute__((vector_size(16)));
+
+static inline v4sf
+v4_load(const float *p)
+{
+  v4sf v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline v4si
+v4i_load(const guint32 *p)
+{
+  v4si v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void
+v4i_store(guint32 *p, v4si v)
+{
+  memcpy(p, &v, sizeof(v));
+}
+
+static void
+evaluate(AlarmEngine *self)
+{
+  const AlarmTables *t = &self->tables;
+
+  for (guint i = 0; i < t->n; i += 4) {
+    const v4sf v   = v4_load(t->value + i);
+    const v4sf r   = (v4sf)((v4si)v4_load(t->rate + i) & 0x7fffffff);  /* |rate| */
+    const v4sf db  = v4_load(t->deadband + i);
+    const v4sf lo  = v4_load(t->low + i);
+    const v4sf ll  = v4_load(t->low_low + i);
+    const v4sf hi  = v4_load(t->high + i);
+    const v4sf hh  = v4_load(t->high_high + i);
+    const v4sf rl  = v4_load(t->rate_limit + i);
+    const v4sf rdb = v4_load(t->rate_deadband + i);
+    const v4si old = v4i_load(t->state + i);
+
+    /* Set beyond the limit; once set, held until back past the deadband */
+    const v4si st =
+      (((v < lo)  | (((old & GAUGE_ALARM_LOW) != 0)       & (v < lo + db)))  & GAUGE_ALARM_LOW)       |
+      (((v > hi)  | (((old & GAUGE_ALARM_HIGH) != 0)      & (v > hi - db)))  & GAUGE_ALARM_HIGH)      |
+      (((v < ll)  | (((old & GAUGE_ALARM_LOW_LOW) != 0)   & (v < ll + db)))  & GAUGE_ALARM_LOW_LOW)   |
+      (((v > hh)  | (((old & GAUGE_ALARM_HIGH_HIGH) != 0) & (v > hh - db)))  & GAUGE_ALARM_HIGH_HIGH) |
+      (((r > rl)  | (((old & GAUGE_ALARM_RATE) != 0)      & (r > rl - rdb))) & GAUGE_ALARM_RATE);
+
+    const v4si changed = st != old;
+    if (changed[0] | changed[1] | changed[2] | changed[3]) {
+      for (guint k = 0; k < 4; k++)
+        if (changed[k])
+          report(self, i + k, (guint32)old[k], (guint32)st[k]);
+      v4i_store(t->state + i, st);
+    }
+  }
+}
+#else
+static inline guint32
+alarm_bit(guint32 old, guint32 bit, gboolean beyond, gboolean held)
+{
+  return (beyond || ((old & bit) && held)) ? bit : 0;
+}
+
+static void
+evaluate(AlarmEngine *self)
+{
+  const AlarmTables *t = &self->tables;
+
+  for (guint i = 0; i < t->n; i++) {
+    const float v  = t->value[i];
+    const float r  = fabsf(t->rate[i]);
+    const float db = t->deadband[i];
+    const guint32 old = t->state[i];
+    const guint32 st =
+      alarm_bit(old, GAUGE_ALARM_LOW,       v < t->low[i],       v < t->low[i] + db)       |
+      alarm_bit(old, GAUGE_ALARM_HIGH,      v > t->high[i],      v > t->high[i] - db)      |
+      alarm_bit(old, GAUGE_ALARM_LOW_LOW,   v < t->low_low[i],   v < t->low_low[i] + db)   |
+      alarm_bit(old, GAUGE_ALARM_HIGH_HIGH, v > t->high_high[i], v > t->high_high[i] - db) |
+      alarm_bit(old, GAUGE_ALARM_RATE,      r > t->rate_limit[i],
+                r > t->rate_limit[i] - t->rate_deadband[i]);
+
+    if (st != old) {
+      report(self, i, old, st);
+      t->state[i] = st;
+    }
+  }
+}
+#endif
+
+/* --- Worker: delivery --- */
+static gboolean deliver_cb(gpointer user_data);
+
+static void
+alarm_engine_pass(AlarmEngine *self)
+{
+  apply_updates(self);
+  const guint samples = take_samples(self);
+
+  const gint64 start = g_get_monotonic_time();
+  evaluate(self);
+  const gint64 elapsed = g_get_monotonic_time() - start;
+
+  g_mutex_lock(&self->lock);
+  self->stats.evaluations++;
+  self->stats.samples     += samples;
+  self->stats.last_eval_us = elapsed;
+  self->stats.max_eval_us  = MAX(self->stats.max_eval_us, elapsed);
+
+  /* One idle for however many passes the main loop is behind */
+  if (self->outbox->len > 0) {
+    g_array_append_vals(self->pending, self->outbox->data, self->outbox->len);
+    if (self->delivery_id == 0)
+      self->delivery_id = g_idle_add(deliver_cb, self);
+  }
+  g_mutex_unlock(&self->lock);
+
+  g_array_set_size(self->outbox, 0);
+}
+
+static gpointer
+alarm_engine_worker(gpointer data)
+{
+  AlarmEngine *self = data;
+  gint64 next = g_get_monotonic_time();
+
+  g_mutex_lock(&self->lock);
+  while (!self->stopping) {
+    next += ALARM_ENGINE_PERIOD_US;
+    while (!self->stopping && g_cond_wait_until(&self->cond, &self->lock, next))
+      ;  /* woken early: only stop() signals */
+    if (self->stopping)
+      break;
+
+    g_mutex_unlock(&self->lock);
+    alarm_engine_pass(self);
+    g_mutex_lock(&self->lock);
+
+    /* Fell behind: skip the missed passes instead of running them back to back */
+    const gint64 now = g_get_monotonic_time();
+    if (now > next + ALARM_ENGINE_PERIOD_US)
+      next = now;
+  }
+  g_mutex_unlock(&self->lock);
+
+  return NULL;
+}
+
+/* Main thread: publish what the worker found */
+static gboolean
+deliver_cb(gpointer user_data)
+{
+  AlarmEngine *self = ALARM_ENGINE(user_data);
+
+  g_mutex_lock(&self->lock);
+  GArray *batch = self->pending;
+  self->pending = self->delivered;
+  self->delivery_id = 0;
+  g_mutex_unlock(&self->lock);
+
+  const AlarmTransition *transitions = (const AlarmTransition *)batch->data;
+  for (guint i = 0; i < batch->len; i++) {
+    const AlarmTransition *tr = &transitions[i];
+
+    if (tr->old_alarm == GAUGE_ALARM_NONE)
+      self->in_alarm++;
+    else if (tr->new_alarm == GAUGE_ALARM_NONE)
+      self->in_alarm--;
+    self->alarms[tr->channel] = tr->new_alarm;
+  }
+
+  g_signal_emit(self, obj_signals[SIGNAL_TRANSITIONS], 0, batch->data, batch->len);
+
+  g_array_set_size(batch, 0);
+  self->delivered = batch;
+
+  return G_SOURCE_REMOVE;
+}
+
+/* --- GObject --- */
+static void
+alarm_engine_dispose(GObject *object)
+{
+  AlarmEngine *self = ALARM_ENGINE(object);
+
+  /* With the worker gone, nothing can schedule another delivery */
+  alarm_engine_stop(self);
+  g_clear_handle_id(&self->delivery_id, g_source_remove);
+
+  G_OBJECT_CLASS(alarm_engine_parent_class)->dispose(object);
+}
+
+static void
+alarm_engine_finalize(GObject *object)
+{
+  AlarmEngine *self = ALARM_ENGINE(object);
+
+  alarm_tables_clear(&self->tables);
+  telemetry_ring_free(self->input);
+  g_async_queue_unref(self->updates);
+  g_array_unref(self->outbox);
+  g_array_unref(self->pending);
+  g_array_unref(self->delivered);
+  g_free(self->alarms);
+  g_mutex_clear(&self->lock);
+  g_cond_clear(&self->cond);
+
+  G_OBJECT_CLASS(alarm_engine_parent_class)->finalize(object);
+}
+
+static void
+alarm_engine_class_init(AlarmEngineClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->dispose  = alarm_engine_dispose;
+  object_class->finalize = alarm_engine_finalize;
+
+  /**
+   * AlarmEngine::transitions:
+   * @transitions: (array length=n_transitions): AlarmTransition, oldest first
+   * @n_transitions: number of transitions
+   *
+   * Channels that entered, left or changed alarm since the last emission.
+   * The array is only valid during the emission.
+   */
+  obj_signals[SIGNAL_TRANSITIONS] = g_signal_new("transitions",
+                                                 G_TYPE_FROM_CLASS(klass),
+                                                 G_SIGNAL_RUN_LAST,
+                                                 0, NULL, NULL, NULL,
+                                                 G_TYPE_NONE, 2, G_TYPE_POINTER, G_TYPE_UINT);
+}
+
+static void
+alarm_engine_init(AlarmEngine *self)
+{
+  self->input       = telemetry_ring_new(ALARM_ENGINE_RING_SIZE);
+  self->updates     = g_async_queue_new_full(g_free);
+  self->outbox      = g_array_new(FALSE, FALSE, sizeof(AlarmTransition));
+  self->pending     = g_array_new(FALSE, FALSE, sizeof(AlarmTransition));
+  self->delivered   = g_array_new(FALSE, FALSE, sizeof(AlarmTransition));
+  self->worker      = NULL;
+  self->stopping    = FALSE;
+  self->delivery_id = 0;
+  self->in_alarm    = 0;
+  memset(&self->stats, 0, sizeof(self->stats));
+  g_mutex_init(&self->lock);
+  g_cond_init(&self->cond);
+}
+
+/* --- Limits --- */
+void
+alarm_limits_init(AlarmLimits *limits)
+{
+  limits->low_low       = -INFINITY;
+  limits->low           = -INFINITY;
+  limits->high          = INFINITY;
+  limits->high_high     = INFINITY;
+  limits->deadband      = 0.0f;
+  limits->rate_limit    = INFINITY;
+  limits->rate_deadband = 0.0f;
+}
+
+static void
+queue_update(AlarmEngine *self, guint channel, const AlarmLimits *limits)
+{
+  LimitsUpdate *update = g_new(LimitsUpdate, 1);
+
+  update->channel = channel;
+  update->limits  = *limits;
+  g_async_queue_push(self->updates, update);
+}
+
+static const struct {
+  const char *key;
+  gsize       offset;
+} limit_keys[] = {
+  { "low-low",       offsetof(AlarmLimits, low_low) },
+  { "low",           offsetof(AlarmLimits, low) },
+  { "high",          offsetof(AlarmLimits, high) },
+  { "high-high",     offsetof(AlarmLimits, high_high) },
+  { "deadband",      offsetof(AlarmLimits, deadband) },
+  { "rate-limit",    offsetof(AlarmLimits, rate_limit) },
+  { "rate-deadband", offsetof(AlarmLimits, rate_deadband) },
+};
+
+/* Override the fields of @limits that @group sets */
+static gboolean
+read_limits(GKeyFile *key_file, const char *group, AlarmLimits *limits, GError **error)
+{
+  for (guint i = 0; i < G_N_ELEMENTS(limit_keys); i++) {
+    GError *local_error = NULL;
+
+    if (!g_key_file_has_key(key_file, group, limit_keys[i].key, NULL))
+      continue;
+
+    double value = g_key_file_get_double(key_file, group, limit_keys[i].key, &local_error);
+    if (local_error != NULL) {
+      g_propagate_prefixed_error(error, local_error, "[%s] ", group);
+      return FALSE;
+    }
+
+    *(float *)((char *)limits + limit_keys[i].offset) = (float)value;
+  }
+
+  return TRUE;
+}
+
+/* --- Public API --- */
+AlarmEngine *
+alarm_engine_new(guint n_channels)
+{
+  g_return_val_if_fail(n_channels > 0 && n_channels < G_MAXUINT - 3, NULL);
+
+  AlarmEngine *self = g_object_new(ALARM_TYPE_ENGINE, NULL);
+  self->n_channels = n_channels;
+  self->alarms = g_new0(guint8, n_channels);
+  alarm_tables_init(&self->tables, n_channels);
+
+  return self;
+}
+
+TelemetryRing *
+alarm_engine_get_input(AlarmEngine *self)
+{
+  g_return_val_if_fail(ALARM_IS_ENGINE(self), NULL);
+  return self->input;
+}
+
+void
+alarm_engine_set_limits(AlarmEngine *self, guint channel, const AlarmLimits *limits)
+{
+  g_return_if_fail(ALARM_IS_ENGINE(self));
+  g_return_if_fail(channel < self->n_channels);
+  g_return_if_fail(limits != NULL);
+
+  queue_update(self, channel, limits);
+}
+
+void
+alarm_engine_set_default_limits(AlarmEngine *self, const AlarmLimits *limits)
+{
+  g_return_if_fail(ALARM_IS_ENGINE(self));
+  g_return_if_fail(limits != NULL);
+
+  queue_update(self, ALARM_ENGINE_ALL, limits);
+}
+
+gboolean
+alarm_engine_load_limits(AlarmEngine *self, const char *path, GError **error)
+{
+  g_return_val_if_fail(ALARM_IS_ENGINE(self), FALSE);
+  g_return_val_if_fail(path != NULL, FALSE);
+
+  g_autoptr(GKeyFile) key_file = g_key_file_new();
+  if (!g_key_file_load_from_file(key_file, path, G_KEY_FILE_NONE, error))
+    return FALSE;
+
+  AlarmLimits defaults;
+  alarm_limits_init(&defaults);
+  if (g_key_file_has_group(key_file, "default") &&
+      !read_limits(key_file, "default", &defaults, error))
+    return FALSE;
+
+  /* Check every group before applying any, so a bad file changes nothing */
+  g_auto(GStrv) groups = g_key_file_get_groups(key_file, NULL);
+  g_autoptr(GArray) channels = g_array_new(FALSE, FALSE, sizeof(LimitsUpdate));
+
+  for (guint i = 0; groups[i] != NULL; i++) {
+    LimitsUpdate update = { 0, defaults };
+    guint64 channel;
+
+    if (g_str_equal(groups[i], "default"))
+      continue;
+
+    if (!g_str_has_prefix(groups[i], "channel ")) {
+      g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_GROUP_NOT_FOUND,
+                  "Unknown group [%s]: expected [default] or [channel N]", groups[i]);
+      return FALSE;
+    }
+    if (!g_ascii_string_to_unsigned(groups[i] + strlen("channel "), 10,
+                                    0, self->n_channels - 1, &channel, error) ||
+        !read_limits(key_file, groups[i], &update.limits, error))
+      return FALSE;
+
+    update.channel = (guint)channel;
+    g_array_append_val(channels, update);
+  }
+
+  queue_update(self, ALARM_ENGINE_ALL, &defaults);
+  for (guint i = 0; i < channels->len; i++) {
+    const LimitsUpdate *update = &g_array_index(channels, LimitsUpdate, i);
+    queue_update(self, update->channel, &update->limits);
+  }
+
+  return TRUE;
+}
+
+gboolean
+alarm_engine_start(AlarmEngine *self, GError **error)
+{
+  g_return_val_if_fail(ALARM_IS_ENGINE(self), FALSE);
+
+  if (self->worker != NULL)
+    return TRUE;
+
+  self->stopping = FALSE;
+  self->worker = g_thread_try_new("alarm-engine", alarm_engine_worker, self, error);
+
+  return self->worker != NULL;
+}
+
+void
+alarm_engine_stop(AlarmEngine *self)
+{
+  g_return_if_fail(ALARM_IS_ENGINE(self));
+
+  if (self->worker == NULL)
+    return;
+
+  g_mutex_lock(&self->lock);
+  self->stopping = TRUE;
+  g_cond_signal(&self->cond);
+  g_mutex_unlock(&self->lock);
+
+  g_thread_join(self->worker);
+  self->worker = NULL;
+}
+
+GaugeAlarm
+alarm_engine_get_alarm(AlarmEngine *self, guint channel)
+{
+  g_return_val_if_fail(ALARM_IS_ENGINE(self), GAUGE_ALARM_NONE);
+
+  return channel < self->n_channels ? self->alarms[channel] : GAUGE_ALARM_NONE;
+}
+
+guint
+alarm_engine_get_n_channels(AlarmEngine *self)
+{
+  g_return_val_if_fail(ALARM_IS_ENGINE(self), 0);
+  return self->n_channels;
+}
+
+void
+alarm_engine_get_stats(AlarmEngine *self, AlarmEngineStats *stats)
+{
+  g_return_if_fail(ALARM_IS_ENGINE(self));
+  g_return_if_fail(stats != NULL);
+
+  g_mutex_lock(&self->lock);
+  *stats = self->stats;
+  g_mutex_unlock(&self->lock);
+
+  stats->dropped  = telemetry_ring_get_dropped(self->input);
+  stats->in_alarm = self->in_alarm;
+}
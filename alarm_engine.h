@@ -0,0 +1,72 @@
+#pragma once
+#include <glib-object.h>
+#include "gauge_model.h"
+#include "telemetry_ring.h"
+
+G_BEGIN_DECLS
+
+#define ALARM_TYPE_ENGINE (alarm_engine_get_type())
+
+/* Limits of one channel. A disabled level limit is -INFINITY (low side)
+ * or INFINITY (high side); a disabled rate limit is INFINITY. */
+typedef struct {
+  float low_low;
+  float low;
+  float high;
+  float high_high;
+  float deadband;       /* a level alarm clears only this far inside its limit */
+  float rate_limit;     /* |Δvalue/Δt| in units per second */
+  float rate_deadband;  /* a rate alarm clears only this far below its limit */
+} AlarmLimits;
+
+/* One channel entering, leaving or changing alarm */
+typedef struct {
+  guint32    channel;
+  GaugeAlarm old_alarm;
+  GaugeAlarm new_alarm;
+  float      value;       /* value that caused the transition */
+  gint64     timestamp;   /* µs, of that value */
+} AlarmTransition;
+
+typedef struct {
+  guint64 evaluations;    /* passes over all channels */
+  guint64 samples;        /* samples taken from the input ring */
+  guint   dropped;        /* samples lost to a full input ring */
+  gint64  last_eval_us;   /* cost of the last pass */
+  gint64  max_eval_us;
+  guint   in_alarm;       /* channels with any alarm, as last delivered */
+} AlarmEngineStats;
+
+void alarm_limits_init(AlarmLimits *limits);  /* everything disabled */
+
+/* Evaluates the limits of every channel on a worker thread, at a fixed
+ * rate, over the newest value of each channel. Samples reach it through
+ * its input ring straight from the producer thread, so neither the
+ * samples nor the checks cost the main thread anything. Only
+ * transitions come back, batched, as the "transitions" signal on the
+ * main thread. */
+G_DECLARE_FINAL_TYPE(AlarmEngine, alarm_engine, ALARM, ENGINE, GObject)
+
+AlarmEngine   *alarm_engine_new(guint n_channels);
+
+/* Producer end for exactly one thread, e.g. telemetry_stream_set_tap() */
+TelemetryRing *alarm_engine_get_input(AlarmEngine *self);
+
+/* Take effect at the next evaluation. Main thread. */
+void           alarm_engine_set_limits(AlarmEngine *self, guint channel, const AlarmLimits *limits);
+void           alarm_engine_set_default_limits(AlarmEngine *self, const AlarmLimits *limits);
+
+/* Key file with an optional [default] group and [channel N] groups that
+ * override it, with keys low-low, low, high, high-high, deadband,
+ * rate-limit and rate-deadband */
+gboolean       alarm_engine_load_limits(AlarmEngine *self, const char *path, GError **error);
+
+gboolean       alarm_engine_start(AlarmEngine *self, GError **error);
+void           alarm_engine_stop(AlarmEngine *self);
+
+/* Main thread view, current as of the last delivered transition */
+GaugeAlarm     alarm_engine_get_alarm(AlarmEngine *self, guint channel);
+guint          alarm_engine_get_n_channels(AlarmEngine *self);
+void           alarm_engine_get_stats(AlarmEngine *self, AlarmEngineStats *stats);
+
+G_END_DECLS
@@ -0,0 +1,253 @@
+#include "dashboard_export.h"
+#include "dashboard_page.h"
+#include "gauge_animator.h"
+#include "offscreen_render.h"
+#include "quality_governor.h"
+#include "telemetry_replay.h"
+#include <errno.h>
+#include <glib/gstdio.h>
+
+/* Samples handed to the page per batch while catching up to an instant */
+#define EXPORT_SAMPLE_CHUNK 4096
+/* Finished frames waiting for an encoder, per encoder */
+#define EXPORT_QUEUE_PER_WORKER 2
+
+/* --- Encoder pool --- */
+
+/* One rendered frame on its way to disk. Textures are immutable, so a
+ * worker may download and encode one while the main thread renders on. */
+typedef struct {
+  GdkTexture *texture;
+  char       *path;
+} ExportJob;
+
+typedef struct {
+  GThreadPool *pool;
+  GMutex       lock;
+  GCond        cond;
+  guint        in_flight;       /* jobs pushed and not yet written, lock */
+  guint        max_in_flight;
+  GError      *error;           /* first failure, lock */
+} ExportPool;
+
+static void
+export_job_free(ExportJob *job)
+{
+  g_object_unref(job->texture);
+  g_free(job->path);
+  g_free(job);
+}
+
+static void
+export_pool_encode(gpointer data, gpointer user_data)
+{
+  ExportJob *job = data;
+  ExportPool *pool = user_data;
+  GError *error = NULL;
+
+  /* No fsync per frame: an interrupted export is simply run again */
+  g_autoptr(GBytes) png = gdk_texture_save_to_png_bytes(job->texture);
+  gsize size;
+  const char *bytes = g_bytes_get_data(png, &size);
+  gboolean ok = g_file_set_contents_full(job->path, bytes, size,
+                                         G_FILE_SET_CONTENTS_NONE, 0666, &error);
+  export_job_free(job);
+
+  g_mutex_lock(&pool->lock);
+  pool->in_flight--;
+  if (!ok && pool->error == NULL)
+    pool->error = g_steal_pointer(&error);
+  g_cond_signal(&pool->cond);
+  g_mutex_unlock(&pool->lock);
+
+  g_clear_error(&error);
+}
+
+static gboolean
+export_pool_init(ExportPool *pool, guint n_workers, GError **error)
+{
+  if (n_workers == 0)
+    n_workers = MAX(g_get_num_processors(), 1);
+
+  g_mutex_init(&pool->lock);
+  g_cond_init(&pool->cond);
+  pool->in_flight     = 0;
+  pool->max_in_flight = n_workers * EXPORT_QUEUE_PER_WORKER;
+  pool->error         = NULL;
+  pool->pool = g_thread_pool_new(export_pool_encode, pool, (int)n_workers, TRUE, error);
+
+  if (pool->pool == NULL) {
+    g_cond_clear(&pool->cond);
+    g_mutex_clear(&pool->lock);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Queue @texture for writing to @path, first waiting while the encoders
+ * are a full queue behind, so memory stays bounded however long the
+ * export. FALSE once any frame failed. */
+static gboolean
+export_pool_push(ExportPool *pool, GdkTexture *texture, const char *path)
+{
+  g_mutex_lock(&pool->lock);
+  while (pool->in_flight >= pool->max_in_flight && pool->error == NULL)
+    g_cond_wait(&pool->cond, &pool->lock);
+
+  const gboolean ok = pool->error == NULL;
+  if (ok)
+    pool->in_flight++;
+  g_mutex_unlock(&pool->lock);
+
+  if (!ok)
+    return FALSE;
+
+  ExportJob *job = g_new(ExportJob, 1);
+  job->texture = g_object_ref(texture);
+  job->path    = g_strdup(path);
+  g_thread_pool_push(pool->pool, job, NULL);
+
+  return TRUE;
+}
+
+/* Wait for every queued frame; returns the first failure, if any */
+static gboolean
+export_pool_finish(ExportPool *pool, GError **error)
+{
+  g_thread_pool_free(pool->pool, FALSE, TRUE);
+  g_mutex_clear(&pool->lock);
+  g_cond_clear(&pool->cond);
+
+  if (pool->error != NULL) {
+    g_propagate_error(error, pool->error);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* --- Feeding the page --- */
+typedef struct {
+  DashboardPage   *page;
+  TelemetrySample  chunk[EXPORT_SAMPLE_CHUNK];
+  guint            n;
+} ExportFeed;
+
+static void
+export_feed_flush(ExportFeed *feed)
+{
+  dashboard_page_apply_samples(feed->page, feed->chunk, feed->n);
+  feed->n = 0;
+}
+
+static void
+export_feed_sample(const TelemetrySample *sample, gpointer user_data)
+{
+  ExportFeed *feed = user_data;
+
+  feed->chunk[feed->n++] = *sample;
+  if (feed->n == EXPORT_SAMPLE_CHUNK)
+    export_feed_flush(feed);
+}
+
+/* --- Public API --- */
+void
+dashboard_export_options_init(DashboardExportOptions *options)
+{
+  options->capture_path = NULL;
+  options->output_dir   = NULL;
+  options->start        = 0;
+  options->end          = -1;
+  options->step         = G_USEC_PER_SEC;
+  options->width        = 0;
+  options->height       = 0;
+  options->n_workers    = 0;
+}
+
+gboolean
+dashboard_export_run(const DashboardExportOptions *options, guint *n_frames, GError **error)
+{
+  g_return_val_if_fail(options != NULL, FALSE);
+  g_return_val_if_fail(options->capture_path != NULL && options->output_dir != NULL, FALSE);
+  g_return_val_if_fail(options->step > 0, FALSE);
+
+  g_autoptr(TelemetryReplay) replay = telemetry_replay_new(options->capture_path, error);
+  if (replay == NULL)
+    return FALSE;
+
+  if (g_mkdir_with_parents(options->output_dir, 0777) != 0) {
+    int saved_errno = errno;
+    g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved_errno),
+                "Cannot create %s: %s", options->output_dir, g_strerror(saved_errno));
+    return FALSE;
+  }
+
+  /* Reports want the real thing, not what a busy machine could afford */
+  quality_governor_set_level(GAUGE_DETAIL_FULL, FALSE);
+
+  DashboardPage *page = g_object_new(DASHBOARD_TYPE_PAGE, NULL);
+  OffscreenRender *offscreen = offscreen_render_new(GTK_WIDGET(page), options->width,
+                                                    options->height, error);
+  if (offscreen == NULL) {
+    g_object_unref(g_object_ref_sink(page));
+    return FALSE;
+  }
+
+  ExportPool pool;
+  if (!export_pool_init(&pool, options->n_workers, error)) {
+    offscreen_render_free(offscreen);
+    return FALSE;
+  }
+
+  GaugeAnimator *animator = gauge_animator_get_for_clock(offscreen_render_get_frame_clock(offscreen));
+  ExportFeed *feed = g_new(ExportFeed, 1);
+  feed->page = page;
+  feed->n    = 0;
+
+  const gint64 origin = telemetry_replay_get_start_time(replay);
+  const gint64 last   = options->end >= 0 ? origin + options->end
+                                          : telemetry_replay_get_end_time(replay);
+  g_autoptr(GString) index = g_string_new("frame,timestamp_us,file\n");
+  gint64 settle = gauge_animator_get_time(animator);
+  guint frame = 0;
+  gboolean ok = TRUE;
+
+  for (gint64 t = origin + options->start; t <= last; t += options->step, frame++) {
+    /* Everything up to the instant, so trends carry their full history */
+    telemetry_replay_read_until(replay, t, export_feed_sample, feed);
+    export_feed_flush(feed);
+
+    /* An image shows where needles are headed, not where they are on the
+     * way: run the animations far enough ahead to settle */
+    settle += (gint64)3600 * G_USEC_PER_SEC;
+    gauge_animator_advance(animator, settle);
+
+    GskRenderNode *node = offscreen_render_snapshot(offscreen);
+    GdkTexture *texture = offscreen_render_render(offscreen, node);
+    gsk_render_node_unref(node);
+
+    g_autofree char *name = g_strdup_printf("frame-%06u.png", frame);
+    g_autofree char *path = g_build_filename(options->output_dir, name, NULL);
+    ok = export_pool_push(&pool, texture, path);
+    g_object_unref(texture);
+    if (!ok)
+      break;
+
+    g_string_append_printf(index, "%u,%" G_GINT64_FORMAT ",%s\n", frame, t, name);
+  }
+
+  g_free(feed);
+  offscreen_render_free(offscreen);
+
+  /* Always drain the pool, even after a failure: workers hold our state */
+  ok = export_pool_finish(&pool, error) && ok;
+
+  if (ok) {
+    g_autofree char *index_path = g_build_filename(options->output_dir, "index.csv", NULL);
+    ok = g_file_set_contents(index_path, index->str, (gssize)index->len, error);
+  }
+
+  if (n_frames != NULL)
+    *n_frames = frame;
+  return ok;
+}
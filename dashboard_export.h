@@ -0,0 +1,29 @@
+#pragma once
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* Renders the dashboard at instants of a telemetry capture to PNG files,
+ * without a window on screen. Rendering happens on the calling (main)
+ * thread with the software renderer; PNG encoding and writing happen on
+ * a pool of worker threads. */
+typedef struct {
+  const char *capture_path;  /* TelemetryRecorder capture supplying the values */
+  const char *output_dir;    /* created if missing */
+  gint64      start;         /* µs after the capture's first record */
+  gint64      end;           /* µs after the first record; < 0: to the last */
+  gint64      step;          /* µs between instants, > 0 */
+  int         width;         /* <= 0: natural size */
+  int         height;
+  guint       n_workers;     /* PNG encoders; 0: one per processor */
+} DashboardExportOptions;
+
+void     dashboard_export_options_init(DashboardExportOptions *options);
+
+/* Writes frame-NNNNNN.png per instant and an index.csv mapping frames to
+ * capture timestamps. Stops at the first failure. */
+gboolean dashboard_export_run(const DashboardExportOptions *options,
+                              guint                        *n_frames,
+                              GError                      **error);
+
+G_END_DECLS
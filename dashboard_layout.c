@@ -0,0 +1,221 @@
+#include "dashboard_layout.h"
+#include <gio/gio.h>
+#include <math.h>
+
+struct _DashboardLayout {
+  grefcount ref_count;
+
+  GVariant                   *variant;
+  GVariant                   *gauge_array;  /* child 4, backs gauges */
+  GVariant                   *names;        /* child 5 */
+  const char                 *title;        /* points into variant */
+  guint                       columns;
+  const DashboardLayoutGauge *gauges;
+  guint                       n_gauges;
+  guint                       n_channels;
+};
+
+/* --- Loading --- */
+static gboolean
+invalid_layout(const char *reason, GError **error)
+{
+  g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+              "Not a usable dashboard layout: %s", reason);
+  return FALSE;
+}
+
+/* One pass over the fixed-size records, so nothing downstream has to
+ * second-guess a layout. Files given with --layout need not come from
+ * dashboard_layout_tool, so this repeats its checks of the gauges. */
+static gboolean
+check_gauges(DashboardLayout *self, GError **error)
+{
+  g_autofree guint8 *bound = g_new0(guint8, DASHBOARD_LAYOUT_MAX_CHANNELS / 8);  /* bit per channel */
+  guint64 last_cell = 0;
+
+  for (guint i = 0; i < self->n_gauges; i++) {
+    const DashboardLayoutGauge *gauge = &self->gauges[i];
+    const guint64 cell = (guint64)gauge->row * self->columns + gauge->column;
+
+    if (gauge->channel >= DASHBOARD_LAYOUT_MAX_CHANNELS)
+      return invalid_layout("channel out of range", error);
+    if (bound[gauge->channel / 8] & (1u << (gauge->channel % 8)))
+      return invalid_layout("channel bound to more than one gauge", error);
+    if (!isfinite(gauge->min) || !isfinite(gauge->max) || gauge->min >= gauge->max)
+      return invalid_layout("empty gauge range", error);
+    if (gauge->column >= self->columns)
+      return invalid_layout("gauge outside the columns", error);
+    if (cell >= DASHBOARD_LAYOUT_MAX_CELLS)
+      return invalid_layout("gauge beyond the last cell", error);
+    if (i > 0 && cell <= last_cell)
+      return invalid_layout("gauges out of position order", error);
+
+    bound[gauge->channel / 8] |= 1u << (gauge->channel % 8);
+    last_cell = cell;
+    self->n_channels = MAX(self->n_channels, gauge->channel + 1);
+  }
+
+  return TRUE;
+}
+
+static gboolean
+dashboard_layout_load(DashboardLayout *self, GError **error)
+{
+  guint32 magic, version;
+
+  g_variant_get_child(self->variant, 0, "u", &magic);
+
+  /* Compiled on a machine of the other byte order: the one slow path */
+  if (magic == GUINT32_SWAP_LE_BE(DASHBOARD_LAYOUT_MAGIC)) {
+    GVariant *swapped = g_variant_byteswap(self->variant);
+    g_variant_unref(self->variant);
+    self->variant = swapped;
+    magic = DASHBOARD_LAYOUT_MAGIC;
+  }
+
+  if (magic != DASHBOARD_LAYOUT_MAGIC)
+    return invalid_layout("bad magic", error);
+
+  g_variant_get_child(self->variant, 1, "u", &version);
+  if (version != DASHBOARD_LAYOUT_VERSION)
+    return invalid_layout("unsupported version", error);
+
+  g_variant_get_child(self->variant, 2, "&s", &self->title);
+  g_variant_get_child(self->variant, 3, "u", &self->columns);
+  if (self->columns == 0)
+    return invalid_layout("no columns", error);
+
+  gsize n_gauges = 0;
+  self->gauge_array = g_variant_get_child_value(self->variant, 4);
+  self->gauges = g_variant_get_fixed_array(self->gauge_array, &n_gauges, sizeof(DashboardLayoutGauge));
+  self->names = g_variant_get_child_value(self->variant, 5);
+
+  if (n_gauges > G_MAXUINT || g_variant_n_children(self->names) != n_gauges)
+    return invalid_layout("gauge and name tables differ", error);
+  self->n_gauges = (guint)n_gauges;
+
+  return check_gauges(self, error);
+}
+
+/* --- Public API --- */
+DashboardLayout *
+dashboard_layout_new_from_bytes(GBytes *bytes, gboolean trusted, GError **error)
+{
+  g_return_val_if_fail(bytes != NULL, NULL);
+
+  DashboardLayout *self = g_new0(DashboardLayout, 1);
+  g_ref_count_init(&self->ref_count);
+
+  self->variant = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE(DASHBOARD_LAYOUT_FORMAT),
+                                                              bytes, trusted));
+
+  if (!dashboard_layout_load(self, error)) {
+    dashboard_layout_unref(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+DashboardLayout *
+dashboard_layout_new_from_file(const char *path, GError **error)
+{
+  g_return_val_if_fail(path != NULL, NULL);
+
+  GMappedFile *map = g_mapped_file_new(path, FALSE, error);
+  if (map == NULL)
+    return NULL;
+
+  GBytes *bytes = g_mapped_file_get_bytes(map);
+  g_mapped_file_unref(map);  /* the bytes keep the mapping */
+
+  DashboardLayout *self = dashboard_layout_new_from_bytes(bytes, FALSE, error);
+  g_bytes_unref(bytes);
+
+  if (self == NULL)
+    g_prefix_error(error, "%s: ", path);
+  return self;
+}
+
+DashboardLayout *
+dashboard_layout_new_from_resource(const char *path, GError **error)
+{
+  g_return_val_if_fail(path != NULL, NULL);
+
+  GBytes *bytes = g_resources_lookup_data(path, G_RESOURCE_LOOKUP_FLAGS_NONE, error);
+  if (bytes == NULL)
+    return NULL;
+
+  DashboardLayout *self = dashboard_layout_new_from_bytes(bytes, TRUE, error);
+  g_bytes_unref(bytes);
+
+  return self;
+}
+
+DashboardLayout *
+dashboard_layout_ref(DashboardLayout *self)
+{
+  g_return_val_if_fail(self != NULL, NULL);
+
+  g_ref_count_inc(&self->ref_count);
+  return self;
+}
+
+void
+dashboard_layout_unref(DashboardLayout *self)
+{
+  g_return_if_fail(self != NULL);
+
+  if (!g_ref_count_dec(&self->ref_count))
+    return;
+
+  g_clear_pointer(&self->names, g_variant_unref);
+  g_clear_pointer(&self->gauge_array, g_variant_unref);
+  g_variant_unref(self->variant);
+  g_free(self);
+}
+
+const char *
+dashboard_layout_get_title(DashboardLayout *self)
+{
+  g_return_val_if_fail(self != NULL, NULL);
+  return self->title;
+}
+
+guint
+dashboard_layout_get_columns(DashboardLayout *self)
+{
+  g_return_val_if_fail(self != NULL, 0);
+  return self->columns;
+}
+
+guint
+dashboard_layout_get_n_channels(DashboardLayout *self)
+{
+  g_return_val_if_fail(self != NULL, 0);
+  return self->n_channels;
+}
+
+const DashboardLayoutGauge *
+dashboard_layout_get_gauges(DashboardLayout *self, guint *n_gauges)
+{
+  g_return_val_if_fail(self != NULL, NULL);
+  g_return_val_if_fail(n_gauges != NULL, NULL);
+
+  *n_gauges = self->n_gauges;
+  return self->gauges;
+}
+
+const char *
+dashboard_layout_get_name(DashboardLayout *self, guint index)
+{
+  const char *name;
+
+  g_return_val_if_fail(self != NULL, NULL);
+  g_return_val_if_fail(index < self->n_gauges, NULL);
+
+  /* Children of a serialized container share its data: the string
+   * outlives the temporary child */
+  g_variant_get_child(self->names, index, "&s", &name);
+  return name;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Compiled dashboard layout: which gauges a dashboard shows, where, and
+ * the channel and range of each. dashboard_layout_tool compiles the text
+ * source into one serialized GVariant of DASHBOARD_LAYOUT_FORMAT:
+ *
+ *   (magic, version, title, columns, gauges, names)
+ *
+ * The gauges are a fixed-size array in row-major position order that
+ * maps straight onto DashboardLayoutGauge, and names[i] belongs to
+ * gauges[i]. Loading maps the blob and reads it in place; nothing is
+ * parsed or copied. Blobs are in the compiler's byte order, which the
+ * magic gives away. */
+
+#define DASHBOARD_LAYOUT_MAGIC        0x4c445447u  /* "GTDL" little-endian */
+#define DASHBOARD_LAYOUT_VERSION      1
+#define DASHBOARD_LAYOUT_FORMAT       "(uusua(dduuuu)as)"
+#define DASHBOARD_LAYOUT_GAUGE_FORMAT "(dduuuu)"
+#define DASHBOARD_LAYOUT_MAX_CHANNELS (1u << 20)
+#define DASHBOARD_LAYOUT_MAX_CELLS    (1u << 21)  /* row * columns + column < this */
+
+typedef struct {
+  double  min;
+  double  max;
+  guint32 channel;         /* < DASHBOARD_LAYOUT_MAX_CHANNELS */
+  guint32 row;
+  guint32 column;          /* < columns; cells between gauges stay empty */
+  guint32 flags;           /* reserved, 0 */
+} DashboardLayoutGauge;
+
+/* Same size and alignment as the serialized DASHBOARD_LAYOUT_GAUGE_FORMAT */
+G_STATIC_ASSERT(sizeof(DashboardLayoutGauge) == 32);
+
+/* Immutable once loaded; safe to share between threads */
+typedef struct _DashboardLayout DashboardLayout;
+
+/* Only pass @trusted for blobs of our own build, such as resources:
+ * GVariant then skips its checks of the serialized form. The layout's
+ * values are checked either way. */
+DashboardLayout *dashboard_layout_new_from_bytes(GBytes *bytes, gboolean trusted, GError **error);
+
+/* Maps @path; the layout keeps the mapping */
+DashboardLayout *dashboard_layout_new_from_file(const char *path, GError **error);
+
+/* Bundled resources are read where glib-compile-resources put them */
+DashboardLayout *dashboard_layout_new_from_resource(const char *path, GError **error);
+
+DashboardLayout *dashboard_layout_ref(DashboardLayout *self);
+void             dashboard_layout_unref(DashboardLayout *self);
+
+const char  *dashboard_layout_get_title(DashboardLayout *self);
+guint        dashboard_layout_get_columns(DashboardLayout *self);
+
+/* One past the highest channel a gauge is bound to */
+guint        dashboard_layout_get_n_channels(DashboardLayout *self);
+
+/* Points into the layout, valid as long as it is */
+const DashboardLayoutGauge *dashboard_layout_get_gauges(DashboardLayout *self, guint *n_gauges);
+const char  *dashboard_layout_get_name(DashboardLayout *self, guint index);
+
+G_END_DECLS
@@ -0,0 +1,311 @@
+/* Build-time compiler of dashboard layouts (see dashboard_layout.h).
+ *
+ * Reads a text source and writes the GVariant blob the dashboard maps.
+ * One directive per line; blank lines and lines starting with # are
+ * ignored:
+ *
+ *   title TEXT
+ *   columns N                      cells per row, before the first gauge
+ *   at ROW COLUMN                  cell of the next gauge
+ *   gauge CHANNEL MIN MAX NAME     one gauge in the next cell
+ *   bank FIRST COUNT MIN MAX NAME  COUNT gauges on channels FIRST.. in
+ *                                  consecutive cells, named "NAME CHANNEL"
+ *
+ * Gauges fill cells row-major. Every mistake is reported as FILE:LINE
+ * and fails the build, so the dashboard never sees it. */
+
+#include <gio/gio.h>
+#include <math.h>
+#include <string.h>
+
+#include "dashboard_layout.h"
+
+static char *opt_output = NULL;
+
+static const GOptionEntry tool_options[] = {
+  { "output", 'o', 0, G_OPTION_ARG_FILENAME, &opt_output, "Compiled layout to write", "FILE" },
+  { NULL }
+};
+
+typedef struct {
+  const char *path;
+  guint       line;
+
+  char       *title;
+  guint       columns;
+  guint64     next_cell;    /* row * columns + column of the next gauge */
+  GArray     *gauges;       /* DashboardLayoutGauge */
+  GPtrArray  *names;
+  guint8     *bound;        /* bit per channel */
+} LayoutCompiler;
+
+static gboolean
+source_error(LayoutCompiler *lc, GError **error, const char *format, ...) G_GNUC_PRINTF(3, 4);
+
+static gboolean
+source_error(LayoutCompiler *lc, GError **error, const char *format, ...)
+{
+  va_list args;
+
+  va_start(args, format);
+  g_autofree char *message = g_strdup_vprintf(format, args);
+  va_end(args);
+
+  g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s:%u: %s", lc->path, lc->line, message);
+  return FALSE;
+}
+
+/* --- Fields --- */
+
+/* Next whitespace-separated field of *cursor, or NULL at the end */
+static char *
+next_field(char **cursor)
+{
+  char *p = *cursor;
+
+  while (g_ascii_isspace(*p))
+    p++;
+  if (*p == '\0')
+    return NULL;
+
+  char *field = p;
+  while (*p != '\0' && !g_ascii_isspace(*p))
+    p++;
+  if (*p != '\0')
+    *p++ = '\0';
+
+  *cursor = p;
+  return field;
+}
+
+static gboolean
+parse_uint(LayoutCompiler *lc, char **cursor, const char *what, guint max, guint *out, GError **error)
+{
+  const char *field = next_field(cursor);
+  guint64 value;
+
+  if (field == NULL)
+    return source_error(lc, error, "missing %s", what);
+  if (!g_ascii_string_to_unsigned(field, 10, 0, max, &value, NULL))
+    return source_error(lc, error, "%s must be a whole number up to %u, not %s", what, max, field);
+
+  *out = (guint)value;
+  return TRUE;
+}
+
+static gboolean
+parse_double(LayoutCompiler *lc, char **cursor, const char *what, double *out, GError **error)
+{
+  const char *field = next_field(cursor);
+  char *end = NULL;
+
+  if (field == NULL)
+    return source_error(lc, error, "missing %s", what);
+
+  *out = g_ascii_strtod(field, &end);
+  if (*end != '\0' || !isfinite(*out))
+    return source_error(lc, error, "%s must be a number, not %s", what, field);
+
+  return TRUE;
+}
+
+/* The rest of the line, without surrounding whitespace */
+static gboolean
+parse_text(LayoutCompiler *lc, char **cursor, const char *what, const char **out, GError **error)
+{
+  char *text = g_strstrip(*cursor);
+
+  if (*text == '\0')
+    return source_error(lc, error, "missing %s", what);
+
+  *out = text;
+  return TRUE;
+}
+
+/* --- Directives --- */
+static gboolean
+add_gauge(LayoutCompiler *lc, guint channel, double min, double max, const char *name, GError **error)
+{
+  if (lc->bound[channel / 8] & (1u << (channel % 8)))
+    return source_error(lc, error, "channel %u is already bound to a gauge", channel);
+  if (lc->next_cell >= DASHBOARD_LAYOUT_MAX_CELLS)
+    return source_error(lc, error, "layout larger than %u cells", DASHBOARD_LAYOUT_MAX_CELLS);
+
+  DashboardLayoutGauge gauge = {
+    .min     = min,
+    .max     = max,
+    .channel = channel,
+    .row     = (guint32)(lc->next_cell / lc->columns),
+    .column  = (guint32)(lc->next_cell % lc->columns),
+    .flags   = 0,
+  };
+
+  lc->bound[channel / 8] |= 1u << (channel % 8);
+  g_array_append_val(lc->gauges, gauge);
+  g_ptr_array_add(lc->names, g_strdup(name));
+  lc->next_cell++;
+
+  return TRUE;
+}
+
+static gboolean
+parse_range(LayoutCompiler *lc, char **cursor, double *min, double *max, GError **error)
+{
+  if (!parse_double(lc, cursor, "minimum", min, error) ||
+      !parse_double(lc, cursor, "maximum", max, error))
+    return FALSE;
+  if (*min >= *max)
+    return source_error(lc, error, "minimum %g is not below maximum %g", *min, *max);
+
+  return TRUE;
+}
+
+static gboolean
+compile_line(LayoutCompiler *lc, char *line, GError **error)
+{
+  char *cursor = line;
+  const char *directive = next_field(&cursor);
+  const char *text;
+  guint channel, count, row, column;
+  double min, max;
+
+  if (directive == NULL || directive[0] == '#')
+    return TRUE;
+
+  if (strcmp(directive, "title") == 0) {
+    if (!parse_text(lc, &cursor, "title", &text, error))
+      return FALSE;
+    g_free(lc->title);
+    lc->title = g_strdup(text);
+    return TRUE;
+  }
+
+  if (strcmp(directive, "columns") == 0) {
+    if (lc->gauges->len > 0)
+      return source_error(lc, error, "columns must come before the first gauge");
+    if (!parse_uint(lc, &cursor, "columns", 4096, &lc->columns, error))
+      return FALSE;
+    if (lc->columns == 0)
+      return source_error(lc, error, "columns must be positive");
+    return TRUE;
+  }
+
+  if (strcmp(directive, "at") == 0) {
+    if (!parse_uint(lc, &cursor, "row", G_MAXUINT32, &row, error) ||
+        !parse_uint(lc, &cursor, "column", lc->columns - 1, &column, error))
+      return FALSE;
+
+    const guint64 cell = (guint64)row * lc->columns + column;
+    if (cell < lc->next_cell)
+      return source_error(lc, error, "cell %u,%u is taken or behind the previous gauge", row, column);
+    lc->next_cell = cell;
+    return TRUE;
+  }
+
+  if (strcmp(directive, "gauge") == 0) {
+    if (!parse_uint(lc, &cursor, "channel", DASHBOARD_LAYOUT_MAX_CHANNELS - 1, &channel, error) ||
+        !parse_range(lc, &cursor, &min, &max, error) ||
+        !parse_text(lc, &cursor, "name", &text, error))
+      return FALSE;
+    return add_gauge(lc, channel, min, max, text, error);
+  }
+
+  if (strcmp(directive, "bank") == 0) {
+    if (!parse_uint(lc, &cursor, "first channel", DASHBOARD_LAYOUT_MAX_CHANNELS - 1, &channel, error) ||
+        !parse_uint(lc, &cursor, "count", DASHBOARD_LAYOUT_MAX_CHANNELS - channel, &count, error) ||
+        !parse_range(lc, &cursor, &min, &max, error) ||
+        !parse_text(lc, &cursor, "name", &text, error))
+      return FALSE;
+
+    for (guint i = 0; i < count; i++) {
+      g_autofree char *name = g_strdup_printf("%s %u", text, channel + i);
+
+      if (!add_gauge(lc, channel + i, min, max, name, error))
+        return FALSE;
+    }
+    return TRUE;
+  }
+
+  return source_error(lc, error, "unknown directive %s", directive);
+}
+
+/* --- Output --- */
+static gboolean
+write_layout(LayoutCompiler *lc, const char *output, GError **error)
+{
+  GVariant *gauges = g_variant_new_fixed_array(G_VARIANT_TYPE(DASHBOARD_LAYOUT_GAUGE_FORMAT),
+                                               lc->gauges->data, lc->gauges->len,
+                                               sizeof(DashboardLayoutGauge));
+  GVariant *names = g_variant_new_strv((const char * const *)lc->names->pdata, lc->names->len);
+  GVariant *layout = g_variant_ref_sink(g_variant_new("(uusu@a(dduuuu)@as)",
+                                                      DASHBOARD_LAYOUT_MAGIC, DASHBOARD_LAYOUT_VERSION,
+                                                      lc->title != NULL ? lc->title : "",
+                                                      lc->columns, gauges, names));
+
+  g_assert(g_variant_is_of_type(layout, G_VARIANT_TYPE(DASHBOARD_LAYOUT_FORMAT)));
+
+  gboolean ok = g_file_set_contents(output, g_variant_get_data(layout), g_variant_get_size(layout), error);
+  g_variant_unref(layout);
+
+  return ok;
+}
+
+/* --- Main --- */
+int
+main(int argc, char **argv)
+{
+  g_autoptr(GOptionContext) context = g_option_context_new("SOURCE - compile a dashboard layout");
+  g_autoptr(GError) error = NULL;
+
+  g_option_context_add_main_entries(context, tool_options, NULL);
+  if (!g_option_context_parse(context, &argc, &argv, &error)) {
+    g_printerr("%s\n", error->message);
+    return 2;
+  }
+  if (argc != 2 || opt_output == NULL) {
+    g_printerr("Usage: %s -o OUTPUT SOURCE\n", g_get_prgname());
+    return 2;
+  }
+
+  g_autofree char *contents = NULL;
+  if (!g_file_get_contents(argv[1], &contents, NULL, &error)) {
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+
+  LayoutCompiler lc = {
+    .path    = argv[1],
+    .columns = 1,
+    .gauges  = g_array_new(FALSE, FALSE, sizeof(DashboardLayoutGauge)),
+    .names   = g_ptr_array_new_with_free_func(g_free),
+    .bound   = g_new0(guint8, DASHBOARD_LAYOUT_MAX_CHANNELS / 8),
+  };
+
+  gboolean ok = TRUE;
+  char *line = contents;
+  while (ok && line != NULL) {
+    char *end = strchr(line, '\n');
+    if (end != NULL)
+      *end = '\0';
+
+    lc.line++;
+    ok = compile_line(&lc, line, &error);
+    line = end != NULL ? end + 1 : NULL;
+  }
+
+  if (ok && lc.gauges->len == 0)
+    ok = source_error(&lc, &error, "no gauges");
+  if (ok)
+    ok = write_layout(&lc, opt_output, &error);
+  if (ok)
+    g_printerr("%s: %u gauges in %u columns\n", opt_output, lc.gauges->len, lc.columns);
+  else
+    g_printerr("%s\n", error->message);
+
+  g_free(lc.title);
+  g_array_unref(lc.gauges);
+  g_ptr_array_unref(lc.names);
+  g_free(lc.bound);
+
+  return ok ? 0 : 1;
+}
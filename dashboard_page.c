@@ -1,15 +1,41 @@
 #include "dashboard_page.h"
 #include "page_signals.h"
+#include "page_telemetry.h"
 #include "gauge_widget.h"
+#include "trend_widget.h"
+#include "your_app.h"
+#include "perf_stats.h"
+#include "memory_budget.h"
+#include <math.h>
 
 struct _DashboardPage {
   GtkBox parent_instance;
 
   GtkButton     *refresh_button;
   GaugeWidget   *test_gauge;   /* reference to gauge */
+  TrendWidget   *test_trend;   /* history of the gauge's channel */
+  GtkLabel      *perf_hud;     /* performance overlay */
   guint          update_timer; /* timeout ID */
+  guint          hud_timer;    /* HUD refresh timeout ID */
+
+  gboolean         active;          /* between "activated" and "deactivated" */
+  PageTelemetry    live;            /* application's source, scheduler and alarms */
+  guint            telemetry_tick;  /* frame-clock tick callback ID */
+  GPtrArray       *channels;        /* channel → GaugeModel */
+  GPtrArray       *trends;          /* channel → TrendBuffer */
+  guint            trend_capacity;  /* samples each trend was created for */
+  gboolean         trends_dirty;    /* samples were appended this frame */
+
+  MemoryBudgetClient *budget;       /* trims our caches while hidden */
 };
 
+/* Trends show the last hour of live input, or two minutes of the 1 Hz
+ * demo data. Their buffers hold that at the input's rate, assuming 1 kHz
+ * when the source does not say. */
+#define TREND_SECONDS      3600
+#define TREND_DEMO_SECONDS 120
+#define TREND_DEFAULT_RATE 1000.0
+
 G_DEFINE_TYPE (DashboardPage, dashboard_page, GTK_TYPE_BOX)
 
 /* --- Helpers --- */
@@ -17,48 +43,257 @@ static gboolean
 update_gauge_cb(gpointer user_data)
 {
   DashboardPage *self = DASHBOARD_PAGE(user_data);
+  GaugeModel *model = g_ptr_array_index(self->channels, 0);
 
   /* Generate random value between min and max */
-  double min = 0.0, max = 100.0;
-  double value = g_random_double_range(min, max);
+  double value = g_random_double_range(gauge_model_get_min(model), gauge_model_get_max(model));
 
-  gauge_widget_set_value(self->test_gauge, value);
+  gauge_model_update(model, value, g_get_monotonic_time());
+  trend_buffer_append(g_ptr_array_index(self->trends, 0), (float)value);
+  gtk_widget_queue_draw(GTK_WIDGET(self->test_trend));
 
   return G_SOURCE_CONTINUE; /* keep repeating */
 }
 
-/* --- Page signals --- */
+/* --- Telemetry --- */
+
 static void
-on_page_activated(GObject *stack, GParamSpec *pspec, gpointer user_data)
+apply_sample(const TelemetrySample *sample, gpointer user_data)
 {
   DashboardPage *self = DASHBOARD_PAGE(user_data);
 
-  if (self->update_timer == 0) {
-    self->update_timer = g_timeout_add(1000, update_gauge_cb, self);
+  if (sample->channel >= self->channels->len)
+    return;
+
+  /* The model keeps only the newest value, the trend keeps every sample */
+  gauge_model_update(g_ptr_array_index(self->channels, sample->channel),
+                     sample->value, sample->timestamp);
+  trend_buffer_append(g_ptr_array_index(self->trends, sample->channel), (float)sample->value);
+  self->trends_dirty = TRUE;
+}
+
+/* Once per frame: drain the ring into the models, so each gauge only
+ * sees the newest value of its channel. The scheduler bounds how much
+ * of the frame that may take. */
+static gboolean
+drain_telemetry_cb(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+  DashboardPage *self = DASHBOARD_PAGE(widget);
+
+  page_telemetry_drain(&self->live, apply_sample, self);
+
+  if (self->trends_dirty) {
+    self->trends_dirty = FALSE;
+    gtk_widget_queue_draw(GTK_WIDGET(self->test_trend));
+  }
+
+  return G_SOURCE_CONTINUE;
+}
+
+/* Swap in empty trends of @capacity samples, unless they have that size */
+static void
+resize_trends(DashboardPage *self, guint capacity)
+{
+  if (capacity == self->trend_capacity)
+    return;
+
+  for (guint i = 0; i < self->trends->len; i++) {
+    trend_buffer_unref(g_ptr_array_index(self->trends, i));
+    self->trends->pdata[i] = trend_buffer_new(capacity);
   }
+  self->trend_capacity = capacity;
+
+  trend_widget_set_buffer(self->test_trend, g_ptr_array_index(self->trends, 0));
 }
 
+/* Live input can arrive at any rate: follow it instead of restarting,
+ * and show the whole history it builds up */
 static void
-on_page_deactivated(GObject *stack, GParamSpec *pspec, gpointer user_data)
+use_live_input(DashboardPage *self)
 {
-  DashboardPage *self = DASHBOARD_PAGE(user_data);
+  YourAppApplication *app = page_telemetry_lookup_application(GTK_WIDGET(self));
+  double rate = app != NULL ? your_app_application_get_sample_rate(app) : 0;
+
+  if (rate <= 0)
+    rate = TREND_DEFAULT_RATE;
+  resize_trends(self, (guint)ceil(TREND_SECONDS * rate));
+
+  gauge_widget_set_animation_mode(self->test_gauge, GAUGE_ANIMATION_FOLLOW);
+  trend_widget_set_window(self->test_trend, 0);
 
+  g_clear_handle_id(&self->update_timer, g_source_remove);
+}
+
+/* Live telemetry when the application has a source, demo data otherwise.
+ * The window only knows its application once it is shown, so this runs
+ * again on map. */
+static void
+start_updates(DashboardPage *self)
+{
+  if (!self->active)
+    return;
+
+  YourAppApplication *app = page_telemetry_lookup_application(GTK_WIDGET(self));
+
+  if (app != NULL)
+    page_telemetry_connect(&self->live, app);
+
+  if (self->live.source != NULL) {
+    use_live_input(self);
+    if (self->telemetry_tick == 0)
+      self->telemetry_tick = gtk_widget_add_tick_callback(GTK_WIDGET(self),
+                                                          drain_telemetry_cb, NULL, NULL);
+  } else if (self->update_timer == 0) {
+    /* Two minutes of the 1 Hz demo data, not an hour of it. Demo data
+     * waits for input and redraws instead of competing with them. */
+    resize_trends(self, TREND_DEMO_SECONDS);
+    trend_widget_set_window(self->test_trend, TREND_DEMO_SECONDS);
+    self->update_timer = g_timeout_add_full(G_PRIORITY_DEFAULT_IDLE, 1000, update_gauge_cb, self, NULL);
+  }
+}
+
+static void
+stop_updates(DashboardPage *self)
+{
   if (self->update_timer != 0) {
     g_source_remove(self->update_timer);
     self->update_timer = 0;
   }
+
+  if (self->telemetry_tick != 0) {
+    gtk_widget_remove_tick_callback(GTK_WIDGET(self), self->telemetry_tick);
+    self->telemetry_tick = 0;
+  }
+}
+
+/* --- Performance HUD --- */
+static gboolean
+update_hud_cb(gpointer user_data)
+{
+  DashboardPage *self = DASHBOARD_PAGE(user_data);
+  g_autofree char *text = perf_stats_format();
+
+  if (self->live.scheduler != NULL) {
+    UpdateSchedulerStats stats;
+    update_scheduler_get_stats(self->live.scheduler, &stats);
+
+    g_autofree char *perf = g_steal_pointer(&text);
+    text = g_strdup_printf("%s\n"
+                           "updates    %6" G_GUINT64_FORMAT "  %" G_GUINT64_FORMAT " coalesced  %"
+                           G_GUINT64_FORMAT " deferred  %u pending\n"
+                           "apply      %6.2f ms last  %6.2f max",
+                           perf, stats.applied, stats.coalesced, stats.deferred, stats.pending,
+                           stats.last_apply_us / 1000.0, stats.max_apply_us / 1000.0);
+  }
+
+  gtk_label_set_text(self->perf_hud, text);
+  return G_SOURCE_CONTINUE;
+}
+
+/* Refresh the HUD only while it is both shown and on screen */
+static void
+sync_hud_timer(DashboardPage *self)
+{
+  gboolean want = self->active && gtk_widget_get_visible(GTK_WIDGET(self->perf_hud));
+
+  if (want && self->hud_timer == 0) {
+    update_hud_cb(self);
+    self->hud_timer = g_timeout_add(500, update_hud_cb, self);
+  } else if (!want && self->hud_timer != 0) {
+    g_source_remove(self->hud_timer);
+    self->hud_timer = 0;
+  }
+}
+
+/* --- Memory budget --- */
+static gsize
+budget_size_cb(gpointer user_data)
+{
+  DashboardPage *self = DASHBOARD_PAGE(user_data);
+  gsize bytes = 0;
+
+  for (guint i = 0; i < self->trends->len; i++)
+    bytes += trend_buffer_get_bytes(g_ptr_array_index(self->trends, i));
+
+  return bytes;
+}
+
+/* Hidden: drop the gauge's rendering caches. Evicted: the trend history
+ * goes too, and the trends start over on the next sample. */
+static void
+budget_trim_cb(MemoryTrimLevel level, gpointer user_data)
+{
+  DashboardPage *self = DASHBOARD_PAGE(user_data);
+
+  gauge_widget_release_caches(self->test_gauge);
+
+  if (level == MEMORY_TRIM_EVICT) {
+    for (guint i = 0; i < self->trends->len; i++)
+      trend_buffer_release(g_ptr_array_index(self->trends, i));
+    gtk_widget_queue_draw(GTK_WIDGET(self->test_trend));
+  }
+}
+
+/* --- Page signals --- */
+static void
+on_page_activated(GObject *stack, GParamSpec *pspec, gpointer user_data)
+{
+  DashboardPage *self = DASHBOARD_PAGE(user_data);
+
+  self->active = TRUE;
+  memory_budget_set_active(self->budget, TRUE);
+  start_updates(self);
+  sync_hud_timer(self);
+}
+
+static void
+on_page_deactivated(GObject *stack, GParamSpec *pspec, gpointer user_data)
+{
+  DashboardPage *self = DASHBOARD_PAGE(user_data);
+
+  self->active = FALSE;
+  stop_updates(self);
+  sync_hud_timer(self);
+  memory_budget_set_active(self->budget, FALSE);
+}
+
+static void
+on_page_map(GtkWidget *widget, gpointer user_data)
+{
+  start_updates(DASHBOARD_PAGE(widget));
 }
 
 /* --- Class/init --- */
+static void
+dashboard_page_dispose (GObject *object)
+{
+  DashboardPage *self = DASHBOARD_PAGE (object);
+
+  stop_updates (self);
+  g_clear_handle_id (&self->hud_timer, g_source_remove);
+  page_telemetry_clear (&self->live);
+  g_clear_pointer (&self->budget, memory_budget_unregister);
+  g_clear_pointer (&self->channels, g_ptr_array_unref);
+  g_clear_pointer (&self->trends, g_ptr_array_unref);
+
+  G_OBJECT_CLASS (dashboard_page_parent_class)->dispose (object);
+}
+
 static void
 dashboard_page_class_init (DashboardPageClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->dispose = dashboard_page_dispose;
+
   gtk_widget_class_set_template_from_resource (widget_class,
       "/org/gnome/Example/dashboard_page.ui");
 
   gtk_widget_class_bind_template_child (widget_class, DashboardPage, refresh_button);
   gtk_widget_class_bind_template_child (widget_class, DashboardPage, test_gauge);
+  gtk_widget_class_bind_template_child (widget_class, DashboardPage, test_trend);
+  gtk_widget_class_bind_template_child (widget_class, DashboardPage, perf_hud);
 
   register_page_signals(G_TYPE_FROM_CLASS(klass));
 }
@@ -69,12 +304,68 @@ dashboard_page_init (DashboardPage *self)
   gtk_widget_init_template (GTK_WIDGET (self));
 
   self->update_timer = 0;
+  self->hud_timer = 0;
+  self->active = FALSE;
+  self->telemetry_tick = 0;
+
+  /* Channel 0 drives the test gauge, starting from its template value */
+  double min, max;
+  gauge_widget_get_range (self->test_gauge, &min, &max);
+
+  GaugeModel *model = gauge_model_new (0, "Channel 0", min, max);
+  gauge_model_update (model, gauge_widget_get_value (self->test_gauge), 0);
+
+  self->channels = g_ptr_array_new_with_free_func (g_object_unref);
+  g_ptr_array_add (self->channels, model);
+  gauge_widget_set_model (self->test_gauge, model);
+  page_telemetry_init (&self->live, self->channels);
+
+  self->trends = g_ptr_array_new_with_free_func ((GDestroyNotify) trend_buffer_unref);
+  g_ptr_array_add (self->trends, trend_buffer_new (TREND_DEMO_SECONDS));
+  self->trend_capacity = TREND_DEMO_SECONDS;
+  trend_widget_set_buffer (self->test_trend, g_ptr_array_index (self->trends, 0));
+  trend_widget_set_range (self->test_trend, min, max);
+  self->trends_dirty = FALSE;
+
+  self->budget = memory_budget_register ("dashboard", budget_size_cb, budget_trim_cb, self);
 
   g_signal_connect (self, "activated",   G_CALLBACK (on_page_activated),   self);
   g_signal_connect (self, "deactivated", G_CALLBACK (on_page_deactivated), self);
+  g_signal_connect (self, "map",         G_CALLBACK (on_page_map),         NULL);
 
   /* Example: connect signal to refresh_button */
   g_signal_connect (self->refresh_button, "clicked",
                     G_CALLBACK (gtk_widget_queue_draw), self);
 }
 
+/* --- Public API --- */
+void
+dashboard_page_set_hud_visible (DashboardPage *self, gboolean visible)
+{
+  g_return_if_fail (DASHBOARD_IS_PAGE (self));
+
+  gtk_widget_set_visible (GTK_WIDGET (self->perf_hud), visible);
+  sync_hud_timer (self);
+}
+
+void
+dashboard_page_apply_samples (DashboardPage         *self,
+                              const TelemetrySample *samples,
+                              guint                  n_samples)
+{
+  g_return_if_fail (DASHBOARD_IS_PAGE (self));
+  g_return_if_fail (samples != NULL || n_samples == 0);
+
+  use_live_input (self);
+
+  gauge_model_begin_batch ();
+  for (guint i = 0; i < n_samples; i++)
+    apply_sample (&samples[i], self);
+  gauge_model_end_batch ();
+
+  if (self->trends_dirty)
+  {
+    self->trends_dirty = FALSE;
+    gtk_widget_queue_draw (GTK_WIDGET (self->test_trend));
+  }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <adwaita.h>
+#include "telemetry_source.h"
 
 G_BEGIN_DECLS
 
@@ -8,4 +9,12 @@ G_BEGIN_DECLS
 
 G_DECLARE_FINAL_TYPE (DashboardPage, dashboard_page, DASHBOARD, PAGE, GtkBox)
 
+void dashboard_page_set_hud_visible (DashboardPage *self, gboolean visible);
+
+/* Feed samples as live telemetry would, in one model batch. For drivers
+ * without a TelemetrySource of the application, such as export. */
+void dashboard_page_apply_samples (DashboardPage         *self,
+                                   const TelemetrySample *samples,
+                                   guint                  n_samples);
+
 G_END_DECLS
@@ -0,0 +1,219 @@
+#include "dial_cache.h"
+
+#define DIAL_CACHE_DEFAULT_MAX_BYTES (32 * 1024 * 1024)
+
+struct _DialCacheEntry {
+  DialCacheKey key;
+  GdkTexture  *texture;
+  gsize        bytes;
+  guint        users;
+  GList       *unused_link;  /* position in the LRU queue while unused */
+};
+
+/* Process-wide state; GTK objects are main-thread only, and so is this */
+static GHashTable *entries     = NULL;  /* DialCacheKey* → DialCacheEntry* */
+static GQueue      unused      = G_QUEUE_INIT; /* head = least recently used */
+static gsize       total_bytes = 0;
+static gsize       max_bytes   = DIAL_CACHE_DEFAULT_MAX_BYTES;
+static guint64     n_hits      = 0;
+static guint64     n_misses    = 0;
+static guint64     n_evictions = 0;
+
+/* --- Key helpers --- */
+
+/* -0.0 == 0.0, so both must hash alike */
+static guint
+double_hash(double v)
+{
+  const double normalized = v == 0.0 ? 0.0 : v;
+  return g_double_hash(&normalized);
+}
+
+static guint
+dial_cache_key_hash(gconstpointer data)
+{
+  const DialCacheKey *key = data;
+  guint h = (guint)key->width;
+
+  h = h * 31 + (guint)key->height;
+  h = h * 31 + (guint)key->scale;
+  h = h * 31 + double_hash(key->min);
+  h = h * 31 + double_hash(key->max);
+  h = h * 31 + key->quality;
+  h = h * 31 + key->style;
+
+  return h;
+}
+
+gboolean
+dial_cache_key_equal(const DialCacheKey *a, const DialCacheKey *b)
+{
+  return a->width  == b->width  &&
+         a->height == b->height &&
+         a->scale  == b->scale  &&
+         a->min    == b->min    &&
+         a->max    == b->max    &&
+         a->quality == b->quality &&
+         a->style  == b->style;
+}
+
+static gboolean
+dial_cache_key_equal_func(gconstpointer a, gconstpointer b)
+{
+  return dial_cache_key_equal(a, b);
+}
+
+/* Wrap a finished image surface as a texture without copying the pixels */
+static GdkTexture *
+texture_from_surface(cairo_surface_t *surface)
+{
+  cairo_surface_flush(surface);
+
+  const int w = cairo_image_surface_get_width(surface);
+  const int h = cairo_image_surface_get_height(surface);
+  const gsize stride = cairo_image_surface_get_stride(surface);
+
+  GBytes *bytes = g_bytes_new_with_free_func(cairo_image_surface_get_data(surface),
+                                             stride * h,
+                                             (GDestroyNotify) cairo_surface_destroy,
+                                             cairo_surface_reference(surface));
+  GdkTexture *texture = gdk_memory_texture_new(w, h, GDK_MEMORY_DEFAULT, bytes, stride);
+  g_bytes_unref(bytes);
+
+  return texture;
+}
+
+/* --- Eviction --- */
+static void
+dial_cache_entry_free(DialCacheEntry *entry)
+{
+  g_clear_object(&entry->texture);
+  g_free(entry);
+}
+
+static void
+evict_until(gsize target_bytes)
+{
+  while (total_bytes > target_bytes && !g_queue_is_empty(&unused)) {
+    DialCacheEntry *entry = g_queue_pop_head(&unused);
+
+    entry->unused_link = NULL;
+    total_bytes -= entry->bytes;
+    n_evictions++;
+
+    /* Removing from the table frees the entry */
+    g_hash_table_remove(entries, &entry->key);
+  }
+}
+
+/* --- Public API --- */
+DialCacheEntry *
+dial_cache_acquire(const DialCacheKey *key, DialCacheDrawFunc draw, gpointer user_data)
+{
+  g_return_val_if_fail(key != NULL, NULL);
+  g_return_val_if_fail(draw != NULL, NULL);
+
+  if (key->width <= 0 || key->height <= 0 || key->scale <= 0)
+    return NULL;
+
+  if (entries == NULL)
+    entries = g_hash_table_new_full(dial_cache_key_hash, dial_cache_key_equal_func,
+                                    NULL, (GDestroyNotify) dial_cache_entry_free);
+
+  DialCacheEntry *entry = g_hash_table_lookup(entries, key);
+  if (entry) {
+    n_hits++;
+    if (entry->unused_link) {
+      g_queue_delete_link(&unused, entry->unused_link);
+      entry->unused_link = NULL;
+    }
+    entry->users++;
+    return entry;
+  }
+
+  n_misses++;
+
+  const int pw = key->width * key->scale;
+  const int ph = key->height * key->scale;
+
+  cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, pw, ph);
+  cairo_surface_set_device_scale(surface, key->scale, key->scale);
+  cairo_t *cr = cairo_create(surface);
+  draw(cr, key, user_data);
+  cairo_destroy(cr);
+
+  entry = g_new0(DialCacheEntry, 1);
+  entry->key     = *key;
+  entry->texture = texture_from_surface(surface);
+  entry->bytes   = (gsize)cairo_image_surface_get_stride(surface) * ph;
+  entry->users   = 1;
+  cairo_surface_destroy(surface);
+
+  g_hash_table_insert(entries, &entry->key, entry);
+  total_bytes += entry->bytes;
+
+  /* Make room by dropping dials nobody shows any more */
+  evict_until(max_bytes);
+
+  return entry;
+}
+
+void
+dial_cache_release(DialCacheEntry *entry)
+{
+  g_return_if_fail(entry != NULL);
+  g_return_if_fail(entry->users > 0);
+
+  if (--entry->users > 0)
+    return;
+
+  g_queue_push_tail(&unused, entry);
+  entry->unused_link = g_queue_peek_tail_link(&unused);
+
+  evict_until(max_bytes);
+}
+
+GdkTexture *
+dial_cache_entry_get_texture(DialCacheEntry *entry)
+{
+  return entry->texture;
+}
+
+const DialCacheKey *
+dial_cache_entry_get_key(DialCacheEntry *entry)
+{
+  return &entry->key;
+}
+
+void
+dial_cache_set_max_bytes(gsize bytes)
+{
+  max_bytes = bytes;
+  evict_until(max_bytes);
+}
+
+gsize
+dial_cache_get_max_bytes(void)
+{
+  return max_bytes;
+}
+
+void
+dial_cache_trim(gsize target_bytes)
+{
+  evict_until(target_bytes);
+}
+
+void
+dial_cache_get_stats(DialCacheStats *stats)
+{
+  g_return_if_fail(stats != NULL);
+
+  stats->hits      = n_hits;
+  stats->misses    = n_misses;
+  stats->evictions = n_evictions;
+  stats->bytes     = total_bytes;
+  stats->max_bytes = max_bytes;
+  stats->entries   = entries ? g_hash_table_size(entries) : 0;
+  stats->in_use    = stats->entries - g_queue_get_length(&unused);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* Everything that makes two dials look different. Gauges with equal keys
+ * share one rasterized texture. */
+typedef struct {
+  int    width;    /* logical size */
+  int    height;
+  int    scale;    /* device scale factor */
+  double min;
+  double max;
+  guint  quality;  /* GaugeDetail the dial is drawn at */
+  guint  style;    /* id of the resolved CSS colours and stroke widths,
+                   * one per distinct style */
+} DialCacheKey;
+
+typedef struct {
+  guint64 hits;
+  guint64 misses;
+  guint64 evictions;
+  gsize   bytes;      /* pixel memory currently held */
+  gsize   max_bytes;  /* eviction cap for unused entries */
+  guint   entries;
+  guint   in_use;     /* entries with at least one user */
+} DialCacheStats;
+
+typedef struct _DialCacheEntry DialCacheEntry;
+
+/* Draws a dial for @key into @cr, in logical coordinates */
+typedef void (*DialCacheDrawFunc)(cairo_t *cr, const DialCacheKey *key, gpointer user_data);
+
+/* Returns a referenced entry for @key, rasterizing it with @draw on a miss */
+DialCacheEntry *dial_cache_acquire(const DialCacheKey *key,
+                                   DialCacheDrawFunc   draw,
+                                   gpointer            user_data);
+void            dial_cache_release(DialCacheEntry *entry);
+
+GdkTexture         *dial_cache_entry_get_texture(DialCacheEntry *entry);
+const DialCacheKey *dial_cache_entry_get_key(DialCacheEntry *entry);
+
+gboolean dial_cache_key_equal(const DialCacheKey *a, const DialCacheKey *b);
+
+/* Unused entries are evicted least-recently-used first once the cache
+ * holds more than @max_bytes. Entries in use are never evicted. */
+void  dial_cache_set_max_bytes(gsize max_bytes);
+gsize dial_cache_get_max_bytes(void);
+
+/* Evict unused entries until at most @target_bytes are held */
+void  dial_cache_trim(gsize target_bytes);
+
+void  dial_cache_get_stats(DialCacheStats *stats);
+
+G_END_DECLS
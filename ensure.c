@@ -1,9 +1,12 @@
 #include "ensure.h"
 
+/* Types the window template names. Pages behind a LazyPage register
+ * themselves when first built. */
 void
 ensure_types(void)
 {
   g_type_ensure(GAUGE_TYPE_WIDGET);
+  g_type_ensure(TREND_TYPE_WIDGET);
   g_type_ensure (DASHBOARD_TYPE_PAGE);
-  g_type_ensure (PREFERENCES_TYPE_PAGE);
+  g_type_ensure (LAZY_TYPE_PAGE);
 }
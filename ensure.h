@@ -1,7 +1,8 @@
 #pragma once
 
 #include "gauge_widget.h"
+#include "trend_widget.h"
 #include "dashboard_page.h"
-#include "preferences_page.h"
+#include "lazy_page.h"
 
 extern void ensure_types(void);
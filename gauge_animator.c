@@ -0,0 +1,301 @@
+#include "gauge_animator.h"
+#include "perf_stats.h"
+#include <math.h>
+
+typedef struct {
+  GaugeWidget       *gauge;
+  GaugeAnimationMode mode;
+  double             from;
+  double             to;
+  double             epsilon;     /* settle distance */
+  /* GAUGE_ANIMATION_EASE */
+  gint64             start_time;  /* µs, frame-clock time base */
+  gint64             duration;    /* µs */
+  /* GAUGE_ANIMATION_FOLLOW */
+  double             value;       /* current position */
+  double             velocity;    /* units per second */
+  double             omega;       /* spring angular frequency, 1/s */
+  gint64             last_time;   /* µs of the last step */
+} GaugeAnimation;
+
+struct _GaugeAnimator {
+  GdkFrameClock *frame_clock;  /* owns us */
+  GArray        *anims;        /* GaugeAnimation, unordered */
+  gint64         time;         /* frame time of the last advance */
+  gboolean       updating;     /* inside begin/end_updating */
+  guint          batch_depth;  /* clock sync deferred while > 0 */
+};
+
+#define GAUGE_ANIMATOR_KEY "gauge-animator"
+
+/* --- Helpers --- */
+static void
+gauge_animator_sync_clock(GaugeAnimator *self)
+{
+  if (self->batch_depth > 0)
+    return;
+
+  if (self->anims->len > 0 && !self->updating) {
+    gdk_frame_clock_begin_updating(self->frame_clock);
+    self->updating = TRUE;
+  } else if (self->anims->len == 0 && self->updating) {
+    gdk_frame_clock_end_updating(self->frame_clock);
+    self->updating = FALSE;
+  }
+}
+
+/* Swap-remove slot @i, keeping the moved gauge's slot index current */
+static void
+gauge_animator_remove_slot(GaugeAnimator *self, guint i)
+{
+  GaugeAnimation *anims = (GaugeAnimation *)self->anims->data;
+  guint last = self->anims->len - 1;
+
+  gauge_widget_animator_set_slot(anims[i].gauge, GAUGE_ANIMATOR_NO_SLOT);
+  perf_stats_animation_stopped();
+
+  if (i != last) {
+    anims[i] = anims[last];
+    gauge_widget_animator_set_slot(anims[i].gauge, i);
+  }
+  g_array_set_size(self->anims, last);
+}
+
+static void
+gauge_animator_on_update(GdkFrameClock *frame_clock, gpointer user_data)
+{
+  GaugeAnimator *self = user_data;
+
+  gauge_animator_advance(self, gdk_frame_clock_get_frame_time(frame_clock));
+}
+
+static void
+gauge_animator_free(gpointer data)
+{
+  GaugeAnimator *self = data;
+  GaugeAnimation *anims = (GaugeAnimation *)self->anims->data;
+
+  /* The clock is going away: anything still animating just stops */
+  for (guint i = 0; i < self->anims->len; i++) {
+    gauge_widget_animator_set_slot(anims[i].gauge, GAUGE_ANIMATOR_NO_SLOT);
+    perf_stats_animation_stopped();
+  }
+
+  g_array_unref(self->anims);
+  g_free(self);
+}
+
+/* --- Public API --- */
+GaugeAnimator *
+gauge_animator_get_for_clock(GdkFrameClock *frame_clock)
+{
+  g_return_val_if_fail(GDK_IS_FRAME_CLOCK(frame_clock), NULL);
+
+  GaugeAnimator *self = g_object_get_data(G_OBJECT(frame_clock), GAUGE_ANIMATOR_KEY);
+  if (self)
+    return self;
+
+  self = g_new0(GaugeAnimator, 1);
+  self->frame_clock = frame_clock;
+  self->anims = g_array_new(FALSE, FALSE, sizeof(GaugeAnimation));
+  g_signal_connect(frame_clock, "update", G_CALLBACK(gauge_animator_on_update), self);
+
+  g_object_set_data_full(G_OBJECT(frame_clock), GAUGE_ANIMATOR_KEY, self, gauge_animator_free);
+  return self;
+}
+
+gint64
+gauge_animator_get_time(GaugeAnimator *self)
+{
+  /* A driver that advances us by hand may run ahead of an idle clock */
+  return MAX(gdk_frame_clock_get_frame_time(self->frame_clock), self->time);
+}
+
+/* Our slot for @gauge, appending a fresh one if it has none */
+static GaugeAnimation *
+gauge_animator_lookup(GaugeAnimator *self, GaugeWidget *gauge, gboolean *is_new)
+{
+  guint slot = gauge_widget_animator_get_slot(gauge);
+
+  *is_new = slot == GAUGE_ANIMATOR_NO_SLOT;
+  if (*is_new) {
+    GaugeAnimation anim = { .gauge = gauge };
+
+    slot = self->anims->len;
+    g_array_append_val(self->anims, anim);
+    gauge_widget_animator_set_slot(gauge, slot);
+    perf_stats_animation_started();
+  }
+
+  return &g_array_index(self->anims, GaugeAnimation, slot);
+}
+
+void
+gauge_animator_ease(GaugeAnimator *self,
+                    GaugeWidget   *gauge,
+                    double         from,
+                    double         to,
+                    gint64         duration,
+                    double         epsilon)
+{
+  gboolean is_new;
+  GaugeAnimation *anim = gauge_animator_lookup(self, gauge, &is_new);
+
+  anim->mode       = GAUGE_ANIMATION_EASE;
+  anim->from       = from;
+  anim->to         = to;
+  anim->start_time = gauge_animator_get_time(self);
+  anim->duration   = duration;
+  anim->epsilon    = epsilon;
+
+  gauge_animator_sync_clock(self);
+}
+
+void
+gauge_animator_follow(GaugeAnimator *self,
+                      GaugeWidget   *gauge,
+                      double         from,
+                      double         to,
+                      double         omega,
+                      double         epsilon)
+{
+  gboolean is_new;
+  GaugeAnimation *anim = gauge_animator_lookup(self, gauge, &is_new);
+
+  /* Joining, or switching over from an ease: start at rest where we are */
+  if (is_new || anim->mode != GAUGE_ANIMATION_FOLLOW) {
+    anim->mode      = GAUGE_ANIMATION_FOLLOW;
+    anim->from      = from;
+    anim->value     = from;
+    anim->velocity  = 0.0;
+    anim->last_time = gauge_animator_get_time(self);
+  }
+
+  anim->to      = to;
+  anim->omega   = omega;
+  anim->epsilon = epsilon;
+
+  gauge_animator_sync_clock(self);
+}
+
+void
+gauge_animator_cancel(GaugeAnimator *self, GaugeWidget *gauge)
+{
+  guint slot = gauge_widget_animator_get_slot(gauge);
+
+  if (slot == GAUGE_ANIMATOR_NO_SLOT)
+    return;
+
+  gauge_animator_remove_slot(self, slot);
+  gauge_animator_sync_clock(self);
+}
+
+static gboolean
+ease_step(GaugeAnimation *anim, gint64 frame_time, double *value)
+{
+  double t = anim->duration > 0
+           ? (double)(frame_time - anim->start_time) / (double)anim->duration
+           : 1.0;
+
+  if (t >= 1.0) {
+    *value = anim->to;
+    return TRUE;
+  }
+
+  if (t <= 0.0) {
+    *value = anim->from;
+  } else {
+    /* Ease-out cubic */
+    double r = 1.0 - t;
+    *value = anim->from + (anim->to - anim->from) * (1.0 - r * r * r);
+  }
+
+  /* The long tail moves less than a device pixel: end it now */
+  if (fabs(anim->to - *value) <= anim->epsilon) {
+    *value = anim->to;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/* Exact step of a critically damped spring, so any frame interval is
+ * stable: with e = x - target,
+ *   e(t) = (e0 + (v0 + ω·e0)·t)·exp(-ω·t)
+ *   v(t) = (v0 - ω·(v0 + ω·e0)·t)·exp(-ω·t) */
+static gboolean
+follow_step(GaugeAnimation *anim, gint64 frame_time, double *value)
+{
+  double dt = (double)(frame_time - anim->last_time) / G_USEC_PER_SEC;
+
+  if (dt > 0.0) {
+    const double w  = anim->omega;
+    const double e0 = anim->value - anim->to;
+    const double k  = anim->velocity + w * e0;
+    const double decay = exp(-w * dt);
+
+    anim->value     = anim->to + (e0 + k * dt) * decay;
+    anim->velocity  = (anim->velocity - w * k * dt) * decay;
+    anim->last_time = frame_time;
+  }
+
+  if (fabs(anim->value - anim->to) <= anim->epsilon &&
+      fabs(anim->velocity) * 0.1 <= anim->epsilon) {
+    *value = anim->to;
+    return TRUE;
+  }
+
+  *value = anim->value;
+  return FALSE;
+}
+
+guint
+gauge_animator_advance(GaugeAnimator *self, gint64 frame_time)
+{
+  guint invalidated = 0;
+  guint i = 0;
+
+  self->time = frame_time;
+
+  while (i < self->anims->len) {
+    GaugeAnimation *anim = &g_array_index(self->anims, GaugeAnimation, i);
+    gboolean finished;
+    double value;
+
+    if (anim->mode == GAUGE_ANIMATION_FOLLOW)
+      finished = follow_step(anim, frame_time, &value);
+    else
+      finished = ease_step(anim, frame_time, &value);
+
+    if (gauge_widget_animator_update(anim->gauge, value, finished))
+      invalidated++;
+
+    if (finished)
+      gauge_animator_remove_slot(self, i);  /* slot i now holds the last entry */
+    else
+      i++;
+  }
+
+  gauge_animator_sync_clock(self);
+  return invalidated;
+}
+
+void
+gauge_animator_begin_batch(GaugeAnimator *self)
+{
+  self->batch_depth++;
+}
+
+void
+gauge_animator_end_batch(GaugeAnimator *self)
+{
+  g_return_if_fail(self->batch_depth > 0);
+
+  if (--self->batch_depth == 0)
+    gauge_animator_sync_clock(self);
+}
+
+guint
+gauge_animator_get_n_active(GaugeAnimator *self)
+{
+  return self->anims->len;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <gtk/gtk.h>
+#include "gauge_widget.h"
+
+G_BEGIN_DECLS
+
+/* Runs every needle animation on one frame clock in a single pass over a
+ * flat array, instead of one tick callback per gauge. Gauges join when an
+ * animation starts and leave when it settles. */
+typedef struct _GaugeAnimator GaugeAnimator;
+
+#define GAUGE_ANIMATOR_NO_SLOT G_MAXUINT
+
+/* The animator shared by all gauges on @frame_clock; owned by the clock */
+GaugeAnimator *gauge_animator_get_for_clock(GdkFrameClock *frame_clock);
+
+/* Current time on the clock's time base, in µs */
+gint64 gauge_animator_get_time(GaugeAnimator *self);
+
+/* (Re)start an ease-out curve from @from to @to, beginning now. The
+ * curve is cut short once within @epsilon of @to. */
+void   gauge_animator_ease(GaugeAnimator *self,
+                           GaugeWidget   *gauge,
+                           double         from,
+                           double         to,
+                           gint64         duration,
+                           double         epsilon);
+
+/* Track @to with a critically damped spring of angular frequency @omega
+ * (1/s). Retargeting keeps position and velocity, so it is O(1) and never
+ * restarts the motion. Settles once within @epsilon of @to. */
+void   gauge_animator_follow(GaugeAnimator *self,
+                             GaugeWidget   *gauge,
+                             double         from,
+                             double         to,
+                             double         omega,
+                             double         epsilon);
+void   gauge_animator_cancel(GaugeAnimator *self, GaugeWidget *gauge);
+
+/* Advances all animations to @frame_time. Called from the clock's
+ * "update" phase, or directly by offscreen drivers whose clock never
+ * ticks. Returns how many gauges were invalidated. */
+guint  gauge_animator_advance(GaugeAnimator *self, gint64 frame_time);
+
+/* Between begin and end, ease/follow/cancel only edit the array; the
+ * frame clock is started or stopped once, at the outermost end. */
+void   gauge_animator_begin_batch(GaugeAnimator *self);
+void   gauge_animator_end_batch(GaugeAnimator *self);
+
+guint  gauge_animator_get_n_active(GaugeAnimator *self);
+
+/* GaugeWidget side of the protocol, implemented in gauge_widget.c.
+ * update() returns whether the gauge queued a redraw. */
+guint    gauge_widget_animator_get_slot(GaugeWidget *self);
+void     gauge_widget_animator_set_slot(GaugeWidget *self, guint slot);
+gboolean gauge_widget_animator_update(GaugeWidget *self, double value, gboolean finished);
+
+G_END_DECLS
@@ -0,0 +1,706 @@
+/* Headless rendering benchmark for GaugeWidget, DashboardPage and
+ * GaugeGridPage.
+ *
+ * Drives gauges with a synthetic value stream on a simulated frame clock,
+ * snapshots and renders every frame through the cairo GskRenderer, and
+ * prints one JSON object with the results.
+ *
+ * --verify-trend instead checks trend decimation against a plain scan of
+ * every sample; it needs no display and exits non-zero on a mismatch.
+ *
+ * --overload feeds the grid page in real time at a multiple of the
+ * nominal rate, through a TelemetryStream and the update scheduler as
+ * the app does, while another thread posts input events. It reports tick
+ * and input latency percentiles and exits non-zero if the page stopped
+ * being responsive or the stream dropped samples. */
+
+#include <adwaita.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "ensure.h"
+#include "dial_cache.h"
+#include "gauge_animator.h"
+#include "gauge_grid_page.h"
+#include "gauge_group.h"
+#include "gauge_model.h"
+#include "offscreen_render.h"
+#include "quality_governor.h"
+#include "telemetry_stream.h"
+#include "trend_buffer.h"
+#include "update_scheduler.h"
+
+static int      opt_gauges    = 100;
+static double   opt_rate      = 10.0;   /* value changes per gauge per second */
+static double   opt_seconds   = 10.0;   /* simulated time; wall-clock with --overload */
+static double   opt_fps       = 60.0;
+static char    *opt_mode      = NULL;   /* "ease" or "follow" */
+static char    *opt_quality   = NULL;   /* GaugeDetail nick, not "auto" */
+static gboolean opt_dashboard = FALSE;
+static gboolean opt_grid_page = FALSE;
+static gboolean opt_group     = FALSE;
+static double   opt_scroll    = 0.0;    /* px per second, grid page only */
+static int      opt_width     = 0;
+static int      opt_height    = 0;
+static int      opt_seed      = 1;
+static gboolean opt_verify_trend = FALSE;
+static double   opt_overload  = 0.0;    /* multiple of --rate; 0: simulated run */
+static gboolean opt_unscheduled = FALSE;
+
+static const GOptionEntry bench_options[] = {
+  { "gauges",    'n', 0, G_OPTION_ARG_INT,    &opt_gauges,    "Number of gauges in the grid", "N" },
+  { "rate",      'r', 0, G_OPTION_ARG_DOUBLE, &opt_rate,      "Value changes per gauge per second", "HZ" },
+  { "seconds",   's', 0, G_OPTION_ARG_DOUBLE, &opt_seconds,   "Simulated duration (wall-clock with --overload)", "SECONDS" },
+  { "fps",       0,   0, G_OPTION_ARG_DOUBLE, &opt_fps,       "Simulated frame rate", "FPS" },
+  { "mode",      'm', 0, G_OPTION_ARG_STRING, &opt_mode,      "Animation mode: ease or follow", "MODE" },
+  { "quality",   'q', 0, G_OPTION_ARG_STRING, &opt_quality,   "Render quality: full, reduced, flat, basic or minimal", "LEVEL" },
+  { "dashboard", 'd', 0, G_OPTION_ARG_NONE,   &opt_dashboard, "Render a full DashboardPage instead of a gauge grid", NULL },
+  { "grid-page", 'g', 0, G_OPTION_ARG_NONE,   &opt_grid_page, "Render a GaugeGridPage with --gauges channels", NULL },
+  { "group",     0,   0, G_OPTION_ARG_NONE,   &opt_group,     "Set values through one GaugeGroup instead of per gauge", NULL },
+  { "scroll",    0,   0, G_OPTION_ARG_DOUBLE, &opt_scroll,    "Scroll the grid page at this speed", "PX_PER_S" },
+  { "width",     0,   0, G_OPTION_ARG_INT,    &opt_width,     "Viewport width (default: natural)", "PX" },
+  { "height",    0,   0, G_OPTION_ARG_INT,    &opt_height,    "Viewport height (default: natural)", "PX" },
+  { "seed",      0,   0, G_OPTION_ARG_INT,    &opt_seed,      "Random seed of the value stream", "SEED" },
+  { "verify-trend", 0, 0, G_OPTION_ARG_NONE,   &opt_verify_trend, "Check trend decimation against a plain scan instead", NULL },
+  { "overload",  0,   0, G_OPTION_ARG_DOUBLE, &opt_overload,  "Feed the grid page FACTOR times --rate in real time and check it stays responsive", "FACTOR" },
+  { "unscheduled", 0, 0, G_OPTION_ARG_NONE,   &opt_unscheduled, "With --overload, apply every sample without the update scheduler", NULL },
+  { NULL }
+};
+
+/* --- Helpers --- */
+static GtkWidget *
+build_gauge_grid(int n)
+{
+  GtkWidget *grid = gtk_grid_new();
+  const int columns = MAX(1, (int)ceil(sqrt(n)));
+
+  for (int i = 0; i < n; i++)
+    gtk_grid_attach(GTK_GRID(grid), gauge_widget_new(), i % columns, i / columns, 1, 1);
+
+  return grid;
+}
+
+static void
+collect_gauges(GtkWidget *widget, GPtrArray *gauges)
+{
+  if (GAUGE_IS_WIDGET(widget))
+    g_ptr_array_add(gauges, widget);
+
+  for (GtkWidget *child = gtk_widget_get_first_child(widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling(child))
+    collect_gauges(child, gauges);
+}
+
+static GtkScrolledWindow *
+find_scrolled_window(GtkWidget *widget)
+{
+  if (GTK_IS_SCROLLED_WINDOW(widget))
+    return GTK_SCROLLED_WINDOW(widget);
+
+  for (GtkWidget *child = gtk_widget_get_first_child(widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling(child)) {
+    GtkScrolledWindow *found = find_scrolled_window(child);
+    if (found)
+      return found;
+  }
+
+  return NULL;
+}
+
+/* Scroll down by @dy, starting over at the top after the last row */
+static void
+scroll_by(GtkScrolledWindow *scrolled, double dy)
+{
+  GtkAdjustment *adj = gtk_scrolled_window_get_vadjustment(scrolled);
+  double value = gtk_adjustment_get_value(adj) + dy;
+
+  if (value > gtk_adjustment_get_upper(adj) - gtk_adjustment_get_page_size(adj))
+    value = gtk_adjustment_get_lower(adj);
+  gtk_adjustment_set_value(adj, value);
+}
+
+static int
+compare_double(gconstpointer a, gconstpointer b)
+{
+  const double x = *(const double *)a;
+  const double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* Sorts @samples in place */
+static double
+percentile(GArray *samples, double p)
+{
+  if (samples->len == 0)
+    return 0.0;
+
+  g_array_sort(samples, compare_double);
+  guint i = (guint)floor(p * (samples->len - 1) + 0.5);
+  return g_array_index(samples, double, i);
+}
+
+static void
+print_timings(const char *name, GArray *samples, gboolean last)
+{
+  g_print("  \"%s_us\": { \"p50\": %.1f, \"p90\": %.1f, \"p99\": %.1f, \"max\": %.1f }%s\n",
+          name,
+          percentile(samples, 0.50), percentile(samples, 0.90),
+          percentile(samples, 0.99), percentile(samples, 1.00),
+          last ? "" : ",");
+}
+
+/* --- Trend check --- */
+
+/* Columns of the newest @window samples as trend_buffer_decimate()
+ * defines them, scanned sample by sample from @history. Returns the
+ * columns that differ from @mn and @mx. */
+static guint
+check_columns(const float *history, guint64 total, guint capacity, guint window,
+              guint n_columns, const float *mn, const float *mx)
+{
+  const gint64 len    = (gint64)MIN(total, (guint64)capacity);
+  const gint64 offset = len - (gint64)(window ? window : capacity);
+  const float *held   = history + (total - (guint64)len);
+  guint wrong = 0;
+
+  for (guint c = 0; c < n_columns; c++) {
+    const guint64 span = window ? window : capacity;
+    gint64 first = offset + (gint64)(span * c / n_columns);
+    gint64 last  = offset + (gint64)(span * (c + 1) / n_columns);
+    float want_min = INFINITY, want_max = -INFINITY;
+
+    if (last <= first)
+      last = first + 1;
+    for (gint64 i = MAX(first, 0); i < MIN(last, len); i++) {
+      want_min = MIN(want_min, held[i]);
+      want_max = MAX(want_max, held[i]);
+    }
+
+    if (mn[c] != want_min || mx[c] != want_max)
+      wrong++;
+  }
+
+  return wrong;
+}
+
+/* Fills buffers of a few capacities past several laps and compares every
+ * window and column count below at head positions inside, at the start
+ * and at the end of summary blocks */
+static int
+run_verify_trend(void)
+{
+  static const guint capacities[] = { TREND_BLOCK, 3 * TREND_BLOCK, 16 * TREND_BLOCK };
+  static const guint windows[]    = { 0, 1, 7, TREND_BLOCK - 1, TREND_BLOCK, TREND_BLOCK + 1,
+                                      2 * TREND_BLOCK + 17, 5 * TREND_BLOCK, 40 * TREND_BLOCK };
+  static const guint columns[]    = { 1, 3, 64, 333, 1000 };
+  GRand *rand = g_rand_new_with_seed((guint32)opt_seed);
+  float *mn = g_new(float, 1000);
+  float *mx = g_new(float, 1000);
+  guint64 checks = 0, mismatches = 0;
+
+  for (guint k = 0; k < G_N_ELEMENTS(capacities); k++) {
+    const guint capacity = capacities[k];
+    const guint64 n_samples = 3 * (guint64)capacity + TREND_BLOCK / 2;
+    float *history = g_new(float, n_samples);
+    TrendBuffer *buffer = trend_buffer_new(capacity);
+
+    for (guint64 total = 1; total <= n_samples; total++) {
+      history[total - 1] = (float)g_rand_double_range(rand, -1000.0, 1000.0);
+      trend_buffer_append(buffer, history[total - 1]);
+
+      const guint head = (guint)(total % capacity);
+      if (total % 61 != 0 && head % TREND_BLOCK > 1 && head % TREND_BLOCK < TREND_BLOCK - 1)
+        continue;
+
+      for (guint w = 0; w < G_N_ELEMENTS(windows); w++) {
+        for (guint c = 0; c < G_N_ELEMENTS(columns); c++) {
+          trend_buffer_decimate(buffer, windows[w], columns[c], mn, mx);
+          mismatches += check_columns(history, total, capacity, windows[w], columns[c], mn, mx);
+          checks++;
+        }
+      }
+    }
+
+    trend_buffer_unref(buffer);
+    g_free(history);
+  }
+
+  g_print("{\"checks\": %" G_GUINT64_FORMAT ", \"mismatched_columns\": %" G_GUINT64_FORMAT "}\n",
+          checks, mismatches);
+
+  g_free(mn);
+  g_free(mx);
+  g_rand_free(rand);
+
+  return mismatches == 0 ? 0 : 1;
+}
+
+/* --- Overload run --- */
+
+/* Most text one write() to the stream hands over */
+#define BENCH_WRITE_SIZE 65536
+
+/* Time between two posted input events */
+#define BENCH_INPUT_INTERVAL_US 5000
+
+typedef struct {
+  OffscreenRender *offscreen;
+  GaugeAnimator   *animator;
+  TelemetryStream *stream;      /* parses what the producer writes, as live input */
+  UpdateScheduler *scheduler;   /* NULL with --unscheduled */
+  GPtrArray       *models;      /* GaugeModel per channel */
+  GMainLoop       *loop;
+  int              write_fd;    /* producer end of the stream's pipe */
+  double           rate;        /* samples per second, all channels together */
+  guint64          sent;        /* written by the producer, read after joining it */
+  gint64           interval;    /* µs between frames */
+  gint64           next_frame;
+  gint64           end;
+  guint64          applied;
+  GArray          *tick_us;     /* telemetry drain, as in the page's tick callback */
+  GArray          *frame_us;    /* drain, snapshot and render */
+  GArray          *latency_us;  /* input event posted until dispatched */
+  gint             stop;        /* atomic: producer and input threads quit */
+} OverloadRun;
+
+typedef struct {
+  OverloadRun *run;
+  gint64       posted;
+} InputEvent;
+
+static void
+apply_to_model(const TelemetrySample *sample, gpointer user_data)
+{
+  OverloadRun *run = user_data;
+
+  if (sample->channel < run->models->len)
+    gauge_model_update(g_ptr_array_index(run->models, sample->channel),
+                       sample->value, sample->timestamp);
+  run->applied++;
+}
+
+/* Stands in for the telemetry producer: "<channel> <value>" lines for one
+ * channel after the other, at a fixed rate of wall-clock time. A stream
+ * that cannot keep up blocks the writes, which shows as a rate below the
+ * one asked for. */
+static gpointer
+produce_samples(gpointer user_data)
+{
+  OverloadRun *run = user_data;
+  const guint n_channels = run->models->len;
+  GString *text = g_string_sized_new(BENCH_WRITE_SIZE + 64);
+  GRand *rand = g_rand_new_with_seed((guint32)opt_seed);
+  const gint64 start = g_get_monotonic_time();
+  guint64 sent = 0;
+
+  while (!g_atomic_int_get(&run->stop)) {
+    const guint64 due = (guint64)((double)(g_get_monotonic_time() - start) * run->rate / G_USEC_PER_SEC);
+
+    g_string_truncate(text, 0);
+    for (; sent < due && text->len < BENCH_WRITE_SIZE; sent++)
+      g_string_append_printf(text, "%u %.3f\n", (guint)(sent % n_channels),
+                             g_rand_double_range(rand, 0.0, 100.0));
+
+    if (text->len == 0) {
+      g_usleep(1000);
+      continue;
+    }
+
+    for (gsize done = 0; done < text->len; ) {
+      ssize_t n = write(run->write_fd, text->str + done, text->len - done);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n < 0)
+        goto out;
+      done += n;
+    }
+  }
+
+out:
+  run->sent = sent;
+  g_rand_free(rand);
+  g_string_free(text, TRUE);
+  return NULL;
+}
+
+static gboolean
+handle_input(gpointer user_data)
+{
+  InputEvent *event = user_data;
+  double latency = (double)(g_get_monotonic_time() - event->posted);
+
+  g_array_append_val(event->run->latency_us, latency);
+  return G_SOURCE_REMOVE;
+}
+
+/* Stands in for the windowing system: posts events at the priority GDK
+ * dispatches input with, so each waits for whatever the main thread is
+ * busy with, but not for the next frame */
+static gpointer
+post_input(gpointer user_data)
+{
+  OverloadRun *run = user_data;
+
+  while (!g_atomic_int_get(&run->stop)) {
+    InputEvent *event = g_new(InputEvent, 1);
+    GSource *source = g_idle_source_new();
+
+    event->run    = run;
+    event->posted = g_get_monotonic_time();
+    g_source_set_priority(source, GDK_PRIORITY_EVENTS);
+    g_source_set_callback(source, handle_input, event, g_free);
+    g_source_attach(source, NULL);
+    g_source_unref(source);
+
+    g_usleep(BENCH_INPUT_INTERVAL_US);
+  }
+
+  return NULL;
+}
+
+/* One frame at redraw priority: drain, then paint. The next one is due a
+ * frame interval after this one was, or at once when running late, as
+ * on a frame clock that skips missed frames. */
+static gboolean
+overload_frame(gpointer user_data)
+{
+  OverloadRun *run = user_data;
+  const gint64 t0 = g_get_monotonic_time();
+
+  if (run->scheduler != NULL) {
+    update_scheduler_drain(run->scheduler, TELEMETRY_SOURCE(run->stream), apply_to_model, run);
+  } else {
+    gauge_model_begin_batch();
+    telemetry_source_drain(TELEMETRY_SOURCE(run->stream), apply_to_model, run);
+    gauge_model_end_batch();
+  }
+
+  const gint64 t1 = g_get_monotonic_time();
+
+  /* Under this load something always changed, so every frame paints */
+  gauge_animator_advance(run->animator, t1);
+  GskRenderNode *node = offscreen_render_snapshot(run->offscreen);
+  GdkTexture *texture = offscreen_render_render(run->offscreen, node);
+  g_clear_object(&texture);
+  g_clear_pointer(&node, gsk_render_node_unref);
+
+  const gint64 t2 = g_get_monotonic_time();
+  double tick = (double)(t1 - t0), frame = (double)(t2 - t0);
+  g_array_append_val(run->tick_us, tick);
+  g_array_append_val(run->frame_us, frame);
+
+  if (t2 >= run->end) {
+    g_main_loop_quit(run->loop);
+    return G_SOURCE_REMOVE;
+  }
+
+  run->next_frame = MAX(run->next_frame + run->interval, t2);
+  g_timeout_add_full(GDK_PRIORITY_REDRAW, (guint)((run->next_frame - t2) / 1000),
+                     overload_frame, run, NULL);
+  return G_SOURCE_REMOVE;
+}
+
+/* Feeds every channel of the grid page at @overload times --rate for
+ * --seconds of wall-clock time, through a TelemetryStream as live input
+ * arrives. The page counts as responsive when the drain leaves at least
+ * half of each frame to painting and input, input waits at most two
+ * frames, and the stream neither dropped samples nor fell short of the
+ * rate asked for: otherwise the load was not what it claims. */
+static int
+run_overload(OffscreenRender *offscreen, GListModel *channels, GaugeAnimator *animator)
+{
+  const guint n_channels = g_list_model_get_n_items(channels);
+  g_autoptr(GError) error = NULL;
+  int fds[2];
+
+  if (n_channels == 0 || pipe(fds) < 0) {
+    g_printerr("Cannot set up the telemetry stream: %s\n",
+               n_channels == 0 ? "no channels" : g_strerror(errno));
+    return 1;
+  }
+
+  g_autoptr(TelemetryStream) stream = telemetry_stream_new_for_fd(fds[0]);
+  if (!telemetry_source_start(TELEMETRY_SOURCE(stream), &error)) {
+    g_printerr("Cannot start the telemetry stream: %s\n", error->message);
+    close(fds[1]);
+    return 1;
+  }
+
+  OverloadRun run = {
+    .offscreen  = offscreen,
+    .animator   = animator,
+    .stream     = stream,
+    .scheduler  = opt_unscheduled ? NULL : update_scheduler_new(n_channels),
+    .models     = g_ptr_array_new_with_free_func(g_object_unref),
+    .loop       = g_main_loop_new(NULL, FALSE),
+    .write_fd   = fds[1],
+    .rate       = opt_overload * opt_rate * n_channels,
+    .interval   = (gint64)(G_USEC_PER_SEC / opt_fps),
+    .tick_us    = g_array_new(FALSE, FALSE, sizeof(double)),
+    .frame_us   = g_array_new(FALSE, FALSE, sizeof(double)),
+    .latency_us = g_array_new(FALSE, FALSE, sizeof(double)),
+  };
+
+  for (guint i = 0; i < n_channels; i++)
+    g_ptr_array_add(run.models, g_list_model_get_item(channels, i));
+
+  run.next_frame = g_get_monotonic_time();
+  run.end        = run.next_frame + (gint64)(opt_seconds * G_USEC_PER_SEC);
+  g_timeout_add_full(GDK_PRIORITY_REDRAW, 0, overload_frame, &run, NULL);
+
+  GThread *producer = g_thread_new("bench-producer", produce_samples, &run);
+  GThread *input = g_thread_new("bench-input", post_input, &run);
+  g_main_loop_run(run.loop);
+  g_atomic_int_set(&run.stop, TRUE);
+  g_thread_join(input);
+  g_thread_join(producer);  /* the stream still reads, so no write blocks for good */
+  telemetry_source_stop(TELEMETRY_SOURCE(run.stream));
+  close(run.write_fd);
+
+  /* Events still queued are dispatched late, but dispatched */
+  while (g_main_context_iteration(NULL, FALSE))
+    ;
+
+  UpdateSchedulerStats stats = { 0 };
+  if (run.scheduler != NULL)
+    update_scheduler_get_stats(run.scheduler, &stats);
+
+  const guint dropped      = telemetry_stream_get_dropped(run.stream);
+  const double input_rate  = run.sent / opt_seconds;
+  const double tick_p99    = percentile(run.tick_us, 0.99);
+  const double latency_p99 = percentile(run.latency_us, 0.99);
+  const gboolean responsive = tick_p99 <= run.interval / 2.0 &&
+                              latency_p99 <= 2.0 * run.interval &&
+                              dropped == 0 &&
+                              input_rate >= 0.9 * run.rate;
+
+  g_print("{\n");
+  g_print("  \"content\": \"grid-page\",\n");
+  g_print("  \"channels\": %u,\n", n_channels);
+  g_print("  \"scheduled\": %s,\n", run.scheduler ? "true" : "false");
+  g_print("  \"overload\": %.2f,\n", opt_overload);
+  g_print("  \"samples_per_second\": %.0f,\n", run.rate);
+  g_print("  \"input_samples_per_second\": %.0f,\n", input_rate);
+  g_print("  \"samples_dropped\": %u,\n", dropped);
+  g_print("  \"fps\": %.2f,\n", opt_fps);
+  g_print("  \"frames\": %u,\n", run.frame_us->len);
+  g_print("  \"input_events\": %u,\n", run.latency_us->len);
+  g_print("  \"updates_applied\": %" G_GUINT64_FORMAT ",\n", run.applied);
+  g_print("  \"updates_coalesced\": %" G_GUINT64_FORMAT ",\n", stats.coalesced);
+  g_print("  \"updates_deferred\": %" G_GUINT64_FORMAT ",\n", stats.deferred);
+  print_timings("tick", run.tick_us, FALSE);
+  print_timings("frame", run.frame_us, FALSE);
+  print_timings("input_latency", run.latency_us, FALSE);
+  g_print("  \"responsive\": %s\n", responsive ? "true" : "false");
+  g_print("}\n");
+
+  g_array_unref(run.latency_us);
+  g_array_unref(run.frame_us);
+  g_array_unref(run.tick_us);
+  g_main_loop_unref(run.loop);
+  g_ptr_array_unref(run.models);
+  g_clear_object(&run.scheduler);
+
+  return responsive ? 0 : 1;
+}
+
+/* --- Main --- */
+int
+main(int argc, char *argv[])
+{
+  g_autoptr(GOptionContext) context = g_option_context_new("- GaugeWidget rendering benchmark");
+  g_autoptr(GError) error = NULL;
+
+  g_option_context_add_main_entries(context, bench_options, NULL);
+  if (!g_option_context_parse(context, &argc, &argv, &error)) {
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+
+  if (opt_verify_trend)
+    return run_verify_trend();
+
+  /* Only the grid page is fed through a telemetry source */
+  if (opt_overload > 0)
+    opt_grid_page = TRUE;
+
+  GaugeAnimationMode mode = GAUGE_ANIMATION_EASE;
+  if (g_strcmp0(opt_mode, "follow") == 0)
+    mode = GAUGE_ANIMATION_FOLLOW;
+  else if (opt_mode != NULL && g_strcmp0(opt_mode, "ease") != 0) {
+    g_printerr("Unknown animation mode: %s\n", opt_mode);
+    return 1;
+  }
+
+  adw_init();
+  ensure_types();
+
+  /* Pinned: the offscreen clock never paints, so the governor would not
+   * adapt anyway */
+  GEnumClass *quality_class = g_type_class_ref(GAUGE_TYPE_DETAIL);
+  GEnumValue *quality = g_enum_get_value_by_nick(quality_class, opt_quality ? opt_quality : "full");
+  if (quality == NULL || quality->value == GAUGE_DETAIL_AUTO) {
+    g_printerr("Unknown quality level: %s\n", opt_quality);
+    return 1;
+  }
+  quality_governor_set_level(quality->value, FALSE);
+
+  GtkWidget *content;
+  if (opt_grid_page) {
+    /* A scrolled page has no useful natural size */
+    content = g_object_new(GAUGE_TYPE_GRID_PAGE, "n-channels", (guint)opt_gauges, NULL);
+    if (opt_width <= 0)  opt_width  = 1920;
+    if (opt_height <= 0) opt_height = 1080;
+  } else if (opt_dashboard) {
+    content = g_object_new(DASHBOARD_TYPE_PAGE, NULL);
+  } else {
+    content = build_gauge_grid(opt_gauges);
+  }
+
+  OffscreenRender *offscreen = offscreen_render_new(content, opt_width, opt_height, &error);
+  if (offscreen == NULL) {
+    g_printerr("Cannot set up the software renderer: %s\n", error->message);
+    return 1;
+  }
+
+  /* The grid page recycles its gauges, so it is fed through its model */
+  GListModel *channels = opt_grid_page ? gauge_grid_page_get_model(GAUGE_GRID_PAGE(content)) : NULL;
+  GtkScrolledWindow *scrolled = opt_grid_page ? find_scrolled_window(content) : NULL;
+
+  g_autoptr(GPtrArray) gauges = g_ptr_array_new();
+  collect_gauges(content, gauges);
+  for (guint i = 0; i < gauges->len; i++)
+    gauge_widget_set_animation_mode(g_ptr_array_index(gauges, i), mode);
+
+  GaugeGroup *group = NULL;
+  g_autofree double *values = NULL;
+  if (opt_group && channels == NULL) {
+    group = gauge_group_new();
+    for (guint i = 0; i < gauges->len; i++)
+      gauge_group_add(group, g_ptr_array_index(gauges, i));
+    values = g_new(double, gauges->len);
+  }
+
+  GaugeAnimator *animator = gauge_animator_get_for_clock(offscreen_render_get_frame_clock(offscreen));
+
+  if (opt_overload > 0) {
+    int status = run_overload(offscreen, channels, animator);
+
+    offscreen_render_free(offscreen);
+    g_free(opt_mode);
+    g_free(opt_quality);
+    g_type_class_unref(quality_class);
+    return status;
+  }
+
+  GRand *rand = g_rand_new_with_seed((guint32)opt_seed);
+
+  const gint64 frame_us = (gint64)(G_USEC_PER_SEC / opt_fps);
+  const gint64 value_us = opt_rate > 0 ? (gint64)(G_USEC_PER_SEC / opt_rate) : G_MAXINT64;
+  const guint  n_frames = (guint)(opt_seconds * opt_fps);
+
+  g_autoptr(GArray) snapshot_us = g_array_new(FALSE, FALSE, sizeof(double));
+  g_autoptr(GArray) render_us   = g_array_new(FALSE, FALSE, sizeof(double));
+  guint64 value_changes = 0;
+  guint64 invalidations = 0;
+  guint   frames_drawn  = 0;
+
+  gint64 now = gauge_animator_get_time(animator);
+  gint64 next_values = now;
+
+  for (guint frame = 0; frame < n_frames; frame++) {
+    now += frame_us;
+
+    /* Synthetic stream: every gauge gets a new value at the given rate */
+    if (now >= next_values && channels != NULL) {
+      const guint n = g_list_model_get_n_items(channels);
+      gauge_model_begin_batch();
+      for (guint i = 0; i < n; i++) {
+        g_autoptr(GaugeModel) model = g_list_model_get_item(channels, i);
+        gauge_model_update(model, g_rand_double_range(rand, 0.0, 100.0), now);
+      }
+      gauge_model_end_batch();
+      value_changes += n;
+      next_values += value_us;
+    } else if (now >= next_values && group != NULL) {
+      for (guint i = 0; i < gauges->len; i++)
+        values[i] = g_rand_double_range(rand, 0.0, 100.0);
+      gauge_group_set_values(group, values, gauges->len);
+      value_changes += gauges->len;
+      next_values += value_us;
+    } else if (now >= next_values) {
+      for (guint i = 0; i < gauges->len; i++)
+        gauge_widget_set_value(g_ptr_array_index(gauges, i), g_rand_double_range(rand, 0.0, 100.0));
+      value_changes += gauges->len;
+      next_values += value_us;
+    }
+
+    if (scrolled != NULL && opt_scroll > 0)
+      scroll_by(scrolled, opt_scroll / opt_fps);
+
+    guint invalidated = gauge_animator_advance(animator, now);
+    invalidations += invalidated;
+    if (invalidated == 0 && frame > 0 && opt_scroll <= 0)
+      continue;  /* a real frame clock would not have painted */
+
+    gint64 t0 = g_get_monotonic_time();
+    GskRenderNode *node = offscreen_render_snapshot(offscreen);
+    gint64 t1 = g_get_monotonic_time();
+    GdkTexture *texture = offscreen_render_render(offscreen, node);
+    gint64 t2 = g_get_monotonic_time();
+
+    double s = (double)(t1 - t0), r = (double)(t2 - t1);
+    g_array_append_val(snapshot_us, s);
+    g_array_append_val(render_us, r);
+    frames_drawn++;
+
+    g_clear_object(&texture);
+    g_clear_pointer(&node, gsk_render_node_unref);
+  }
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  /* Widgets alive at the end; constant for a virtualized page */
+  g_ptr_array_set_size(gauges, 0);
+  collect_gauges(content, gauges);
+  DialCacheStats cache;
+  dial_cache_get_stats(&cache);
+
+  g_print("{\n");
+  g_print("  \"content\": \"%s\",\n",
+          opt_grid_page ? "grid-page" : opt_dashboard ? "dashboard" : "grid");
+  g_print("  \"channels\": %u,\n", channels ? g_list_model_get_n_items(channels) : gauges->len);
+  g_print("  \"gauges\": %u,\n", gauges->len);
+  g_print("  \"dial_cache_entries\": %u,\n", cache.entries);
+  g_print("  \"group\": %s,\n", group ? "true" : "false");
+  g_print("  \"mode\": \"%s\",\n", mode == GAUGE_ANIMATION_FOLLOW ? "follow" : "ease");
+  g_print("  \"quality\": \"%s\",\n", quality->value_nick);
+  g_print("  \"viewport\": [%d, %d],\n",
+          offscreen_render_get_width(offscreen), offscreen_render_get_height(offscreen));
+  g_print("  \"rate_hz\": %.2f,\n", opt_rate);
+  g_print("  \"fps\": %.2f,\n", opt_fps);
+  g_print("  \"frames_simulated\": %u,\n", n_frames);
+  g_print("  \"frames_drawn\": %u,\n", frames_drawn);
+  g_print("  \"value_changes\": %" G_GUINT64_FORMAT ",\n", value_changes);
+  g_print("  \"gauge_redraws\": %" G_GUINT64_FORMAT ",\n", invalidations);
+  g_print("  \"frames_per_value_change\": %.3f,\n",
+          value_changes ? (double)invalidations / (double)value_changes : 0.0);
+  g_print("  \"peak_rss_kb\": %ld,\n", usage.ru_maxrss);
+  print_timings("snapshot", snapshot_us, FALSE);
+  print_timings("render", render_us, TRUE);
+  g_print("}\n");
+
+  g_clear_pointer(&group, gauge_group_unref);
+  g_rand_free(rand);
+  offscreen_render_free(offscreen);
+  g_free(opt_mode);
+  g_free(opt_quality);
+  g_type_class_unref(quality_class);
+
+  return 0;
+}
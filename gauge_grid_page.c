@@ -0,0 +1,484 @@
+#include "gauge_grid_page.h"
+#include "page_signals.h"
+#include "page_telemetry.h"
+#include "dashboard_layout.h"
+#include "gauge_model.h"
+#include "gauge_widget.h"
+#include "memory_budget.h"
+#include "startup_trace.h"
+#include "your_app.h"
+
+#define DEFAULT_N_CHANNELS 10000
+#define DEFAULT_MAX_COLUMNS 16  /* columns without a layout */
+#define DEFAULT_LAYOUT     "/org/gnome/Example/gauge_grid.layout"
+#define DEMO_INTERVAL_MS   100
+#define DEMO_SLICE         1000  /* channels the demo moves per tick */
+
+enum {
+  PROP_0,
+  PROP_N_CHANNELS,
+  N_PROPERTIES
+};
+
+static GParamSpec *obj_properties[N_PROPERTIES] = { NULL, };
+
+struct _GaugeGridPage {
+  GtkBox parent_instance;
+
+  GtkGridView *grid_view;
+
+  GListStore *store;            /* GaugeModel items in layout order */
+  GListStore *cells;            /* what the grid shows: the same items in their
+                                 * cells, empty_cell where the layout has none */
+  GObject    *empty_cell;
+  GPtrArray  *channels;         /* same items by channel id, not owned; NULL: no gauge */
+  gboolean    populated;        /* from a layout or n-channels */
+
+  gboolean         active;          /* between "activated" and "deactivated" */
+  PageTelemetry    live;            /* application's source, scheduler and alarms */
+  guint            telemetry_tick;  /* frame-clock tick callback ID */
+
+  guint  demo_timer;            /* timeout ID */
+  guint  demo_cursor;           /* first channel of the next demo slice */
+
+  MemoryBudgetClient *budget;   /* trims row caches while hidden */
+};
+
+G_DEFINE_FINAL_TYPE (GaugeGridPage, gauge_grid_page, GTK_TYPE_BOX)
+
+/* --- Channels --- */
+static void
+set_n_channels(GaugeGridPage *self, guint n)
+{
+  const guint old_n = g_list_model_get_n_items(G_LIST_MODEL(self->store));
+  g_autoptr(GPtrArray) models = NULL;
+
+  self->populated = TRUE;
+  if (n == old_n && n == self->channels->len)
+    return;
+
+  models = g_ptr_array_new_full(n, g_object_unref);
+  for (guint i = 0; i < n; i++) {
+    g_autofree char *name = g_strdup_printf("Channel %u", i);
+    GaugeModel *model = gauge_model_new(i, name, 0.0, 100.0);
+
+    if (self->live.alarms != NULL)
+      gauge_model_set_alarm(model, alarm_engine_get_alarm(self->live.alarms, i));
+    g_ptr_array_add(models, model);
+  }
+
+  g_ptr_array_set_size(self->channels, 0);
+  g_ptr_array_extend(self->channels, models, NULL, NULL);
+
+  /* One items-changed for the whole set; the grid only binds what it shows */
+  g_list_store_splice(self->store, 0, old_n, models->pdata, n);
+  g_list_store_splice(self->cells, 0, g_list_model_get_n_items(G_LIST_MODEL(self->cells)),
+                      models->pdata, n);
+  gtk_grid_view_set_max_columns(self->grid_view, DEFAULT_MAX_COLUMNS);
+  gtk_grid_view_set_min_columns(self->grid_view, 1);
+
+  self->demo_cursor = 0;
+
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_N_CHANNELS]);
+}
+
+/* Models straight from the layout's records; the channel table has a
+ * hole wherever no gauge is bound. The grid gets exactly the layout's
+ * columns, and an empty cell wherever the layout skips one, so every
+ * gauge lands in its row and column. */
+static void
+set_layout(GaugeGridPage *self, DashboardLayout *layout)
+{
+  const guint old_n = g_list_model_get_n_items(G_LIST_MODEL(self->store));
+  const guint columns = dashboard_layout_get_columns(layout);
+  guint n;
+  const DashboardLayoutGauge *gauges = dashboard_layout_get_gauges(layout, &n);
+  g_autoptr(GPtrArray) models = g_ptr_array_new_full(n, g_object_unref);
+  g_autoptr(GPtrArray) cells = g_ptr_array_new();  /* borrowed from models and empty_cell */
+
+  self->populated = TRUE;
+
+  g_ptr_array_set_size(self->channels, 0);
+  g_ptr_array_set_size(self->channels, dashboard_layout_get_n_channels(layout));
+
+  for (guint i = 0; i < n; i++) {
+    GaugeModel *model = gauge_model_new(gauges[i].channel, dashboard_layout_get_name(layout, i),
+                                        gauges[i].min, gauges[i].max);
+
+    if (self->live.alarms != NULL)
+      gauge_model_set_alarm(model, alarm_engine_get_alarm(self->live.alarms, gauges[i].channel));
+
+    g_ptr_array_add(models, model);
+    self->channels->pdata[gauges[i].channel] = model;
+
+    /* The loader checked that cells increase and stay below
+     * DASHBOARD_LAYOUT_MAX_CELLS */
+    const guint cell = gauges[i].row * columns + gauges[i].column;
+    while (cells->len < cell)
+      g_ptr_array_add(cells, self->empty_cell);
+    g_ptr_array_add(cells, model);
+  }
+
+  g_list_store_splice(self->store, 0, old_n, models->pdata, n);
+  g_list_store_splice(self->cells, 0, g_list_model_get_n_items(G_LIST_MODEL(self->cells)),
+                      cells->pdata, cells->len);
+
+  /* A narrower window scrolls sideways instead of reflowing the rows */
+  gtk_grid_view_set_max_columns(self->grid_view, columns);
+  gtk_grid_view_set_min_columns(self->grid_view, columns);
+
+  self->demo_cursor = 0;
+
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_N_CHANNELS]);
+}
+
+/* The application's --layout, or the bundled one. Deferred until the
+ * page knows its application, unless n-channels came first. */
+static void
+ensure_populated(GaugeGridPage *self, YourAppApplication *app)
+{
+  g_autoptr(GError) error = NULL;
+  DashboardLayout *layout = NULL;
+
+  if (self->populated)
+    return;
+
+  if (app != NULL)
+    layout = your_app_application_get_layout(app);
+
+  if (layout != NULL) {
+    set_layout(self, layout);
+  } else if ((layout = dashboard_layout_new_from_resource(DEFAULT_LAYOUT, &error)) != NULL) {
+    set_layout(self, layout);
+    dashboard_layout_unref(layout);
+  } else {
+    g_warning("Bundled gauge layout unusable, showing %u channels: %s",
+              DEFAULT_N_CHANNELS, error->message);
+    set_n_channels(self, DEFAULT_N_CHANNELS);
+  }
+
+  startup_trace_mark("gauge layout loaded");
+}
+
+/* --- Row factory --- */
+static void
+setup_row(GtkSignalListItemFactory *factory, GObject *object, gpointer user_data)
+{
+  GtkListItem *item = GTK_LIST_ITEM(object);
+  GtkWidget *box = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+  GtkWidget *label = gtk_label_new(NULL);
+  GtkWidget *gauge = gauge_widget_new();
+
+  gtk_widget_add_css_class(label, "caption");
+  gauge_widget_set_animation_mode(GAUGE_WIDGET(gauge), GAUGE_ANIMATION_FOLLOW);
+
+  gtk_box_append(GTK_BOX(box), label);
+  gtk_box_append(GTK_BOX(box), gauge);
+  gtk_list_item_set_child(item, box);
+}
+
+/* A recycled row takes over its new channel without animating from the
+ * previous channel's value. Empty cells are still measured, so a row
+ * or column without gauges keeps its size, but are never mapped. */
+static void
+bind_row(GtkSignalListItemFactory *factory, GObject *object, gpointer user_data)
+{
+  GtkListItem *item = GTK_LIST_ITEM(object);
+  gpointer cell = gtk_list_item_get_item(item);
+  GtkWidget *box = gtk_list_item_get_child(item);
+  GtkWidget *label = gtk_widget_get_first_child(box);
+  GaugeWidget *gauge = GAUGE_WIDGET(gtk_widget_get_last_child(box));
+
+  gtk_widget_set_child_visible(box, GAUGE_IS_MODEL(cell));
+  if (!GAUGE_IS_MODEL(cell))
+    return;
+
+  gtk_label_set_text(GTK_LABEL(label), gauge_model_get_name(cell));
+  gauge_widget_set_model(gauge, cell);
+}
+
+static void
+unbind_row(GtkSignalListItemFactory *factory, GObject *object, gpointer user_data)
+{
+  GtkListItem *item = GTK_LIST_ITEM(object);
+  GtkWidget *box = gtk_list_item_get_child(item);
+
+  gauge_widget_set_model(GAUGE_WIDGET(gtk_widget_get_last_child(box)), NULL);
+}
+
+/* --- Demo data --- */
+
+/* Random walk on a rotating slice of the channels. Runs at idle
+ * priority, behind input and redraws. */
+static gboolean
+update_demo_cb(gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(user_data);
+  const guint n = self->channels->len;
+  const gint64 now = g_get_monotonic_time();
+
+  gauge_model_begin_batch();
+  for (guint i = 0; i < MIN(n, DEMO_SLICE); i++) {
+    GaugeModel *model = g_ptr_array_index(self->channels, self->demo_cursor);
+
+    self->demo_cursor = (self->demo_cursor + 1) % n;
+    if (model == NULL)
+      continue;
+
+    const double min = gauge_model_get_min(model);
+    const double max = gauge_model_get_max(model);
+    const double step = (max - min) * 0.1;
+    double value = gauge_model_get_value(model) + g_random_double_range(-step, step);
+
+    gauge_model_update(model, CLAMP(value, min, max), now);
+  }
+  gauge_model_end_batch();
+
+  return G_SOURCE_CONTINUE;
+}
+
+/* --- Telemetry --- */
+
+static void
+apply_sample(const TelemetrySample *sample, gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(user_data);
+  GaugeModel *model;
+
+  if (sample->channel < self->channels->len &&
+      (model = g_ptr_array_index(self->channels, sample->channel)) != NULL)
+    gauge_model_update(model, sample->value, sample->timestamp);
+}
+
+/* Once per frame: drain the ring into the models, so each bound gauge
+ * hears once about its channel's newest value. A model without a bound
+ * row has no "changed" handler, so gauge_model_update() only writes its
+ * fields and emits nothing. The scheduler bounds how much of the frame
+ * that may take. */
+static gboolean
+drain_telemetry_cb(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(widget);
+
+  page_telemetry_drain(&self->live, apply_sample, self);
+
+  return G_SOURCE_CONTINUE;
+}
+
+/* Live telemetry when the application has a source, demo data otherwise.
+ * The window only knows its application once it is shown, so this runs
+ * again on map. */
+static void
+start_updates(GaugeGridPage *self)
+{
+  if (!self->active)
+    return;
+
+  YourAppApplication *app = page_telemetry_lookup_application(GTK_WIDGET(self));
+
+  if (app != NULL) {
+    ensure_populated(self, app);
+    page_telemetry_connect(&self->live, app);
+  }
+
+  if (self->live.source != NULL) {
+    g_clear_handle_id(&self->demo_timer, g_source_remove);
+    if (self->telemetry_tick == 0)
+      self->telemetry_tick = gtk_widget_add_tick_callback(GTK_WIDGET(self),
+                                                          drain_telemetry_cb, NULL, NULL);
+  } else if (self->demo_timer == 0) {
+    self->demo_timer = g_timeout_add_full(G_PRIORITY_DEFAULT_IDLE, DEMO_INTERVAL_MS,
+                                          update_demo_cb, self, NULL);
+  }
+}
+
+static void
+stop_updates(GaugeGridPage *self)
+{
+  g_clear_handle_id(&self->demo_timer, g_source_remove);
+
+  if (self->telemetry_tick != 0) {
+    gtk_widget_remove_tick_callback(GTK_WIDGET(self), self->telemetry_tick);
+    self->telemetry_tick = 0;
+  }
+}
+
+/* --- Memory budget --- */
+static void
+release_gauge_caches(GtkWidget *widget)
+{
+  if (GAUGE_IS_WIDGET(widget)) {
+    gauge_widget_release_caches(GAUGE_WIDGET(widget));
+    return;
+  }
+
+  for (GtkWidget *child = gtk_widget_get_first_child(widget);
+       child != NULL;
+       child = gtk_widget_get_next_sibling(child))
+    release_gauge_caches(child);
+}
+
+/* The models are data, not cache: only the rows' rendering caches go,
+ * at either level */
+static void
+budget_trim_cb(MemoryTrimLevel level, gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(user_data);
+
+  release_gauge_caches(GTK_WIDGET(self->grid_view));
+}
+
+/* --- Page signals --- */
+static void
+on_page_activated(GObject *stack, GParamSpec *pspec, gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(user_data);
+
+  self->active = TRUE;
+  memory_budget_set_active(self->budget, TRUE);
+  start_updates(self);
+}
+
+static void
+on_page_deactivated(GObject *stack, GParamSpec *pspec, gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(user_data);
+
+  self->active = FALSE;
+  stop_updates(self);
+  memory_budget_set_active(self->budget, FALSE);
+}
+
+static void
+on_page_map(GtkWidget *widget, gpointer user_data)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE(widget);
+
+  ensure_populated(self, page_telemetry_lookup_application(widget));
+  start_updates(self);
+}
+
+/* --- Properties --- */
+static void
+gauge_grid_page_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE (object);
+
+  switch (prop_id) {
+  case PROP_N_CHANNELS:
+    set_n_channels (self, g_value_get_uint (value));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    break;
+  }
+}
+
+static void
+gauge_grid_page_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE (object);
+
+  switch (prop_id) {
+  case PROP_N_CHANNELS:
+    ensure_populated (self, NULL);
+    g_value_set_uint (value, g_list_model_get_n_items (G_LIST_MODEL (self->store)));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    break;
+  }
+}
+
+/* --- Class/init --- */
+static void
+gauge_grid_page_dispose (GObject *object)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE (object);
+
+  stop_updates (self);
+  page_telemetry_clear (&self->live);
+  g_clear_pointer (&self->budget, memory_budget_unregister);
+
+  G_OBJECT_CLASS (gauge_grid_page_parent_class)->dispose (object);
+}
+
+static void
+gauge_grid_page_finalize (GObject *object)
+{
+  GaugeGridPage *self = GAUGE_GRID_PAGE (object);
+
+  g_clear_pointer (&self->channels, g_ptr_array_unref);
+  g_clear_object (&self->cells);
+  g_clear_object (&self->store);
+  g_clear_object (&self->empty_cell);
+
+  G_OBJECT_CLASS (gauge_grid_page_parent_class)->finalize (object);
+}
+
+static void
+gauge_grid_page_class_init (GaugeGridPageClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->set_property = gauge_grid_page_set_property;
+  object_class->get_property = gauge_grid_page_get_property;
+  object_class->dispose      = gauge_grid_page_dispose;
+  object_class->finalize     = gauge_grid_page_finalize;
+
+  obj_properties[PROP_N_CHANNELS] = g_param_spec_uint ("n-channels", "Channels",
+                                                       "Number of gauges in the grid",
+                                                       0, G_MAXUINT, DEFAULT_N_CHANNELS,
+                                                       G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                       G_PARAM_STATIC_STRINGS);
+  g_object_class_install_properties (object_class, N_PROPERTIES, obj_properties);
+
+  gtk_widget_class_set_template_from_resource (widget_class,
+      "/org/gnome/Example/gauge_grid_page.ui");
+
+  gtk_widget_class_bind_template_child (widget_class, GaugeGridPage, grid_view);
+
+  register_page_signals(G_TYPE_FROM_CLASS(klass));
+}
+
+static void
+gauge_grid_page_init (GaugeGridPage *self)
+{
+  gtk_widget_init_template (GTK_WIDGET (self));
+
+  self->store    = g_list_store_new (GAUGE_TYPE_MODEL);
+  self->cells    = g_list_store_new (G_TYPE_OBJECT);
+  self->empty_cell = g_object_new (G_TYPE_OBJECT, NULL);
+  self->channels = g_ptr_array_new ();
+  page_telemetry_init (&self->live, self->channels);
+  self->populated = FALSE;
+
+  self->budget = memory_budget_register ("gauge grid", NULL, budget_trim_cb, self);
+
+  GtkListItemFactory *factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup",  G_CALLBACK (setup_row),  NULL);
+  g_signal_connect (factory, "bind",   G_CALLBACK (bind_row),   NULL);
+  g_signal_connect (factory, "unbind", G_CALLBACK (unbind_row), NULL);
+
+  GtkSelectionModel *selection = GTK_SELECTION_MODEL (
+      gtk_no_selection_new (g_object_ref (G_LIST_MODEL (self->cells))));
+  gtk_grid_view_set_model (self->grid_view, selection);
+  gtk_grid_view_set_factory (self->grid_view, factory);
+  g_object_unref (selection);
+  g_object_unref (factory);
+
+  g_signal_connect (self, "activated",   G_CALLBACK (on_page_activated),   self);
+  g_signal_connect (self, "deactivated", G_CALLBACK (on_page_deactivated), self);
+  g_signal_connect (self, "map",         G_CALLBACK (on_page_map),         NULL);
+}
+
+/* --- Public API --- */
+GListModel *
+gauge_grid_page_get_model (GaugeGridPage *self)
+{
+  g_return_val_if_fail (GAUGE_IS_GRID_PAGE (self), NULL);
+
+  ensure_populated (self, NULL);
+  return G_LIST_MODEL (self->store);
+}
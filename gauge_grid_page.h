@@ -0,0 +1,14 @@
+#pragma once
+#include <adwaita.h>
+
+G_BEGIN_DECLS
+
+#define GAUGE_TYPE_GRID_PAGE (gauge_grid_page_get_type())
+
+G_DECLARE_FINAL_TYPE (GaugeGridPage, gauge_grid_page, GAUGE, GRID_PAGE, GtkBox)
+
+/* Channels shown by the page, as a GListModel of GaugeModel in layout
+ * order, without the empty cells between them */
+GListModel *gauge_grid_page_get_model (GaugeGridPage *self);
+
+G_END_DECLS
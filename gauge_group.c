@@ -0,0 +1,123 @@
+#include "gauge_group.h"
+
+struct _GaugeGroup {
+  grefcount  ref_count;
+  GPtrArray *gauges;     /* GaugeWidget, owned */
+};
+
+/* --- Batched updates --- */
+
+/* Gauges of one window share an animator, so runs of the same animator
+ * are batched and a switch only happens across windows */
+typedef struct {
+  GaugeAnimator *animator;   /* batch in progress, if any */
+} GroupPass;
+
+static inline void
+group_pass_set(GroupPass *pass, GaugeWidget *gauge, double value)
+{
+  GaugeAnimator *animator = gauge_widget_group_get_animator(gauge);
+
+  if (animator != NULL && animator != pass->animator) {
+    if (pass->animator != NULL)
+      gauge_animator_end_batch(pass->animator);
+    pass->animator = animator;
+    gauge_animator_begin_batch(animator);
+  }
+
+  gauge_widget_group_set_value(gauge, value);
+}
+
+static inline void
+group_pass_end(GroupPass *pass)
+{
+  if (pass->animator != NULL)
+    gauge_animator_end_batch(pass->animator);
+}
+
+void
+gauge_group_apply(const GaugeGroupValue *values, guint n_values)
+{
+  g_return_if_fail(values != NULL || n_values == 0);
+
+  GroupPass pass = { NULL };
+
+  for (guint i = 0; i < n_values; i++)
+    group_pass_set(&pass, values[i].gauge, values[i].value);
+
+  group_pass_end(&pass);
+}
+
+/* --- Lifecycle --- */
+GaugeGroup *
+gauge_group_new(void)
+{
+  GaugeGroup *self = g_new0(GaugeGroup, 1);
+  g_ref_count_init(&self->ref_count);
+  self->gauges = g_ptr_array_new_with_free_func(g_object_unref);
+
+  return self;
+}
+
+GaugeGroup *
+gauge_group_ref(GaugeGroup *self)
+{
+  g_return_val_if_fail(self != NULL, NULL);
+
+  g_ref_count_inc(&self->ref_count);
+  return self;
+}
+
+void
+gauge_group_unref(GaugeGroup *self)
+{
+  g_return_if_fail(self != NULL);
+
+  if (!g_ref_count_dec(&self->ref_count))
+    return;
+
+  g_ptr_array_unref(self->gauges);
+  g_free(self);
+}
+
+/* --- Members --- */
+void
+gauge_group_add(GaugeGroup *self, GaugeWidget *gauge)
+{
+  g_return_if_fail(self != NULL);
+  g_return_if_fail(GAUGE_IS_WIDGET(gauge));
+
+  g_ptr_array_add(self->gauges, g_object_ref(gauge));
+}
+
+guint
+gauge_group_get_n_gauges(GaugeGroup *self)
+{
+  g_return_val_if_fail(self != NULL, 0);
+  return self->gauges->len;
+}
+
+GaugeWidget *
+gauge_group_get_gauge(GaugeGroup *self, guint index)
+{
+  g_return_val_if_fail(self != NULL, NULL);
+  g_return_val_if_fail(index < self->gauges->len, NULL);
+
+  return g_ptr_array_index(self->gauges, index);
+}
+
+void
+gauge_group_set_values(GaugeGroup *self, const double *values, guint n_values)
+{
+  g_return_if_fail(self != NULL);
+  g_return_if_fail(values != NULL || n_values == 0);
+
+  GaugeWidget **gauges = (GaugeWidget **)self->gauges->pdata;
+  const guint n = MIN(n_values, self->gauges->len);
+  GroupPass pass = { NULL };
+
+  for (guint i = 0; i < n; i++)
+    group_pass_set(&pass, gauges[i], values[i]);
+
+  group_pass_end(&pass);
+}
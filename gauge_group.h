@@ -0,0 +1,40 @@
+#pragma once
+#include <gtk/gtk.h>
+#include "gauge_animator.h"
+#include "gauge_widget.h"
+
+G_BEGIN_DECLS
+
+/* One gauge's new value, for gauge_group_apply() */
+typedef struct {
+  GaugeWidget *gauge;
+  double       value;
+} GaugeGroupValue;
+
+/* Sets many gauge values in one pass. Each frame clock's animator is
+ * started once per call rather than once per gauge, and gauges that are
+ * not on screen take their value without queueing a redraw. */
+void gauge_group_apply(const GaugeGroupValue *values, guint n_values);
+
+/* A fixed list of gauges that is updated from a contiguous value array,
+ * e.g. one telemetry frame. Holds a reference on each gauge. Main thread
+ * only. */
+typedef struct _GaugeGroup GaugeGroup;
+
+GaugeGroup  *gauge_group_new(void);
+GaugeGroup  *gauge_group_ref(GaugeGroup *self);
+void         gauge_group_unref(GaugeGroup *self);
+
+void         gauge_group_add(GaugeGroup *self, GaugeWidget *gauge);
+guint        gauge_group_get_n_gauges(GaugeGroup *self);
+GaugeWidget *gauge_group_get_gauge(GaugeGroup *self, guint index);
+
+/* @values[i] goes to gauge i; @n_values may be less than the group size */
+void         gauge_group_set_values(GaugeGroup *self, const double *values, guint n_values);
+
+/* GaugeWidget side, implemented in gauge_widget.c. set_value() skips the
+ * type check; get_animator() is NULL while the gauge is unmapped. */
+GaugeAnimator *gauge_widget_group_get_animator(GaugeWidget *self);
+void           gauge_widget_group_set_value(GaugeWidget *self, double value);
+
+G_END_DECLS
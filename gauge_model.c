@@ -0,0 +1,369 @@
+#include "gauge_model.h"
+
+enum {
+  PROP_0,
+  PROP_ID,
+  PROP_NAME,
+  PROP_MIN,
+  PROP_MAX,
+  PROP_VALUE,
+  N_PROPERTIES
+};
+
+enum {
+  SIGNAL_CHANGED,
+  N_SIGNALS
+};
+
+static GParamSpec *obj_properties[N_PROPERTIES] = { NULL, };
+static guint       obj_signals[N_SIGNALS] = { 0, };
+
+struct _GaugeModel {
+  GObject parent_instance;
+
+  guint        id;
+  char        *name;
+  double       min;
+  double       max;
+  double       value;
+  gint64       timestamp;
+  GaugeQuality quality;
+  GaugeAlarm   alarm;
+
+  guint        pending;   /* GaugeModelChanges recorded during a batch */
+};
+
+G_DEFINE_FINAL_TYPE(GaugeModel, gauge_model, G_TYPE_OBJECT)
+
+/* Batch state; models are main-thread objects like the widgets they feed */
+static guint      batch_depth = 0;
+static GPtrArray *batch_dirty = NULL;  /* models with pending changes, owned */
+
+/* --- Change delivery --- */
+static void
+gauge_model_changed(GaugeModel *self, guint changes)
+{
+  /* Most channels have no gauge bound: their fields are all there is to
+   * update. A gauge bound later reads the model when it binds. */
+  if (!g_signal_has_handler_pending(self, obj_signals[SIGNAL_CHANGED], 0, FALSE))
+    return;
+
+  if (batch_depth == 0) {
+    g_signal_emit(self, obj_signals[SIGNAL_CHANGED], 0, changes);
+    return;
+  }
+
+  if (self->pending == 0) {
+    if (batch_dirty == NULL)
+      batch_dirty = g_ptr_array_new();
+    g_ptr_array_add(batch_dirty, g_object_ref(self));
+  }
+  self->pending |= changes;
+}
+
+void
+gauge_model_begin_batch(void)
+{
+  batch_depth++;
+}
+
+void
+gauge_model_end_batch(void)
+{
+  g_return_if_fail(batch_depth > 0);
+
+  if (--batch_depth > 0 || batch_dirty == NULL)
+    return;
+
+  /* Detach the list first: handlers may run batches of their own */
+  GPtrArray *dirty = batch_dirty;
+  batch_dirty = NULL;
+
+  for (guint i = 0; i < dirty->len; i++) {
+    GaugeModel *model = g_ptr_array_index(dirty, i);
+    guint changes = model->pending;
+
+    model->pending = 0;
+    g_signal_emit(model, obj_signals[SIGNAL_CHANGED], 0, changes);
+    g_object_unref(model);
+  }
+
+  /* Keep the allocation for the next frame */
+  g_ptr_array_set_size(dirty, 0);
+  if (batch_dirty == NULL)
+    batch_dirty = dirty;
+  else
+    g_ptr_array_unref(dirty);
+}
+
+/* --- Properties --- */
+static void
+gauge_model_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  GaugeModel *self = GAUGE_MODEL(object);
+
+  switch (prop_id) {
+  case PROP_ID:
+    self->id = g_value_get_uint(value);
+    break;
+  case PROP_NAME:
+    g_free(self->name);
+    self->name = g_value_dup_string(value);
+    break;
+  case PROP_MIN:
+    gauge_model_set_range(self, g_value_get_double(value), self->max);
+    break;
+  case PROP_MAX:
+    gauge_model_set_range(self, self->min, g_value_get_double(value));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+    break;
+  }
+}
+
+static void
+gauge_model_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  GaugeModel *self = GAUGE_MODEL(object);
+
+  switch (prop_id) {
+  case PROP_ID:
+    g_value_set_uint(value, self->id);
+    break;
+  case PROP_NAME:
+    g_value_set_string(value, self->name);
+    break;
+  case PROP_MIN:
+    g_value_set_double(value, self->min);
+    break;
+  case PROP_MAX:
+    g_value_set_double(value, self->max);
+    break;
+  case PROP_VALUE:
+    g_value_set_double(value, self->value);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+    break;
+  }
+}
+
+/* --- Class/init --- */
+static void
+gauge_model_finalize(GObject *object)
+{
+  GaugeModel *self = GAUGE_MODEL(object);
+
+  g_free(self->name);
+
+  G_OBJECT_CLASS(gauge_model_parent_class)->finalize(object);
+}
+
+static void
+gauge_model_class_init(GaugeModelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+
+  object_class->set_property = gauge_model_set_property;
+  object_class->get_property = gauge_model_get_property;
+  object_class->finalize     = gauge_model_finalize;
+
+  /* Properties are for builder files and bindings. Hot paths use the
+   * accessors and "changed", which never touch notify machinery. */
+  obj_properties[PROP_ID] = g_param_spec_uint("id", "ID", "Telemetry channel number",
+                                              0, G_MAXUINT, 0,
+                                              G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                              G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_NAME] = g_param_spec_string("name", "Name", "Display name",
+                                                  NULL,
+                                                  G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY |
+                                                  G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_MIN] = g_param_spec_double("min", "Minimum", "Minimum value",
+                                                 -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
+                                                 G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                 G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_MAX] = g_param_spec_double("max", "Maximum", "Maximum value",
+                                                 -G_MAXDOUBLE, G_MAXDOUBLE, 100.0,
+                                                 G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                 G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_VALUE] = g_param_spec_double("value", "Value",
+                                                   "Latest value (not notified, see \"changed\")",
+                                                   -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
+                                                   G_PARAM_READABLE | G_PARAM_EXPLICIT_NOTIFY |
+                                                   G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties(object_class, N_PROPERTIES, obj_properties);
+
+  obj_signals[SIGNAL_CHANGED] = g_signal_new("changed",
+                                             G_TYPE_FROM_CLASS(klass),
+                                             G_SIGNAL_RUN_LAST,
+                                             0, NULL, NULL, NULL,
+                                             G_TYPE_NONE, 1, G_TYPE_UINT);
+}
+
+static void
+gauge_model_init(GaugeModel *self)
+{
+  self->min = 0.0;
+  self->max = 100.0;
+  self->value = 0.0;
+  self->timestamp = 0;
+  self->quality = GAUGE_QUALITY_GOOD;
+  self->alarm = GAUGE_ALARM_NONE;
+  self->pending = 0;
+}
+
+/* --- Public API --- */
+GaugeModel *
+gauge_model_new(guint id, const char *name, double min, double max)
+{
+  return g_object_new(GAUGE_TYPE_MODEL,
+                      "id",   id,
+                      "name", name,
+                      "min",  min,
+                      "max",  max,
+                      NULL);
+}
+
+guint
+gauge_model_get_id(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), 0);
+  return self->id;
+}
+
+const char *
+gauge_model_get_name(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), NULL);
+  return self->name;
+}
+
+double
+gauge_model_get_min(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), 0.0);
+  return self->min;
+}
+
+double
+gauge_model_get_max(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), 0.0);
+  return self->max;
+}
+
+double
+gauge_model_get_value(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), 0.0);
+  return self->value;
+}
+
+gint64
+gauge_model_get_timestamp(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), 0);
+  return self->timestamp;
+}
+
+GaugeQuality
+gauge_model_get_quality(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), GAUGE_QUALITY_GOOD);
+  return self->quality;
+}
+
+GaugeAlarm
+gauge_model_get_alarm(GaugeModel *self)
+{
+  g_return_val_if_fail(GAUGE_IS_MODEL(self), GAUGE_ALARM_NONE);
+  return self->alarm;
+}
+
+static void
+update_range_quality(GaugeModel *self, guint *changes)
+{
+  GaugeQuality quality = self->quality & ~GAUGE_QUALITY_OUT_OF_RANGE;
+
+  if (self->value < self->min || self->value > self->max)
+    quality |= GAUGE_QUALITY_OUT_OF_RANGE;
+
+  if (quality != self->quality) {
+    self->quality = quality;
+    *changes |= GAUGE_MODEL_CHANGED_QUALITY;
+  }
+}
+
+void
+gauge_model_set_range(GaugeModel *self, double min, double max)
+{
+  guint changes = GAUGE_MODEL_CHANGED_RANGE;
+
+  g_return_if_fail(GAUGE_IS_MODEL(self));
+
+  if (min == self->min && max == self->max)
+    return;
+
+  if (min != self->min) {
+    self->min = min;
+    g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MIN]);
+  }
+  if (max != self->max) {
+    self->max = max;
+    g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MAX]);
+  }
+
+  update_range_quality(self, &changes);
+  gauge_model_changed(self, changes);
+}
+
+void
+gauge_model_set_quality(GaugeModel *self, GaugeQuality quality)
+{
+  g_return_if_fail(GAUGE_IS_MODEL(self));
+
+  if (quality == self->quality)
+    return;
+
+  self->quality = quality;
+  gauge_model_changed(self, GAUGE_MODEL_CHANGED_QUALITY);
+}
+
+void
+gauge_model_set_alarm(GaugeModel *self, GaugeAlarm alarm)
+{
+  g_return_if_fail(GAUGE_IS_MODEL(self));
+
+  if (alarm == self->alarm)
+    return;
+
+  self->alarm = alarm;
+  gauge_model_changed(self, GAUGE_MODEL_CHANGED_ALARM);
+}
+
+/* A fresh sample also clears STALE: the source is talking again */
+void
+gauge_model_update(GaugeModel *self, double value, gint64 timestamp)
+{
+  guint changes = 0;
+
+  g_return_if_fail(GAUGE_IS_MODEL(self));
+
+  if (value != self->value || timestamp != self->timestamp) {
+    self->value = value;
+    self->timestamp = timestamp;
+    changes |= GAUGE_MODEL_CHANGED_VALUE;
+  }
+
+  if (self->quality & GAUGE_QUALITY_STALE) {
+    self->quality &= ~GAUGE_QUALITY_STALE;
+    changes |= GAUGE_MODEL_CHANGED_QUALITY;
+  }
+
+  update_range_quality(self, &changes);
+
+  if (changes)
+    gauge_model_changed(self, changes);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+#define GAUGE_TYPE_MODEL (gauge_model_get_type())
+
+/* Data quality of the current value; GOOD means no flag is set */
+typedef enum {
+  GAUGE_QUALITY_GOOD         = 0,
+  GAUGE_QUALITY_STALE        = 1 << 0,  /* source stopped sending */
+  GAUGE_QUALITY_OUT_OF_RANGE = 1 << 1,  /* value lies outside min..max */
+  GAUGE_QUALITY_INVALID      = 1 << 2,  /* source reported a bad reading */
+} GaugeQuality;
+
+/* Active limit violations of the channel, as evaluated by the alarm
+ * engine; NONE means the channel is within all its limits */
+typedef enum {
+  GAUGE_ALARM_NONE      = 0,
+  GAUGE_ALARM_LOW       = 1 << 0,
+  GAUGE_ALARM_HIGH      = 1 << 1,
+  GAUGE_ALARM_LOW_LOW   = 1 << 2,
+  GAUGE_ALARM_HIGH_HIGH = 1 << 3,
+  GAUGE_ALARM_RATE      = 1 << 4,  /* changing faster than its rate limit */
+} GaugeAlarm;
+
+#define GAUGE_ALARM_CRITICAL (GAUGE_ALARM_LOW_LOW | GAUGE_ALARM_HIGH_HIGH)
+
+/* What a "changed" emission covers */
+typedef enum {
+  GAUGE_MODEL_CHANGED_VALUE   = 1 << 0,  /* value or timestamp */
+  GAUGE_MODEL_CHANGED_RANGE   = 1 << 1,
+  GAUGE_MODEL_CHANGED_QUALITY = 1 << 2,
+  GAUGE_MODEL_CHANGED_ALARM   = 1 << 3,
+} GaugeModelChanges;
+
+/* One channel's data, independent of any widget. Updates are plain field
+ * writes; observers hear about them through the "changed" signal, which
+ * carries a GaugeModelChanges mask. Changes to a model nobody listens to
+ * are not emitted at all, so observers read the model when they attach. */
+G_DECLARE_FINAL_TYPE(GaugeModel, gauge_model, GAUGE, MODEL, GObject)
+
+GaugeModel  *gauge_model_new(guint id, const char *name, double min, double max);
+
+guint        gauge_model_get_id(GaugeModel *self);
+const char  *gauge_model_get_name(GaugeModel *self);
+double       gauge_model_get_min(GaugeModel *self);
+double       gauge_model_get_max(GaugeModel *self);
+double       gauge_model_get_value(GaugeModel *self);
+gint64       gauge_model_get_timestamp(GaugeModel *self);
+GaugeQuality gauge_model_get_quality(GaugeModel *self);
+GaugeAlarm   gauge_model_get_alarm(GaugeModel *self);
+
+void gauge_model_set_range(GaugeModel *self, double min, double max);
+void gauge_model_set_quality(GaugeModel *self, GaugeQuality quality);
+void gauge_model_set_alarm(GaugeModel *self, GaugeAlarm alarm);
+
+/* New sample; @timestamp in µs, OUT_OF_RANGE is derived from the range */
+void gauge_model_update(GaugeModel *self, double value, gint64 timestamp);
+
+/* Between begin and end, changes are only recorded. The outermost end
+ * emits "changed" once per touched model, with all its changes merged.
+ * Batches nest; main thread only. */
+void gauge_model_begin_batch(void);
+void gauge_model_end_batch(void);
+
+G_END_DECLS
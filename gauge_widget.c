@@ -1,7 +1,11 @@
 #include "gauge_widget.h"
+#include "dial_cache.h"
+#include "gauge_animator.h"
+#include "gauge_group.h"
+#include "quality_governor.h"
 #include <math.h>
+#include <string.h>
 #include <graphene.h>
-#include <pango/pangocairo.h>
 
 /* Properties */
 enum {
@@ -11,11 +15,99 @@ enum {
   PROP_VALUE,
   PROP_SHOW_DIGITAL,
   PROP_DURATION_MS,   /* new property */
+  PROP_ANIMATION_MODE,
+  PROP_FOLLOW_TIME_MS,
+  PROP_MODEL,
+  PROP_QUALITY,
   N_PROPERTIES
 };
 
 static GParamSpec *obj_properties[N_PROPERTIES] = { NULL, };
 
+/* Characters the digital readout can draw from pre-rendered glyphs */
+#define READOUT_GLYPHS   "0123456789.-"
+#define N_READOUT_GLYPHS (sizeof(READOUT_GLYPHS) - 1)
+
+/* One text node per readout character, shaped once. A changing number
+ * is drawn by placing these nodes, without shaping or allocating. */
+typedef struct {
+  GskRenderNode *glyph[N_READOUT_GLYPHS];
+  float          advance[N_READOUT_GLYPHS];
+} ReadoutStrip;
+
+static PangoFontDescription *readout_font = NULL; /* shared by all gauges */
+
+/* --- Style parts --- */
+
+/* The dial is painted from CSS nodes under gaugewidget, one per part:
+ *
+ *   gaugewidget
+ *   ├── face            centre of the background
+ *   ├── rim             edge of the background
+ *   ├── arc.low / arc.mid / arc.high
+ *   ├── tick.major / tick.minor
+ *   ├── needle
+ *   └── pivot
+ *
+ * Each part gives its colour through `color` and, for strokes, its width
+ * through `min-height`. The parts are never laid out or drawn as widgets;
+ * only their computed style is read. */
+typedef enum {
+  PART_FACE,
+  PART_RIM,
+  PART_ARC_LOW,
+  PART_ARC_MID,
+  PART_ARC_HIGH,
+  PART_TICK_MAJOR,
+  PART_TICK_MINOR,
+  PART_NEEDLE,
+  PART_PIVOT,
+  N_PARTS
+} GaugePartId;
+
+static const struct {
+  const char *name;
+  const char *css_class;
+  float       width;     /* stroke width without a min-height; 0: not a stroke */
+} part_nodes[N_PARTS] = {
+  [PART_FACE]       = { "face",   NULL,    0.0f },
+  [PART_RIM]        = { "rim",    NULL,    0.0f },
+  [PART_ARC_LOW]    = { "arc",    "low",   12.0f },
+  [PART_ARC_MID]    = { "arc",    "mid",   12.0f },
+  [PART_ARC_HIGH]   = { "arc",    "high",  12.0f },
+  [PART_TICK_MAJOR] = { "tick",   "major", 3.0f },
+  [PART_TICK_MINOR] = { "tick",   "minor", 1.5f },
+  [PART_NEEDLE]     = { "needle", NULL,    0.0f },
+  [PART_PIVOT]      = { "pivot",  NULL,    0.0f },
+};
+
+/* Built-in look, below any theme or application CSS */
+static const char default_css[] =
+  "gaugewidget > face { color: rgb(38, 38, 38); }\n"
+  "gaugewidget > rim { color: black; }\n"
+  "gaugewidget > arc.low { color: rgb(0, 204, 0); }\n"
+  "gaugewidget > arc.mid { color: rgb(255, 204, 0); }\n"
+  "gaugewidget > arc.high { color: rgb(204, 0, 0); }\n"
+  "gaugewidget > tick { color: white; }\n"
+  "gaugewidget > needle { color: red; }\n"
+  "gaugewidget > pivot { color: rgb(204, 204, 204); }\n";
+
+/* Everything the dial is drawn with; interned for DialCacheKey.style.
+ * Floats only, so there is no padding to hash or compare. */
+typedef struct {
+  GdkRGBA color[N_PARTS];
+  float   width[N_PARTS];
+} GaugeStyle;
+
+#define GAUGE_TYPE_PART (gauge_part_get_type())
+G_DECLARE_FINAL_TYPE(GaugePart, gauge_part, GAUGE, PART, GtkWidget)
+
+struct _GaugePart {
+  GtkWidget parent_instance;
+};
+
+G_DEFINE_FINAL_TYPE(GaugePart, gauge_part, GTK_TYPE_WIDGET)
+
 /* Instance struct */
 struct _GaugeWidget {
   GtkWidget parent_instance;
@@ -24,23 +116,68 @@ struct _GaugeWidget {
   double   max;
   double   value;
   gboolean show_digital;
-
-  cairo_surface_t *static_surface;
-  int cached_w, cached_h;
+  GaugeAlarm alarm;              /* limits the channel violates */
+  GaugeDetail quality;           /* AUTO: the governor's level */
+
+  GtkWidget *parts[N_PARTS];     /* style nodes, see part_nodes */
+  GaugeStyle style;              /* resolved from parts */
+  guint    style_id;             /* interned style, see gauge_style_intern() */
+  gboolean style_dirty;          /* a part's style changed since */
+  GdkRGBA  text_color;           /* readout, our own color */
+  guint    text_context_serial;  /* of the pango context the readout was shaped in */
+
+  DialCacheEntry *dial;          /* shared static dial for our current key */
+  GskRenderNode  *needle_node;   /* needle + pivot, pointing along +x */
+  int cached_w, cached_h;        /* logical size the needle was built for */
+
+  ReadoutStrip *readout_strip;   /* pre-rendered readout glyphs */
+  PangoLayout  *readout_layout;  /* fallback for text the strip cannot draw */
+  char     readout_text[32];     /* text the readout was last measured for */
+  gboolean readout_from_strip;   /* readout_text is drawn from the strip */
+  float    readout_width;        /* logical width of readout_text */
 
   double target_value;      /* where the needle should end up */
   double anim_value;        /* current animated value */
-  guint  anim_tick_id;      /* tick callback ID */
-  gint64 anim_start_time;   /* microseconds from frame clock */
-  gint64 anim_duration;     /* total duration in microseconds */
-  double anim_start_value;  /* where needle started */
-  double anim_target_value; /* where needle should end */
+  float  drawn_tip_x;       /* needle tip of the last snapshot, device px */
+  float  drawn_tip_y;
+  GaugeAnimator *animator;  /* animator we are registered with, if any */
+  guint  anim_slot;         /* our index in the animator */
+  guint  anim_skipped;      /* steps seen, for frame_divisor */
+  GaugeAnimator *clock_animator;  /* our frame clock's animator while mapped */
 
   double duration_ms;       /* base animation duration in ms (scales with delta) */
+
+  GaugeAnimationMode animation_mode;
+  double follow_time_ms;    /* follower time constant (1/ω) in ms */
+
+  GaugeModel *model;        /* data source we follow, if any */
+  gulong model_changed_id;
+
+  GaugeStats stats;         /* rendering cost counters */
 };
 
 G_DEFINE_TYPE(GaugeWidget, gauge_widget, GTK_TYPE_WIDGET)
 
+static void gauge_widget_stop_animation(GaugeWidget *self);
+
+GType
+gauge_animation_mode_get_type(void)
+{
+  static gsize type_id = 0;
+
+  if (g_once_init_enter(&type_id)) {
+    static const GEnumValue values[] = {
+      { GAUGE_ANIMATION_EASE,   "GAUGE_ANIMATION_EASE",   "ease" },
+      { GAUGE_ANIMATION_FOLLOW, "GAUGE_ANIMATION_FOLLOW", "follow" },
+      { 0, NULL, NULL }
+    };
+    GType type = g_enum_register_static(g_intern_static_string("GaugeAnimationMode"), values);
+    g_once_init_leave(&type_id, type);
+  }
+
+  return type_id;
+}
+
 /* --- Helpers --- */
 
 /* Map value to angle for top-facing semicircle: π..2π (180°..360°) */
@@ -58,64 +195,129 @@ angle_from_value(double v, double min, double max)
   return M_PI + frac * M_PI; /* sweep left (π) → right (2π) */
 }
 
+static inline GaugeDetail
+effective_quality(GaugeWidget *self)
+{
+  return self->quality == GAUGE_DETAIL_AUTO ? quality_governor_get_level() : self->quality;
+}
+
 static inline void
 invalidate_static_cache(GaugeWidget *self)
 {
-  if (self->static_surface) {
-    cairo_surface_destroy(self->static_surface);
-    self->static_surface = NULL;
-  }
+  g_clear_pointer(&self->dial, dial_cache_release);
+  g_clear_pointer(&self->needle_node, gsk_render_node_unref);
   self->cached_w = 0;
   self->cached_h = 0;
 }
 
-/* --- Static dial rebuild --- */
-static void
-gauge_widget_rebuild_static(GaugeWidget *self, int w, int h)
+/* Needle tip for @value in device pixels, at the current size and scale */
+static inline void
+needle_tip(GaugeWidget *self, double value, float *x, float *y)
 {
-  if (w <= 0 || h <= 0)
-    return;
+  const int w = gtk_widget_get_width(GTK_WIDGET(self));
+  const int h = gtk_widget_get_height(GTK_WIDGET(self));
+  const int scale = gtk_widget_get_scale_factor(GTK_WIDGET(self));
+  const double radius = MIN(w, h) * 0.42;
+  const double a = angle_from_value(value, self->min, self->max);
 
-  invalidate_static_cache(self);
+  *x = (float)((w / 2.0 + cos(a) * (radius - 30)) * scale);
+  *y = (float)((h * 0.55 + sin(a) * (radius - 30)) * scale);
+}
+
+/* Smallest value change that moves the needle tip by half a device pixel.
+ * Animations stop once they are closer than this to their target. */
+static double
+settle_epsilon(GaugeWidget *self)
+{
+  const int w = gtk_widget_get_width(GTK_WIDGET(self));
+  const int h = gtk_widget_get_height(GTK_WIDGET(self));
+  const int scale = gtk_widget_get_scale_factor(GTK_WIDGET(self));
+  const double needle_px = (MIN(w, h) * 0.42 - 30) * scale;
+
+  if (needle_px <= 0.5)
+    return G_MAXDOUBLE;
 
-  self->static_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, w, h);
-  self->cached_w = w;
-  self->cached_h = h;
+  /* Tip arc length is needle_px · Δangle, and the full range spans π */
+  return (0.5 / needle_px) / M_PI * (self->max - self->min);
+}
 
-  cairo_t *cr = cairo_create(self->static_surface);
+/* --- Static dial rebuild --- */
+static inline void
+add_color_stop(cairo_pattern_t *pattern, double offset, const GdkRGBA *color)
+{
+  cairo_pattern_add_color_stop_rgba(pattern, offset, color->red, color->green, color->blue, color->alpha);
+}
 
+static void
+gauge_widget_draw_dial(cairo_t *cr, const DialCacheKey *key, gpointer user_data)
+{
+  const int w = key->width;
+  const int h = key->height;
   const double cx = w / 2.0;
   const double cy = h * 0.55;
   const double radius = MIN(w, h) * 0.42;
+  const GaugeDetailFeatures *features = gauge_detail_get_features(key->quality);
+  GaugeWidget *self = GAUGE_WIDGET(user_data);
+  const GaugeStyle *style = &self->style;
+  const GdkRGBA *color = style->color;
+
+  /* Called on dial cache misses only: hits cost nothing to count */
+  self->stats.dial_rebuilds++;
+  perf_stats_record_dial_rebuild();
 
-  cairo_set_antialias(cr, CAIRO_ANTIALIAS_BEST);
+  cairo_set_antialias(cr, features->antialias);
 
   /* --- Background gradient half-circle --- */
-  cairo_pattern_t *bg = cairo_pattern_create_radial(cx, cy, 0, cx, cy, radius);
-  cairo_pattern_add_color_stop_rgb(bg, 0.0, 0.15, 0.15, 0.15);
-  cairo_pattern_add_color_stop_rgb(bg, 1.0, 0.0, 0.0, 0.0);
-  cairo_set_source(cr, bg);
+  cairo_pattern_t *bg = NULL;
+  if (features->gradients) {
+    bg = cairo_pattern_create_radial(cx, cy, 0, cx, cy, radius);
+    add_color_stop(bg, 0.0, &color[PART_FACE]);
+    add_color_stop(bg, 1.0, &color[PART_RIM]);
+    cairo_set_source(cr, bg);
+  } else {
+    /* Halfway between centre and rim */
+    cairo_set_source_rgba(cr,
+                          (color[PART_FACE].red   + color[PART_RIM].red)   / 2.0,
+                          (color[PART_FACE].green + color[PART_RIM].green) / 2.0,
+                          (color[PART_FACE].blue  + color[PART_RIM].blue)  / 2.0,
+                          (color[PART_FACE].alpha + color[PART_RIM].alpha) / 2.0);
+  }
 
   cairo_arc(cr, cx, cy, radius, M_PI, 2 * M_PI); /* top semicircle */
   cairo_line_to(cr, cx, cy);                     /* close to center */
   cairo_close_path(cr);
   cairo_fill(cr);
 
-  cairo_pattern_destroy(bg);
-
-  /* --- Colored arc (green → yellow → red) --- */
-  cairo_set_line_width(cr, 12.0);
-  cairo_arc(cr, cx, cy, radius - 10, M_PI, 2 * M_PI);
-  cairo_pattern_t *arc = cairo_pattern_create_linear(cx - radius, cy, cx + radius, cy);
-  cairo_pattern_add_color_stop_rgb(arc, 0.0, 0.0, 0.8, 0.0); /* green */
-  cairo_pattern_add_color_stop_rgb(arc, 0.5, 1.0, 0.8, 0.0); /* yellow */
-  cairo_pattern_add_color_stop_rgb(arc, 1.0, 0.8, 0.0, 0.0); /* red */
-  cairo_set_source(cr, arc);
-  cairo_stroke(cr);
-  cairo_pattern_destroy(arc);
+  g_clear_pointer(&bg, cairo_pattern_destroy);
+
+  /* --- Colored arc (low → mid → high) --- */
+  if (features->gradients) {
+    cairo_set_line_width(cr, style->width[PART_ARC_LOW]);
+    cairo_arc(cr, cx, cy, radius - 10, M_PI, 2 * M_PI);
+    cairo_pattern_t *arc = cairo_pattern_create_linear(cx - radius, cy, cx + radius, cy);
+    add_color_stop(arc, 0.0, &color[PART_ARC_LOW]);
+    add_color_stop(arc, 0.5, &color[PART_ARC_MID]);
+    add_color_stop(arc, 1.0, &color[PART_ARC_HIGH]);
+    cairo_set_source(cr, arc);
+    cairo_stroke(cr);
+    cairo_pattern_destroy(arc);
+  } else {
+    /* Three solid bands in the same colours */
+    for (int i = 0; i < 3; i++) {
+      cairo_set_line_width(cr, style->width[PART_ARC_LOW + i]);
+      cairo_arc(cr, cx, cy, radius - 10, M_PI + i * (M_PI / 3.0), M_PI + (i + 1) * (M_PI / 3.0));
+      gdk_cairo_set_source_rgba(cr, &color[PART_ARC_LOW + i]);
+      cairo_stroke(cr);
+    }
+  }
 
   /* --- Tick marks --- */
   for (int i = 0; i <= 10; i++) {
+    const GaugePartId tick = (i % 5 == 0) ? PART_TICK_MAJOR : PART_TICK_MINOR;
+
+    if (tick == PART_TICK_MINOR && !features->minor_ticks)
+      continue;
+
     double a = M_PI + i * (M_PI / 10.0);
     double x1 = cx + cos(a) * (radius - 20);
     double y1 = cy + sin(a) * (radius - 20);
@@ -124,78 +326,417 @@ gauge_widget_rebuild_static(GaugeWidget *self, int w, int h)
 
     cairo_move_to(cr, x1, y1);
     cairo_line_to(cr, x2, y2);
-    cairo_set_line_width(cr, (i % 5 == 0) ? 3.0 : 1.5);
-    cairo_set_source_rgb(cr, 1, 1, 1);
+    cairo_set_line_width(cr, style->width[tick]);
+    gdk_cairo_set_source_rgba(cr, &color[tick]);
     cairo_stroke(cr);
   }
+}
+
+/* Needle and pivot as plain color nodes, built around the pivot at (0, 0)
+ * so a snapshot only has to translate and rotate it into place. */
+static GskRenderNode *
+gauge_widget_build_needle(const GaugeStyle *style, double radius)
+{
+  GtkSnapshot *snapshot = gtk_snapshot_new();
+
+  gtk_snapshot_append_color(snapshot, &style->color[PART_NEEDLE],
+                            &GRAPHENE_RECT_INIT(0, -2, MAX(radius - 30, 0), 4));
+
+  GskRoundedRect pivot;
+  gsk_rounded_rect_init_from_rect(&pivot, &GRAPHENE_RECT_INIT(-6, -6, 12, 12), 6);
+  gtk_snapshot_push_rounded_clip(snapshot, &pivot);
+  gtk_snapshot_append_color(snapshot, &style->color[PART_PIVOT], &pivot.bounds);
+  gtk_snapshot_pop(snapshot);
+
+  return gtk_snapshot_free_to_node(snapshot);
+}
+
+/* Swap our dial for the shared one matching the current key. The cache
+ * rasterizes at device resolution, so w×h logical pixels become
+ * (w·scale)×(h·scale) texels. */
+static void
+gauge_widget_rebuild_static(GaugeWidget *self, const DialCacheKey *key)
+{
+  DialCacheEntry *dial = dial_cache_acquire(key, gauge_widget_draw_dial, self);
+
+  /* Acquire before release so a key shared with others is never evicted */
+  g_clear_pointer(&self->dial, dial_cache_release);
+  self->dial = dial;
+
+  if (key->width != self->cached_w || key->height != self->cached_h) {
+    g_clear_pointer(&self->needle_node, gsk_render_node_unref);
+    self->needle_node = gauge_widget_build_needle(&self->style, MIN(key->width, key->height) * 0.42);
+    self->cached_w = key->width;
+    self->cached_h = key->height;
+  }
+}
+
+/* --- Digital readout --- */
+static ReadoutStrip *
+readout_strip_new(GtkWidget *widget, const GdkRGBA *text_color)
+{
+  ReadoutStrip *strip = g_new0(ReadoutStrip, 1);
+  PangoLayout *layout = gtk_widget_create_pango_layout(widget, NULL);
+
+  pango_layout_set_font_description(layout, readout_font);
+
+  for (guint i = 0; i < N_READOUT_GLYPHS; i++) {
+    int pw = 0;
+
+    pango_layout_set_text(layout, &READOUT_GLYPHS[i], 1);
+    pango_layout_get_size(layout, &pw, NULL);
+    strip->advance[i] = (float)pw / PANGO_SCALE;
+
+    GtkSnapshot *snapshot = gtk_snapshot_new();
+    gtk_snapshot_append_layout(snapshot, layout, text_color);
+    strip->glyph[i] = gtk_snapshot_free_to_node(snapshot);
+  }
+
+  g_object_unref(layout);
+  return strip;
+}
+
+static void
+readout_strip_free(ReadoutStrip *strip)
+{
+  for (guint i = 0; i < N_READOUT_GLYPHS; i++)
+    g_clear_pointer(&strip->glyph[i], gsk_render_node_unref);
+  g_free(strip);
+}
+
+static inline int
+readout_glyph_index(char c)
+{
+  const char *p = strchr(READOUT_GLYPHS, c);
+  return (c != '\0' && p) ? (int)(p - READOUT_GLYPHS) : -1;
+}
+
+/* Drop everything derived from the widget's font setup */
+static void
+invalidate_readout_cache(GaugeWidget *self)
+{
+  g_clear_pointer(&self->readout_strip, readout_strip_free);
+  g_clear_object(&self->readout_layout);
+  self->readout_text[0] = '\0';
+  self->readout_width = 0.0f;
+}
+
+/* Re-measure only when the formatted text differs from the last frame */
+static void
+gauge_widget_update_readout(GaugeWidget *self, const char *text)
+{
+  if (self->readout_strip && strcmp(text, self->readout_text) == 0)
+    return;
+
+  if (!self->readout_strip)
+    self->readout_strip = readout_strip_new(GTK_WIDGET(self), &self->text_color);
+
+  g_strlcpy(self->readout_text, text, sizeof(self->readout_text));
+
+  float width = 0.0f;
+  self->readout_from_strip = TRUE;
+
+  for (const char *c = self->readout_text; *c; c++) {
+    int i = readout_glyph_index(*c);
+    if (i < 0) {
+      self->readout_from_strip = FALSE;
+      break;
+    }
+    width += self->readout_strip->advance[i];
+  }
+
+  if (!self->readout_from_strip) {
+    int pw = 0;
+
+    if (!self->readout_layout) {
+      self->readout_layout = gtk_widget_create_pango_layout(GTK_WIDGET(self), NULL);
+      pango_layout_set_font_description(self->readout_layout, readout_font);
+    }
+    pango_layout_set_text(self->readout_layout, self->readout_text, -1);
+    pango_layout_get_size(self->readout_layout, &pw, NULL);
+    width = (float)pw / PANGO_SCALE;
+  }
+
+  self->readout_width = width;
+}
+
+static void
+gauge_widget_snapshot_readout(GaugeWidget *self, GtkSnapshot *snapshot, float x, float y)
+{
+  gtk_snapshot_save(snapshot);
+  gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT(x, y));
+
+  if (self->readout_from_strip) {
+    for (const char *c = self->readout_text; *c; c++) {
+      int i = readout_glyph_index(*c);
+
+      if (self->readout_strip->glyph[i])
+        gtk_snapshot_append_node(snapshot, self->readout_strip->glyph[i]);
+      gtk_snapshot_translate(snapshot,
+                             &GRAPHENE_POINT_INIT(self->readout_strip->advance[i], 0));
+    }
+  } else {
+    gtk_snapshot_append_layout(snapshot, self->readout_layout, &self->text_color);
+  }
+
+  gtk_snapshot_restore(snapshot);
+}
+
+/* --- Style --- */
+
+/* Every distinct style resolved so far, to its id. Ids are handed out in
+ * order, so two styles never share one and neither do their dials; the
+ * hash only picks the bucket. Styles are few and small and are kept for
+ * the life of the process. */
+static GHashTable *interned_styles = NULL;  /* GaugeStyle* → id */
+
+static guint
+gauge_style_hash(gconstpointer data)
+{
+  const guint8 *bytes = data;
+  guint hash = 2166136261u;  /* FNV-1a */
+
+  for (gsize i = 0; i < sizeof(GaugeStyle); i++)
+    hash = (hash ^ bytes[i]) * 16777619u;
+
+  return hash;
+}
+
+static gboolean
+gauge_style_equal(gconstpointer a, gconstpointer b)
+{
+  return memcmp(a, b, sizeof(GaugeStyle)) == 0;
+}
+
+static guint
+gauge_style_intern(const GaugeStyle *style)
+{
+  gpointer id;
+
+  if (interned_styles == NULL)
+    interned_styles = g_hash_table_new_full(gauge_style_hash, gauge_style_equal, g_free, NULL);
+
+  if (g_hash_table_lookup_extended(interned_styles, style, NULL, &id))
+    return GPOINTER_TO_UINT(id);
+
+  const guint new_id = g_hash_table_size(interned_styles) + 1;
+  g_hash_table_insert(interned_styles, g_memdup2(style, sizeof(*style)), GUINT_TO_POINTER(new_id));
+  return new_id;
+}
+
+/* What part @i adds to the style: its colour, and its width if it is a
+ * stroke */
+static void
+gauge_widget_resolve_part(GaugeWidget *self, guint i, GdkRGBA *color, float *width)
+{
+  gtk_widget_get_color(self->parts[i], color);
+  *width = 0.0f;
+
+  if (part_nodes[i].width > 0.0f) {
+    int height = 0;
+
+    gtk_widget_measure(self->parts[i], GTK_ORIENTATION_VERTICAL, -1, &height, NULL, NULL, NULL);
+    *width = height > 0 ? (float)height : part_nodes[i].width;
+  }
+}
+
+/* Read colours and widths off the parts. A restyle that computes the
+ * same values keeps the dial; one that does not moves us to the key of
+ * the new style, which only the first gauge to need it rasterizes. */
+static void
+gauge_widget_update_style(GaugeWidget *self)
+{
+  GaugeStyle style;
+
+  memset(&style, 0, sizeof(style));
+  for (guint i = 0; i < N_PARTS; i++)
+    gauge_widget_resolve_part(self, i, &style.color[i], &style.width[i]);
+
+  self->style_dirty = FALSE;
+  if (memcmp(&style, &self->style, sizeof(style)) == 0)
+    return;
+
+  self->style    = style;
+  self->style_id = gauge_style_intern(&style);
+
+  /* The needle is ours alone: rebuild it with the dial */
+  g_clear_pointer(&self->needle_node, gsk_render_node_unref);
+  self->cached_w = 0;
+  self->cached_h = 0;
+}
+
+/* Coalesces the css-changed of every part into one update at the next
+ * snapshot */
+static void
+gauge_widget_queue_style(GaugeWidget *self)
+{
+  self->style_dirty = TRUE;
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+/* Hover, focus and backdrop restyle every part without changing what it
+ * resolves to: only a part whose colour or width differs from the
+ * current style queues an update */
+static void
+gauge_part_css_changed(GtkWidget *widget, GtkCssStyleChange *change)
+{
+  GtkWidget *gauge = gtk_widget_get_parent(widget);
+
+  GTK_WIDGET_CLASS(gauge_part_parent_class)->css_changed(widget, change);
+
+  if (!GAUGE_IS_WIDGET(gauge))
+    return;
+
+  GaugeWidget *self = GAUGE_WIDGET(gauge);
+  if (self->style_dirty)
+    return;
+
+  for (guint i = 0; i < N_PARTS; i++) {
+    GdkRGBA color;
+    float width;
+
+    if (self->parts[i] != widget)
+      continue;
+
+    gauge_widget_resolve_part(self, i, &color, &width);
+    if (gdk_rgba_equal(&color, &self->style.color[i]) && width == self->style.width[i])
+      return;
+    break;
+  }
+
+  gauge_widget_queue_style(self);
+}
+
+static void
+gauge_part_class_init(GaugePartClass *klass)
+{
+  GTK_WIDGET_CLASS(klass)->css_changed = gauge_part_css_changed;
+}
 
-  cairo_destroy(cr);
+static void
+gauge_part_init(GaugePart *self)
+{
+}
+
+/* Once per display, at the lowest priority, so any theme or application
+ * CSS overrides it */
+static void
+ensure_default_style(GdkDisplay *display)
+{
+  if (display == NULL || g_object_get_data(G_OBJECT(display), "gauge-widget-default-css") != NULL)
+    return;
+
+  GtkCssProvider *provider = gtk_css_provider_new();
+  gtk_css_provider_load_from_string(provider, default_css);
+  gtk_style_context_add_provider_for_display(display, GTK_STYLE_PROVIDER(provider),
+                                             GTK_STYLE_PROVIDER_PRIORITY_FALLBACK);
+  g_object_set_data_full(G_OBJECT(display), "gauge-widget-default-css", provider, g_object_unref);
 }
 
 /* --- Snapshot --- */
 static void
-gauge_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot)
+gauge_widget_snapshot_contents(GtkWidget *widget, GtkSnapshot *snapshot)
 {
   GaugeWidget *self = GAUGE_WIDGET(widget);
   int w = gtk_widget_get_width(widget);
   int h = gtk_widget_get_height(widget);
 
-  if (!self->static_surface || w != self->cached_w || h != self->cached_h)
-    gauge_widget_rebuild_static(self, w, h);
+  if (self->style_dirty)
+    gauge_widget_update_style(self);
 
-  graphene_rect_t bounds = GRAPHENE_RECT_INIT(0, 0, (float)w, (float)h);
-  cairo_t *cr = gtk_snapshot_append_cairo(snapshot, &bounds);
+  DialCacheKey key = {
+    .width  = w,
+    .height = h,
+    .scale  = gtk_widget_get_scale_factor(widget),
+    .min    = self->min,
+    .max    = self->max,
+    .quality = effective_quality(self),
+    .style  = self->style_id,
+  };
 
-  if (self->static_surface) {
-    cairo_set_source_surface(cr, self->static_surface, 0, 0);
-    cairo_paint(cr);
-  }
+  if (!self->dial || !dial_cache_key_equal(&key, dial_cache_entry_get_key(self->dial)))
+    gauge_widget_rebuild_static(self, &key);
+
+  if (!self->dial)
+    return;
+
+  /* Dial: the same shared texture every frame, so the renderer uploads it once */
+  gtk_snapshot_append_texture(snapshot, dial_cache_entry_get_texture(self->dial),
+                              &GRAPHENE_RECT_INIT(0, 0, (float)w, (float)h));
 
   const double cx = w / 2.0;
   const double cy = h * 0.55;
   const double radius = MIN(w, h) * 0.42;
 
-  /* Needle */
+  /* Needle: a moving needle is only a new transform on a cached node */
   double na = angle_from_value(self->anim_value, self->min, self->max);
-  double nx = cx + cos(na) * (radius - 30);
-  double ny = cy + sin(na) * (radius - 30);
-
-  cairo_set_source_rgb(cr, 1.0, 0.0, 0.0);
-  cairo_set_line_width(cr, 4.0);
-  cairo_move_to(cr, cx, cy);
-  cairo_line_to(cr, nx, ny);
-  cairo_stroke(cr);
-
-  /* Pivot circle */
-  cairo_arc(cr, cx, cy, 6, 0, 2 * M_PI);
-  cairo_set_source_rgb(cr, 0.8, 0.8, 0.8);
-  cairo_fill(cr);
+  needle_tip(self, self->anim_value, &self->drawn_tip_x, &self->drawn_tip_y);
+
+  gtk_snapshot_save(snapshot);
+  gtk_snapshot_translate(snapshot, &GRAPHENE_POINT_INIT((float)cx, (float)cy));
+  gtk_snapshot_rotate(snapshot, (float)(na * 180.0 / M_PI));
+  gtk_snapshot_append_node(snapshot, self->needle_node);
+  gtk_snapshot_restore(snapshot);
 
   /* Digital readout */
   if (self->show_digital) {
     char buf[32];
     g_snprintf(buf, sizeof(buf), "%.1f", self->anim_value);
+    gauge_widget_update_readout(self, buf);
 
-    PangoLayout *layout = pango_cairo_create_layout(cr);
-    PangoFontDescription *desc = pango_font_description_from_string("Sans Bold 14");
-    pango_layout_set_font_description(layout, desc);
-    pango_layout_set_text(layout, buf, -1);
+    float x = (w - self->readout_width) / 2.0f;
+    float y = (float)(cy + radius * 0.1);
+    gauge_widget_snapshot_readout(self, snapshot, x, y);
+  }
 
-    int tw = 0, th = 0;
-    pango_layout_get_pixel_size(layout, &tw, &th);
+  /* Alarm frame: amber for a warning limit, red for a critical one */
+  if (self->alarm != GAUGE_ALARM_NONE) {
+    const GdkRGBA color = (self->alarm & GAUGE_ALARM_CRITICAL)
+                        ? (GdkRGBA) { 0.9f, 0.1f, 0.1f, 1.0f }
+                        : (GdkRGBA) { 1.0f, 0.65f, 0.0f, 1.0f };
+    const float widths[4] = { 3, 3, 3, 3 };
+    const GdkRGBA colors[4] = { color, color, color, color };
+    GskRoundedRect frame;
+
+    gsk_rounded_rect_init_from_rect(&frame, &GRAPHENE_RECT_INIT(0, 0, (float)w, (float)h), 6);
+    gtk_snapshot_append_border(snapshot, &frame, widths, colors);
+  }
+}
 
-    double x = (w - tw) / 2.0;
-    double y = cy + radius * 0.1;
+static void
+gauge_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot)
+{
+  GaugeWidget *self = GAUGE_WIDGET(widget);
+  const gint64 start = g_get_monotonic_time();
 
-    cairo_set_source_rgb(cr, 0, 0, 0);
-    cairo_move_to(cr, x, y);
-    pango_cairo_show_layout(cr, layout);
+  gauge_widget_snapshot_contents(widget, snapshot);
 
-    pango_font_description_free(desc);
-    g_object_unref(layout);
-  }
+  const gint64 elapsed = g_get_monotonic_time() - start;
+  self->stats.snapshots++;
+  self->stats.snapshot_us += elapsed;
+  perf_stats_record_snapshot(elapsed);
+}
+
+/* The shaped glyphs are stale only if our colour or the pango context
+ * (font or display settings) changed. The dial is styled by the parts,
+ * which see their own changes. */
+static void
+gauge_widget_css_changed(GtkWidget *widget, GtkCssStyleChange *change)
+{
+  GaugeWidget *self = GAUGE_WIDGET(widget);
+  GdkRGBA color;
 
-  cairo_destroy(cr);
+  GTK_WIDGET_CLASS(gauge_widget_parent_class)->css_changed(widget, change);
+
+  gtk_widget_get_color(widget, &color);
+  const guint serial = pango_context_get_serial(gtk_widget_get_pango_context(widget));
+  if (gdk_rgba_equal(&color, &self->text_color) && serial == self->text_context_serial)
+    return;
+
+  self->text_color = color;
+  self->text_context_serial = serial;
+  invalidate_readout_cache(self);
+  gtk_widget_queue_draw(widget);
 }
 
 
@@ -223,23 +764,34 @@ gauge_widget_set_property(GObject *object, guint prop_id, const GValue *value, G
   GaugeWidget *self = GAUGE_WIDGET(object);
   switch (prop_id) {
   case PROP_MIN:
-    self->min = g_value_get_double(value);
-    invalidate_static_cache(self);
-    break;
+    gauge_widget_set_range(self, g_value_get_double(value), self->max);
+    return;
   case PROP_MAX:
-    self->max = g_value_get_double(value);
-    invalidate_static_cache(self);
-    break;
+    gauge_widget_set_range(self, self->min, g_value_get_double(value));
+    return;
   case PROP_VALUE:
+    /* set_value() decides itself whether anything visible changed */
     gauge_widget_set_value(self, g_value_get_double(value));
-    break;
+    return;
   case PROP_SHOW_DIGITAL:
-    self->show_digital = g_value_get_boolean(value);
-    break;
+    gauge_widget_set_show_digital(self, g_value_get_boolean(value));
+    return;
   case PROP_DURATION_MS:
     self->duration_ms = g_value_get_double(value);
     if (self->duration_ms < 1.0) self->duration_ms = 1.0;
     break;
+  case PROP_ANIMATION_MODE:
+    gauge_widget_set_animation_mode(self, g_value_get_enum(value));
+    return;
+  case PROP_FOLLOW_TIME_MS:
+    self->follow_time_ms = g_value_get_double(value);
+    break;
+  case PROP_MODEL:
+    gauge_widget_set_model(self, g_value_get_object(value));
+    return;
+  case PROP_QUALITY:
+    gauge_widget_set_quality(self, g_value_get_enum(value));
+    return;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
     return;
@@ -267,6 +819,18 @@ gauge_widget_get_property(GObject *object, guint prop_id, GValue *value, GParamS
   case PROP_DURATION_MS:
     g_value_set_double(value, self->duration_ms);
     break;
+  case PROP_ANIMATION_MODE:
+    g_value_set_enum(value, self->animation_mode);
+    break;
+  case PROP_FOLLOW_TIME_MS:
+    g_value_set_double(value, self->follow_time_ms);
+    break;
+  case PROP_MODEL:
+    g_value_set_object(value, self->model);
+    break;
+  case PROP_QUALITY:
+    g_value_set_enum(value, self->quality);
+    break;
   default:
     G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
     break;
@@ -278,7 +842,15 @@ static void
 gauge_widget_dispose(GObject *object)
 {
   GaugeWidget *self = GAUGE_WIDGET(object);
+  if (self->model != NULL) {
+    g_clear_signal_handler(&self->model_changed_id, self->model);
+    g_clear_object(&self->model);
+  }
+  gauge_widget_stop_animation(self);
   invalidate_static_cache(self);
+  invalidate_readout_cache(self);
+  for (guint i = 0; i < N_PARTS; i++)
+    g_clear_pointer(&self->parts[i], gtk_widget_unparent);
   G_OBJECT_CLASS(gauge_widget_parent_class)->dispose(object);
 }
 
@@ -289,6 +861,7 @@ gauge_widget_class_init(GaugeWidgetClass *klass)
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
   widget_class->snapshot = gauge_widget_snapshot;
   widget_class->measure  = gauge_widget_measure;
+  widget_class->css_changed = gauge_widget_css_changed;
 
   GObjectClass *object_class = G_OBJECT_CLASS(klass);
   object_class->set_property = gauge_widget_set_property;
@@ -297,23 +870,55 @@ gauge_widget_class_init(GaugeWidgetClass *klass)
 
   obj_properties[PROP_MIN] = g_param_spec_double("min", "Minimum", "Minimum value",
                                                  -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
-                                                 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+                                                 G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                 G_PARAM_STATIC_STRINGS);
   obj_properties[PROP_MAX] = g_param_spec_double("max", "Maximum", "Maximum value",
                                                  -G_MAXDOUBLE, G_MAXDOUBLE, 100.0,
-                                                 G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+                                                 G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                 G_PARAM_STATIC_STRINGS);
   obj_properties[PROP_VALUE] = g_param_spec_double("value", "Value", "Current value",
                                                    -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
                                                    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
   obj_properties[PROP_SHOW_DIGITAL] = g_param_spec_boolean("show-digital", "Show digital", "Show digital readout",
                                                            TRUE,
-                                                           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+                                                           G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                           G_PARAM_STATIC_STRINGS);
   obj_properties[PROP_DURATION_MS] = g_param_spec_double("duration-ms", "Duration (ms)",
                                                          "Base animation duration in milliseconds (scaled by delta/50)",
                                                          1.0, G_MAXDOUBLE, 2000.0,
                                                          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_ANIMATION_MODE] = g_param_spec_enum("animation-mode", "Animation mode",
+                                                          "How the needle moves towards a new value",
+                                                          GAUGE_TYPE_ANIMATION_MODE, GAUGE_ANIMATION_EASE,
+                                                          G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                          G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_FOLLOW_TIME_MS] = g_param_spec_double("follow-time-ms", "Follow time (ms)",
+                                                            "Time constant of the follow mode in milliseconds",
+                                                            1.0, G_MAXDOUBLE, 80.0,
+                                                            G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_MODEL] = g_param_spec_object("model", "Model",
+                                                   "GaugeModel whose value and range the gauge shows",
+                                                   GAUGE_TYPE_MODEL,
+                                                   G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                   G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_QUALITY] = g_param_spec_enum("quality", "Quality",
+                                                   "Rendering detail, or auto to follow the quality governor",
+                                                   GAUGE_TYPE_DETAIL, GAUGE_DETAIL_AUTO,
+                                                   G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                   G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties(object_class, N_PROPERTIES, obj_properties);
   gtk_widget_class_set_css_name(widget_class, "gaugewidget");
+
+  readout_font = pango_font_description_from_string("Sans Bold 14");
+}
+
+static void
+gauge_widget_stop_animation(GaugeWidget *self)
+{
+  if (self->animator != NULL)
+    gauge_animator_cancel(self->animator, self);
+  self->animator = NULL;
 }
 
 static void
@@ -322,11 +927,13 @@ gauge_widget_on_unmap(GtkWidget *widget, gpointer user_data)
   GaugeWidget *self = GAUGE_WIDGET(widget);
 
   /* Stop animation */
-  if (self->anim_tick_id != 0)
-  {
-    gtk_widget_remove_tick_callback(widget, self->anim_tick_id);
-    self->anim_tick_id = 0;
-  }
+  gauge_widget_stop_animation(self);
+  self->clock_animator = NULL;
+  quality_governor_unwatch(widget);
+
+  /* Hand the dial back to the cache; recycled list rows that scrolled
+   * away must not pin textures nobody sees */
+  invalidate_static_cache(self);
 
   /* Force needle to final value */
   if (self->anim_value != self->value)
@@ -341,11 +948,25 @@ gauge_widget_on_map(GtkWidget *widget, gpointer user_data)
 {
   GaugeWidget *self = GAUGE_WIDGET(widget);
 
+  /* Look the animator up once here rather than on every value change */
+  self->clock_animator = gauge_animator_get_for_clock(gtk_widget_get_frame_clock(widget));
+  quality_governor_watch(widget);
+
   /* Ensure anim_value is synced to value */
   self->anim_value = self->value;
   gtk_widget_queue_draw(widget);
 }
 
+static void
+gauge_widget_on_scale_factor(GObject *object, GParamSpec *pspec, gpointer user_data)
+{
+  GaugeWidget *self = GAUGE_WIDGET(object);
+
+  /* Moved to a monitor with a different scale: pick up a matching dial */
+  invalidate_static_cache(self);
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
 static void
 gauge_widget_init(GaugeWidget *self)
 {
@@ -353,24 +974,57 @@ gauge_widget_init(GaugeWidget *self)
   self->max = 100.0;
   self->value = 0.0;
   self->show_digital = TRUE;
-
-  self->static_surface = NULL;
+  self->alarm = GAUGE_ALARM_NONE;
+  self->quality = GAUGE_DETAIL_AUTO;
+
+  ensure_default_style(gtk_widget_get_display(GTK_WIDGET(self)));
+  for (guint i = 0; i < N_PARTS; i++) {
+    self->parts[i] = g_object_new(GAUGE_TYPE_PART, "css-name", part_nodes[i].name, NULL);
+    if (part_nodes[i].css_class != NULL)
+      gtk_widget_add_css_class(self->parts[i], part_nodes[i].css_class);
+    gtk_widget_set_parent(self->parts[i], GTK_WIDGET(self));
+    gtk_widget_set_child_visible(self->parts[i], FALSE);  /* styled, never laid out */
+  }
+  memset(&self->style, 0, sizeof(self->style));
+  self->style_id    = 0;
+  self->style_dirty = TRUE;
+  self->text_color  = (GdkRGBA) { 0.0f, 0.0f, 0.0f, 1.0f };
+  self->text_context_serial = 0;
+
+  self->dial        = NULL;
+  self->needle_node = NULL;
   self->cached_w = 0;
   self->cached_h = 0;
 
+  self->readout_strip      = NULL;
+  self->readout_layout     = NULL;
+  self->readout_text[0]    = '\0';
+  self->readout_from_strip = FALSE;
+  self->readout_width      = 0.0f;
+
   self->target_value  = 0;
   self->anim_value    = 0;
-  self->anim_tick_id  = 0;
-
-  self->anim_start_time   = 0;
-  self->anim_duration     = 0;
-  self->anim_start_value  = 0;
-  self->anim_target_value = 0;
+  self->drawn_tip_x   = 0;
+  self->drawn_tip_y   = 0;
+  self->animator      = NULL;
+  self->anim_slot     = GAUGE_ANIMATOR_NO_SLOT;
+  self->anim_skipped  = 0;
+  self->clock_animator = NULL;
 
   self->duration_ms = 2000.0; /* default base duration */
 
+  self->animation_mode = GAUGE_ANIMATION_EASE;
+  self->follow_time_ms = 80.0;
+
+  self->model = NULL;
+  self->model_changed_id = 0;
+
+  memset(&self->stats, 0, sizeof(self->stats));
+
   g_signal_connect(self, "unmap", G_CALLBACK(gauge_widget_on_unmap), NULL);
   g_signal_connect(self, "map",   G_CALLBACK(gauge_widget_on_map),   NULL);
+  g_signal_connect(self, "notify::scale-factor",
+                   G_CALLBACK(gauge_widget_on_scale_factor), NULL);
 }
 
 /* --- Public API --- */
@@ -383,89 +1037,332 @@ gauge_widget_new(void)
 void
 gauge_widget_set_range(GaugeWidget *self, double min, double max)
 {
-  g_object_set(self, "min", min, "max", max, NULL);
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  if (min == self->min && max == self->max)
+    return;
+
+  g_object_freeze_notify(G_OBJECT(self));
+  if (min != self->min) {
+    self->min = min;
+    g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MIN]);
+  }
+  if (max != self->max) {
+    self->max = max;
+    g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MAX]);
+  }
+  g_object_thaw_notify(G_OBJECT(self));
+
+  invalidate_static_cache(self);
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void
+gauge_widget_get_range(GaugeWidget *self, double *min, double *max)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  if (min) *min = self->min;
+  if (max) *max = self->max;
 }
 
-static gboolean
-gauge_widget_tick_cb(GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+/* --- Animator hooks --- */
+guint
+gauge_widget_animator_get_slot(GaugeWidget *self)
 {
-  GaugeWidget *self = GAUGE_WIDGET(widget);
+  return self->anim_slot;
+}
 
-  gint64 now = gdk_frame_clock_get_frame_time(frame_clock); /* µs */
-  double t = 0.0;
+void
+gauge_widget_animator_set_slot(GaugeWidget *self, guint slot)
+{
+  self->anim_slot = slot;
+  if (slot == GAUGE_ANIMATOR_NO_SLOT)
+    self->animator = NULL;
+}
 
-  if (self->anim_duration > 0)
-  {
-    t = (double)(now - self->anim_start_time) / (double)self->anim_duration;
-  }
+gboolean
+gauge_widget_animator_update(GaugeWidget *self, double value, gboolean finished)
+{
+  const gint64 start = g_get_monotonic_time();
 
-  if (t >= 1.0)
-  {
-    self->anim_value = self->anim_target_value;
+  /* Under load, move on every Nth step only; the step after the skipped
+   * ones still lands where the curve is by then */
+  const guint divisor = gauge_detail_get_features(effective_quality(self))->frame_divisor;
+  if (divisor > 1 && !finished && ++self->anim_skipped % divisor != 0)
+    return FALSE;
 
-    gtk_widget_remove_tick_callback(widget, self->anim_tick_id);
-    self->anim_tick_id = 0;
+  self->anim_value = value;
 
-    /* Optional: emit "animation-finished" here */
-  } else {
-    /* Ease-out cubic interpolation */
-    double u = 1.0 - pow(1.0 - t, 3);
-    self->anim_value = self->anim_start_value +
-      (self->anim_target_value - self->anim_start_value) * u;
+  /* Skip frames in which neither the tip nor the readout visibly moves */
+  float x, y;
+  needle_tip(self, value, &x, &y);
+  gboolean moved = hypotf(x - self->drawn_tip_x, y - self->drawn_tip_y) >= 0.5f;
+
+  if (!moved && self->show_digital) {
+    char buf[32];
+    g_snprintf(buf, sizeof(buf), "%.1f", value);
+    moved = strcmp(buf, self->readout_text) != 0;
   }
 
-  gtk_widget_queue_draw(widget);
-  return G_SOURCE_CONTINUE;
+  if (moved)
+    gtk_widget_queue_draw(GTK_WIDGET(self));
+
+  const gint64 elapsed = g_get_monotonic_time() - start;
+  self->stats.anim_steps++;
+  self->stats.anim_us += elapsed;
+  perf_stats_record_anim_step(elapsed);
+
+  return moved;
 }
 
-void
-gauge_widget_set_value(GaugeWidget *self, double value)
+/* Retarget to @value, already clamped. An unmapped gauge only takes the
+ * value: map syncs the needle and redraws anyway. */
+static void
+gauge_widget_retarget(GaugeWidget *self, double value)
 {
-  /* Clamp to range */
-  if (value < self->min) value = self->min;
-  if (value > self->max) value = self->max;
+  /* Same target as before: nothing to restart, nothing to redraw */
+  if (value == self->value && (self->animator != NULL || self->anim_value == value))
+    return;
 
   /* Update canonical property immediately */
   self->value = value;
 
+  /* Not on screen: nothing to animate, just jump */
+  if (self->clock_animator == NULL) {
+    gauge_widget_stop_animation(self);
+    self->anim_value = value;
+    return;
+  }
+
+  self->animator = self->clock_animator;
+
+  /* High-rate input: move the follower's target, keep its motion */
+  if (self->animation_mode == GAUGE_ANIMATION_FOLLOW) {
+    gauge_animator_follow(self->animator, self,
+                          self->anim_value, value,
+                          1000.0 / self->follow_time_ms,
+                          settle_epsilon(self));
+    return;
+  }
+
   /* Duration scales with delta relative to 50 units */
   double delta = fabs(value - self->anim_value);
   double duration_ms = (delta / 50.0) * self->duration_ms;
   if (duration_ms < 1.0) duration_ms = 1.0;
 
   /* Retarget mid-flight: start from current interpolated anim_value */
-  self->anim_start_value  = self->anim_value;
-  self->anim_target_value = value;
-  self->anim_start_time   = g_get_monotonic_time(); /* µs */
-  self->anim_duration     = (gint64)(duration_ms * 1000.0);
-
-  if (self->anim_tick_id == 0) {
-    self->anim_tick_id = gtk_widget_add_tick_callback(GTK_WIDGET(self),
-        gauge_widget_tick_cb,
-        NULL, NULL);
-  }
+  gauge_animator_ease(self->animator, self,
+                      self->anim_value, value,
+                      (gint64)(duration_ms * 1000.0),
+                      settle_epsilon(self));
+
+  /* The animator invalidates us from the next frame on */
+}
+
+void
+gauge_widget_set_value(GaugeWidget *self, double value)
+{
+  /* Clamp to range */
+  if (value < self->min) value = self->min;
+  if (value > self->max) value = self->max;
+
+  gauge_widget_retarget(self, value);
+}
+
+/* --- Group hooks --- */
+GaugeAnimator *
+gauge_widget_group_get_animator(GaugeWidget *self)
+{
+  return self->clock_animator;
+}
+
+void
+gauge_widget_group_set_value(GaugeWidget *self, double value)
+{
+  gauge_widget_retarget(self, CLAMP(value, self->min, self->max));
+}
+
+/* Jump to @value without animating, e.g. when a recycled gauge is bound
+ * to a different channel */
+void
+gauge_widget_set_value_instant(GaugeWidget *self, double value)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
 
+  value = CLAMP(value, self->min, self->max);
+
+  gauge_widget_stop_animation(self);
+  if (value == self->value && value == self->anim_value)
+    return;
+
+  self->value = value;
+  self->anim_value = value;
   gtk_widget_queue_draw(GTK_WIDGET(self));
 }
 
 double
 gauge_widget_get_value(GaugeWidget *self)
 {
-  double v = 0.0;
-  g_object_get(self, "value", &v, NULL);
-  return v;
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), 0.0);
+  return self->value;
 }
 
 void
 gauge_widget_set_show_digital(GaugeWidget *self, gboolean show)
 {
-  g_object_set(self, "show-digital", show, NULL);
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  show = !!show;
+  if (show == self->show_digital)
+    return;
+
+  self->show_digital = show;
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_SHOW_DIGITAL]);
+  gtk_widget_queue_draw(GTK_WIDGET(self));
 }
 
 gboolean
 gauge_widget_get_show_digital(GaugeWidget *self)
 {
-  gboolean s = FALSE;
-  g_object_get(self, "show-digital", &s, NULL);
-  return s;
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), FALSE);
+  return self->show_digital;
+}
+
+/* Everything here is rebuilt by the next snapshot */
+void
+gauge_widget_release_caches(GaugeWidget *self)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  invalidate_static_cache(self);
+  invalidate_readout_cache(self);
+}
+
+void
+gauge_widget_get_stats(GaugeWidget *self, GaugeStats *stats)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+  g_return_if_fail(stats != NULL);
+
+  *stats = self->stats;
+}
+
+gboolean
+gauge_widget_is_animating(GaugeWidget *self)
+{
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), FALSE);
+
+  return self->anim_slot != GAUGE_ANIMATOR_NO_SLOT;
+}
+
+void
+gauge_widget_set_alarm(GaugeWidget *self, GaugeAlarm alarm)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  if (alarm == self->alarm)
+    return;
+
+  self->alarm = alarm;
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+GaugeAlarm
+gauge_widget_get_alarm(GaugeWidget *self)
+{
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), GAUGE_ALARM_NONE);
+  return self->alarm;
+}
+
+void
+gauge_widget_set_animation_mode(GaugeWidget *self, GaugeAnimationMode mode)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  if (mode == self->animation_mode)
+    return;
+
+  self->animation_mode = mode;
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_ANIMATION_MODE]);
+}
+
+GaugeAnimationMode
+gauge_widget_get_animation_mode(GaugeWidget *self)
+{
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), GAUGE_ANIMATION_EASE);
+  return self->animation_mode;
+}
+
+void
+gauge_widget_set_quality(GaugeWidget *self, GaugeDetail quality)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+
+  if (quality == self->quality)
+    return;
+
+  /* The next snapshot picks up the dial for the new level */
+  self->quality = quality;
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_QUALITY]);
+}
+
+GaugeDetail
+gauge_widget_get_quality(GaugeWidget *self)
+{
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), GAUGE_DETAIL_AUTO);
+  return self->quality;
+}
+
+/* --- Model binding --- */
+static void
+gauge_widget_on_model_changed(GaugeModel *model, guint changes, gpointer user_data)
+{
+  GaugeWidget *self = GAUGE_WIDGET(user_data);
+
+  if (changes & GAUGE_MODEL_CHANGED_RANGE)
+    gauge_widget_set_range(self, gauge_model_get_min(model), gauge_model_get_max(model));
+  if (changes & GAUGE_MODEL_CHANGED_VALUE)
+    gauge_widget_set_value(self, gauge_model_get_value(model));
+  if (changes & GAUGE_MODEL_CHANGED_ALARM)
+    gauge_widget_set_alarm(self, gauge_model_get_alarm(model));
+}
+
+/* Rebinding is a signal reconnect and a snap to the new model's state,
+ * which is all a recycled list row needs */
+void
+gauge_widget_set_model(GaugeWidget *self, GaugeModel *model)
+{
+  g_return_if_fail(GAUGE_IS_WIDGET(self));
+  g_return_if_fail(model == NULL || GAUGE_IS_MODEL(model));
+
+  if (model == self->model)
+    return;
+
+  if (self->model != NULL) {
+    g_clear_signal_handler(&self->model_changed_id, self->model);
+    g_clear_object(&self->model);
+  }
+
+  if (model != NULL) {
+    self->model = g_object_ref(model);
+    self->model_changed_id = g_signal_connect(model, "changed",
+                                              G_CALLBACK(gauge_widget_on_model_changed), self);
+
+    gauge_widget_set_range(self, gauge_model_get_min(model), gauge_model_get_max(model));
+    gauge_widget_set_value_instant(self, gauge_model_get_value(model));
+    gauge_widget_set_alarm(self, gauge_model_get_alarm(model));
+  } else {
+    gauge_widget_set_alarm(self, GAUGE_ALARM_NONE);
+  }
+
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MODEL]);
+}
+
+GaugeModel *
+gauge_widget_get_model(GaugeWidget *self)
+{
+  g_return_val_if_fail(GAUGE_IS_WIDGET(self), NULL);
+  return self->model;
 }
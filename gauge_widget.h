@@ -1,9 +1,21 @@
 #pragma once
 #include <gtk/gtk.h>
+#include "gauge_model.h"
+#include "perf_stats.h"
+#include "quality_governor.h"
 
 G_BEGIN_DECLS
 
 #define GAUGE_TYPE_WIDGET (gauge_widget_get_type())
+#define GAUGE_TYPE_ANIMATION_MODE (gauge_animation_mode_get_type())
+
+/* How the needle moves towards a new value */
+typedef enum {
+  GAUGE_ANIMATION_EASE,    /* restart an ease-out curve on every set */
+  GAUGE_ANIMATION_FOLLOW,  /* critically damped follower, for high-rate input */
+} GaugeAnimationMode;
+
+GType gauge_animation_mode_get_type(void);
 
 /* Declare a final type: GaugeWidget extends GtkWidget */
 G_DECLARE_FINAL_TYPE(GaugeWidget, gauge_widget, GAUGE, WIDGET, GtkWidget)
@@ -12,9 +24,34 @@ G_DECLARE_FINAL_TYPE(GaugeWidget, gauge_widget, GAUGE, WIDGET, GtkWidget)
 GtkWidget *gauge_widget_new(void);
 
 void       gauge_widget_set_range(GaugeWidget *self, double min, double max);
+void       gauge_widget_get_range(GaugeWidget *self, double *min, double *max);
 void       gauge_widget_set_value(GaugeWidget *self, double value);
+void       gauge_widget_set_value_instant(GaugeWidget *self, double value);
 double     gauge_widget_get_value(GaugeWidget *self);
 void       gauge_widget_set_show_digital(GaugeWidget *self, gboolean show);
 gboolean   gauge_widget_get_show_digital(GaugeWidget *self);
+void       gauge_widget_set_animation_mode(GaugeWidget *self, GaugeAnimationMode mode);
+GaugeAnimationMode gauge_widget_get_animation_mode(GaugeWidget *self);
+
+/* Fixed rendering detail, or GAUGE_DETAIL_AUTO (the default) to follow
+ * quality_governor_get_level() */
+void       gauge_widget_set_quality(GaugeWidget *self, GaugeDetail quality);
+GaugeDetail gauge_widget_get_quality(GaugeWidget *self);
+
+/* Frame the gauge in the colour of its worst alarm; NONE removes it */
+void       gauge_widget_set_alarm(GaugeWidget *self, GaugeAlarm alarm);
+GaugeAlarm gauge_widget_get_alarm(GaugeWidget *self);
+
+/* Follow @model's range and value (the gauge keeps a reference); NULL unbinds */
+void        gauge_widget_set_model(GaugeWidget *self, GaugeModel *model);
+GaugeModel *gauge_widget_get_model(GaugeWidget *self);
+
+/* Drop the dial, needle and readout caches, e.g. while the gauge's page
+ * is hidden */
+void       gauge_widget_release_caches(GaugeWidget *self);
+
+/* Rendering cost counters of this gauge */
+void       gauge_widget_get_stats(GaugeWidget *self, GaugeStats *stats);
+gboolean   gauge_widget_is_animating(GaugeWidget *self);
 
 G_END_DECLS
@@ -0,0 +1,107 @@
+#include "lazy_page.h"
+#include "page_signals.h"
+#include "startup_trace.h"
+
+struct _LazyPage {
+  GtkWidget parent_instance;
+
+  LazyPageFactory factory;
+  gpointer        factory_data;
+  GtkWidget      *child;          /* real page, NULL until first needed */
+};
+
+G_DEFINE_FINAL_TYPE (LazyPage, lazy_page, GTK_TYPE_WIDGET)
+
+/* --- Page signals --- */
+static void
+on_page_activated (LazyPage *self, gpointer user_data)
+{
+  GtkWidget *child = lazy_page_ensure_child (self);
+
+  if (child != NULL)
+    g_signal_emit_by_name (child, "activated");
+}
+
+static void
+on_page_deactivated (LazyPage *self, gpointer user_data)
+{
+  if (self->child != NULL)
+    g_signal_emit_by_name (self->child, "deactivated");
+}
+
+/* --- Class/init --- */
+static void
+lazy_page_dispose (GObject *object)
+{
+  LazyPage *self = LAZY_PAGE (object);
+
+  g_clear_pointer (&self->child, gtk_widget_unparent);
+
+  G_OBJECT_CLASS (lazy_page_parent_class)->dispose (object);
+}
+
+static void
+lazy_page_class_init (LazyPageClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
+
+  object_class->dispose = lazy_page_dispose;
+
+  gtk_widget_class_set_layout_manager_type (widget_class, GTK_TYPE_BIN_LAYOUT);
+
+  register_page_signals (G_TYPE_FROM_CLASS (klass));
+}
+
+static void
+lazy_page_init (LazyPage *self)
+{
+  self->factory      = NULL;
+  self->factory_data = NULL;
+  self->child        = NULL;
+
+  /* Take the space the real page will take */
+  gtk_widget_set_hexpand (GTK_WIDGET (self), TRUE);
+  gtk_widget_set_vexpand (GTK_WIDGET (self), TRUE);
+
+  g_signal_connect (self, "activated",   G_CALLBACK (on_page_activated),   NULL);
+  g_signal_connect (self, "deactivated", G_CALLBACK (on_page_deactivated), NULL);
+}
+
+/* --- Public API --- */
+void
+lazy_page_set_factory (LazyPage *self, LazyPageFactory factory, gpointer user_data)
+{
+  g_return_if_fail (LAZY_IS_PAGE (self));
+  g_return_if_fail (self->child == NULL);
+
+  self->factory      = factory;
+  self->factory_data = user_data;
+}
+
+GtkWidget *
+lazy_page_ensure_child (LazyPage *self)
+{
+  g_return_val_if_fail (LAZY_IS_PAGE (self), NULL);
+
+  if (self->child != NULL || self->factory == NULL)
+    return self->child;
+
+  self->child = self->factory (self->factory_data);
+  g_return_val_if_fail (GTK_IS_WIDGET (self->child), NULL);
+
+  gtk_widget_set_parent (self->child, GTK_WIDGET (self));
+
+  g_autofree char *phase = g_strdup_printf ("%s built", G_OBJECT_TYPE_NAME (self->child));
+  startup_trace_mark (phase);
+
+  return self->child;
+}
+
+GtkWidget *
+lazy_page_get_child (LazyPage *self)
+{
+  g_return_val_if_fail (LAZY_IS_PAGE (self), NULL);
+
+  return self->child;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define LAZY_TYPE_PAGE (lazy_page_get_type())
+
+/* Builds the real page */
+typedef GtkWidget *(*LazyPageFactory) (gpointer user_data);
+
+/* Placeholder for a stack page that is expensive to build. The real page
+ * is created by the factory on the first "activated" and then receives
+ * this and every later "activated"/"deactivated". */
+G_DECLARE_FINAL_TYPE (LazyPage, lazy_page, LAZY, PAGE, GtkWidget)
+
+void       lazy_page_set_factory (LazyPage        *self,
+                                  LazyPageFactory  factory,
+                                  gpointer         user_data);
+
+/* The real page, built now if it was not yet */
+GtkWidget *lazy_page_ensure_child (LazyPage *self);
+
+/* The real page, or NULL while it has not been needed */
+GtkWidget *lazy_page_get_child (LazyPage *self);
+
+G_END_DECLS
@@ -3,6 +3,7 @@
 #include <glib/gi18n.h>
 
 #include "ensure.h"
+#include "startup_trace.h"
 #include "your_app.h"
 
 int
@@ -11,11 +12,14 @@ main (int argc, char *argv[])
   g_autoptr(YourAppApplication) app = NULL;
   int ret;
 
+  startup_trace_mark ("main");
+
   bindtextdomain (GETTEXT_PACKAGE, LOCALEDIR);
   bind_textdomain_codeset (GETTEXT_PACKAGE, "UTF-8");
   textdomain (GETTEXT_PACKAGE);
 
   ensure_types();
+  startup_trace_mark ("types registered");
 
   app = your_app_application_new ("org.gnome.Example", G_APPLICATION_DEFAULT_FLAGS);
   ret = g_application_run (G_APPLICATION (app), argc, argv);
@@ -2,7 +2,12 @@
 #include "ensure.h"
 #include "gauge_widget.h"
 #include "dashboard_page.h"
+#include "gauge_grid_page.h"
+#include "lazy_page.h"
 #include "preferences_page.h"
+#include "perf_stats.h"
+#include "quality_governor.h"
+#include "startup_trace.h"
 
 struct _MainWindow {
   AdwApplicationWindow parent_instance;
@@ -11,8 +16,12 @@ struct _MainWindow {
   GtkListBox          *left_menu_selector;
   AdwOverlaySplitView *split_view;
   AdwViewStack        *main_stack;
+  DashboardPage       *dashboard_page;
+  LazyPage            *gauge_grid_page;
+  LazyPage            *preferences_page;
 
   GObject             *current_page;
+  guint                perf_stats_timer; /* publishes win.perf-stats while the HUD is shown */
 };
 
 G_DEFINE_FINAL_TYPE (MainWindow, main_window, ADW_TYPE_APPLICATION_WINDOW)
@@ -33,6 +42,14 @@ show_dashboard (GSimpleAction *action, GVariant *parameter, gpointer user_data)
   adw_view_stack_set_visible_child_name (self->main_stack, "dashboard");
 }
 
+/* Switch to the gauge grid page */
+static void
+show_gauge_grid (GSimpleAction *action, GVariant *parameter, gpointer user_data)
+{
+  MainWindow *self = MAIN_WINDOW (user_data);
+  adw_view_stack_set_visible_child_name (self->main_stack, "gauges");
+}
+
 /* Switch to Preferences page */
 static void
 show_preferences (GSimpleAction *action, GVariant *parameter, gpointer user_data)
@@ -41,16 +58,95 @@ show_preferences (GSimpleAction *action, GVariant *parameter, gpointer user_data
   adw_view_stack_set_visible_child_name (self->main_stack, "preferences");
 }
 
+/* --- Performance counters --- */
+static gboolean
+publish_perf_stats (gpointer user_data)
+{
+  MainWindow *self = MAIN_WINDOW (user_data);
+  GAction *action = g_action_map_lookup_action (G_ACTION_MAP (self), "perf-stats");
+
+  g_simple_action_set_state (G_SIMPLE_ACTION (action), perf_stats_to_variant ());
+  return G_SOURCE_CONTINUE;
+}
+
+/* Show or hide the performance overlay on the dashboard. win.perf-stats
+ * is republished every second only while it is shown. */
+static void
+show_perf_hud (GSimpleAction *action, GVariant *state, gpointer user_data)
+{
+  MainWindow *self = MAIN_WINDOW (user_data);
+  gboolean visible = g_variant_get_boolean (state);
+
+  g_simple_action_set_state (action, state);
+  dashboard_page_set_hud_visible (self->dashboard_page, visible);
+
+  if (visible && self->perf_stats_timer == 0)
+  {
+    publish_perf_stats (self);
+    self->perf_stats_timer = g_timeout_add_seconds (1, publish_perf_stats, self);
+  }
+  else if (!visible)
+  {
+    g_clear_handle_id (&self->perf_stats_timer, g_source_remove);
+  }
+}
+
+/* win.perf-stats is read-only: asking to change it republishes the
+ * current counters instead, which is how scripts refresh it while the
+ * HUD is hidden */
+static void
+perf_stats_change_state (GSimpleAction *action, GVariant *state, gpointer user_data)
+{
+  g_simple_action_set_state (action, perf_stats_to_variant ());
+}
+
 static const GActionEntry win_actions[] = {
   { "show-dashboard",   show_dashboard   },
+  { "show-gauge-grid",  show_gauge_grid  },
   { "show-preferences", show_preferences },
+  { "show-perf-hud",    NULL, NULL, "false",   show_perf_hud },
+  { "perf-stats",       NULL, NULL, "@a{sv} {}", perf_stats_change_state },
 };
 
+static void
+on_window_realize (GtkWidget *widget, gpointer user_data)
+{
+  perf_stats_attach_frame_clock (gtk_widget_get_frame_clock (widget));
+  quality_governor_attach_frame_clock (gtk_widget_get_frame_clock (widget));
+  startup_trace_watch_first_frame (gtk_widget_get_frame_clock (widget));
+}
+
+/* --- Lazy pages --- */
+static GtkWidget *
+create_gauge_grid_page (gpointer user_data)
+{
+  return g_object_new (GAUGE_TYPE_GRID_PAGE, NULL);
+}
+
+static GtkWidget *
+create_preferences_page (gpointer user_data)
+{
+  return g_object_new (PREFERENCES_TYPE_PAGE, NULL);
+}
+
+static void
+main_window_dispose (GObject *object)
+{
+  MainWindow *self = MAIN_WINDOW (object);
+
+  g_clear_handle_id (&self->perf_stats_timer, g_source_remove);
+
+  G_OBJECT_CLASS (main_window_parent_class)->dispose (object);
+}
+
 static void
 main_window_class_init (MainWindowClass *klass)
 {
+  GObjectClass   *object_class = G_OBJECT_CLASS (klass);
   GtkWidgetClass *widget_class = GTK_WIDGET_CLASS (klass);
 
+  object_class->dispose = main_window_dispose;
+
   /* Ensure custom page types are registered before template instantiation */
   gtk_widget_class_set_template_from_resource (widget_class, "/org/gnome/Example/main_window.ui");
 
@@ -58,6 +154,9 @@ main_window_class_init (MainWindowClass *klass)
   gtk_widget_class_bind_template_child (widget_class, MainWindow, left_menu_selector);
   gtk_widget_class_bind_template_child (widget_class, MainWindow, split_view);
   gtk_widget_class_bind_template_child (widget_class, MainWindow, main_stack);
+  gtk_widget_class_bind_template_child (widget_class, MainWindow, dashboard_page);
+  gtk_widget_class_bind_template_child (widget_class, MainWindow, gauge_grid_page);
+  gtk_widget_class_bind_template_child (widget_class, MainWindow, preferences_page);
 
   gtk_widget_class_bind_template_callback (widget_class, toggle_sidebar);
 }
@@ -85,6 +184,11 @@ static void
 main_window_init (MainWindow *self)
 {
   gtk_widget_init_template (GTK_WIDGET (self));
+  startup_trace_mark ("window template inflated");
+
+  /* Only the start page is built up front; the others on first visit */
+  lazy_page_set_factory (self->gauge_grid_page, create_gauge_grid_page, NULL);
+  lazy_page_set_factory (self->preferences_page, create_preferences_page, NULL);
 
   g_signal_connect (self->main_stack, "notify::visible-child", G_CALLBACK (on_stack_visible_child), self);
 
@@ -94,6 +198,8 @@ main_window_init (MainWindow *self)
       G_N_ELEMENTS (win_actions),
       self);
 
+  g_signal_connect (self, "realize", G_CALLBACK (on_window_realize), NULL);
+
   /* Start on the dashboard page */
   // adw_view_stack_set_visible_child_name (self->main_stack, "dashboard");
   GtkListBoxRow *row = gtk_list_box_get_row_at_index (self->left_menu_selector, 0);
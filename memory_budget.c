@@ -0,0 +1,187 @@
+#include "memory_budget.h"
+#include "dial_cache.h"
+#include <gio/gio.h>
+
+#define MEMORY_BUDGET_DEFAULT_LIMIT (256 * 1024 * 1024)
+
+struct _MemoryBudgetClient {
+  char                *name;
+  MemoryBudgetSizeFunc size;
+  MemoryBudgetTrimFunc trim;
+  gpointer             user_data;
+  gboolean             active;
+  GList                link;      /* in clients, embedded */
+};
+
+/* Process-wide; head = least recently active */
+static GQueue          clients = G_QUEUE_INIT;
+static gsize           limit   = MEMORY_BUDGET_DEFAULT_LIMIT;
+static GMemoryMonitor *monitor = NULL;
+
+/* --- Helpers --- */
+static gsize
+dial_cache_bytes(void)
+{
+  DialCacheStats stats;
+
+  dial_cache_get_stats(&stats);
+  return stats.bytes;
+}
+
+static gsize
+client_bytes(MemoryBudgetClient *client)
+{
+  return client->size ? client->size(client->user_data) : 0;
+}
+
+static void
+touch(MemoryBudgetClient *client)
+{
+  g_queue_unlink(&clients, &client->link);
+  g_queue_push_tail_link(&clients, &client->link);
+}
+
+static void
+enforce(void)
+{
+  if (limit > 0)
+    memory_budget_trim_to(limit);
+}
+
+/* --- Clients --- */
+MemoryBudgetClient *
+memory_budget_register(const char          *name,
+                       MemoryBudgetSizeFunc size,
+                       MemoryBudgetTrimFunc trim,
+                       gpointer             user_data)
+{
+  g_return_val_if_fail(name != NULL, NULL);
+  g_return_val_if_fail(trim != NULL, NULL);
+
+  MemoryBudgetClient *client = g_new0(MemoryBudgetClient, 1);
+  client->name      = g_strdup(name);
+  client->size      = size;
+  client->trim      = trim;
+  client->user_data = user_data;
+  client->active    = FALSE;
+  client->link.data = client;
+
+  /* Never active yet: first in line for eviction */
+  g_queue_push_head_link(&clients, &client->link);
+
+  return client;
+}
+
+void
+memory_budget_unregister(MemoryBudgetClient *client)
+{
+  g_return_if_fail(client != NULL);
+
+  g_queue_unlink(&clients, &client->link);
+  g_free(client->name);
+  g_free(client);
+}
+
+void
+memory_budget_set_active(MemoryBudgetClient *client, gboolean active)
+{
+  g_return_if_fail(client != NULL);
+
+  client->active = !!active;
+
+  /* Leaving counts as use, so the page left last is evicted last */
+  touch(client);
+
+  if (!client->active) {
+    client->trim(MEMORY_TRIM_HIDDEN, client->user_data);
+    enforce();
+  }
+}
+
+/* --- Budget --- */
+void
+memory_budget_set_limit(gsize bytes)
+{
+  limit = bytes;
+  enforce();
+}
+
+gsize
+memory_budget_get_limit(void)
+{
+  return limit;
+}
+
+gsize
+memory_budget_get_bytes(void)
+{
+  gsize total = dial_cache_bytes();
+
+  for (GList *l = clients.head; l != NULL; l = l->next)
+    total += client_bytes(l->data);
+
+  return total;
+}
+
+void
+memory_budget_trim_to(gsize target_bytes)
+{
+  gsize total = memory_budget_get_bytes();
+
+  if (total <= target_bytes)
+    return;
+
+  /* Unused dials first: they are shared, small to rebuild and nobody
+   * shows them */
+  const gsize dials = dial_cache_bytes();
+  dial_cache_trim(dials - MIN(dials, total - target_bytes));
+  total = total - dials + dial_cache_bytes();
+
+  for (GList *l = clients.head; l != NULL && total > target_bytes; l = l->next) {
+    MemoryBudgetClient *client = l->data;
+
+    if (client->active)
+      continue;
+
+    const gsize before = client_bytes(client);
+    client->trim(MEMORY_TRIM_EVICT, client->user_data);
+    const gsize after = client_bytes(client);
+
+    total -= before - MIN(before, after);
+    if (before > after)
+      g_debug("Memory budget: evicted %" G_GSIZE_FORMAT " bytes of %s",
+              before - after, client->name);
+  }
+}
+
+/* --- Memory pressure --- */
+static void
+on_low_memory_warning(GMemoryMonitor *memory_monitor,
+                      GMemoryMonitorWarningLevel level,
+                      gpointer user_data)
+{
+  if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_CRITICAL) {
+    /* Drop everything that can be dropped, and what is on screen gets
+     * rebuilt as it is drawn */
+    memory_budget_trim_to(0);
+    for (GList *l = clients.head; l != NULL; l = l->next) {
+      MemoryBudgetClient *client = l->data;
+      if (client->active)
+        client->trim(MEMORY_TRIM_HIDDEN, client->user_data);
+    }
+  } else if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM) {
+    memory_budget_trim_to(0);
+  } else {
+    memory_budget_trim_to(limit / 2);
+  }
+}
+
+void
+memory_budget_watch_memory_monitor(void)
+{
+  if (monitor != NULL)
+    return;
+
+  monitor = g_memory_monitor_dup_default();
+  g_signal_connect(monitor, "low-memory-warning", G_CALLBACK(on_low_memory_warning), NULL);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* How much a client should let go of */
+typedef enum {
+  MEMORY_TRIM_HIDDEN,  /* not on screen: drop what is cheap to rebuild */
+  MEMORY_TRIM_EVICT,   /* over budget or low on memory: drop all it can,
+                        * history included */
+} MemoryTrimLevel;
+
+/* Bytes the client currently holds in droppable memory */
+typedef gsize (*MemoryBudgetSizeFunc)(gpointer user_data);
+typedef void  (*MemoryBudgetTrimFunc)(MemoryTrimLevel level, gpointer user_data);
+
+/* A page or other owner of caches. Clients are kept in least recently
+ * active order; over budget, inactive clients are evicted oldest first.
+ * Main thread only, like the widgets owning the caches. */
+typedef struct _MemoryBudgetClient MemoryBudgetClient;
+
+MemoryBudgetClient *memory_budget_register(const char          *name,
+                                           MemoryBudgetSizeFunc size,
+                                           MemoryBudgetTrimFunc trim,
+                                           gpointer             user_data);
+void                memory_budget_unregister(MemoryBudgetClient *client);
+
+/* Driven by the page "activated"/"deactivated" signals. Deactivating
+ * trims the client with MEMORY_TRIM_HIDDEN and enforces the budget. */
+void  memory_budget_set_active(MemoryBudgetClient *client, gboolean active);
+
+/* Budget over all clients plus the dial cache; 0 disables it */
+void  memory_budget_set_limit(gsize bytes);
+gsize memory_budget_get_limit(void);
+gsize memory_budget_get_bytes(void);
+
+/* Trim the unused dials, then inactive clients least recently active
+ * first, until within @target_bytes */
+void  memory_budget_trim_to(gsize target_bytes);
+
+/* Follow low-memory warnings of the default GMemoryMonitor */
+void  memory_budget_watch_memory_monitor(void);
+
+G_END_DECLS
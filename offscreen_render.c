@@ -0,0 +1,106 @@
+#include "offscreen_render.h"
+
+struct _OffscreenRender {
+  GtkWindow   *window;
+  GtkWidget   *content;
+  GskRenderer *renderer;
+  int          width;
+  int          height;
+};
+
+OffscreenRender *
+offscreen_render_new(GtkWidget *content, int width, int height, GError **error)
+{
+  g_return_val_if_fail(GTK_IS_WIDGET(content), NULL);
+
+  GskRenderer *renderer = gsk_cairo_renderer_new();
+  if (!gsk_renderer_realize(renderer, NULL, error)) {
+    g_object_unref(renderer);
+    return NULL;
+  }
+
+  OffscreenRender *self = g_new0(OffscreenRender, 1);
+  self->renderer = renderer;
+  self->content  = content;
+  self->window   = GTK_WINDOW(gtk_window_new());
+  gtk_window_set_child(self->window, content);
+
+  /* Realize the window (a surface and frame clock, never shown) and map
+   * the content under it, so widgets behave as if they were on screen */
+  gtk_widget_realize(GTK_WIDGET(self->window));
+  gtk_widget_map(content);
+
+  int min, nat;
+  gtk_widget_measure(content, GTK_ORIENTATION_HORIZONTAL, -1, &min, &nat, NULL, NULL);
+  self->width = width > 0 ? MAX(width, min) : nat;
+  gtk_widget_measure(content, GTK_ORIENTATION_VERTICAL, self->width, &min, &nat, NULL, NULL);
+  self->height = height > 0 ? MAX(height, min) : nat;
+
+  gtk_widget_size_allocate(content,
+                           &(GtkAllocation) { 0, 0, self->width, self->height },
+                           -1);
+
+  return self;
+}
+
+void
+offscreen_render_free(OffscreenRender *self)
+{
+  if (self == NULL)
+    return;
+
+  gtk_widget_unmap(self->content);
+  gtk_window_destroy(self->window);
+
+  gsk_renderer_unrealize(self->renderer);
+  g_object_unref(self->renderer);
+  g_free(self);
+}
+
+GtkWidget *
+offscreen_render_get_content(OffscreenRender *self)
+{
+  return self->content;
+}
+
+GdkFrameClock *
+offscreen_render_get_frame_clock(OffscreenRender *self)
+{
+  return gtk_widget_get_frame_clock(GTK_WIDGET(self->window));
+}
+
+int
+offscreen_render_get_width(OffscreenRender *self)
+{
+  return self->width;
+}
+
+int
+offscreen_render_get_height(OffscreenRender *self)
+{
+  return self->height;
+}
+
+GskRenderNode *
+offscreen_render_snapshot(OffscreenRender *self)
+{
+  GtkSnapshot *snapshot = gtk_snapshot_new();
+
+  /* Pick up queued resizes, e.g. list rows created by scrolling */
+  gtk_widget_size_allocate(self->content,
+                           &(GtkAllocation) { 0, 0, self->width, self->height },
+                           -1);
+
+  gtk_widget_snapshot_child(GTK_WIDGET(self->window), self->content, snapshot);
+  return gtk_snapshot_free_to_node(snapshot);
+}
+
+GdkTexture *
+offscreen_render_render(OffscreenRender *self, GskRenderNode *node)
+{
+  if (node == NULL)
+    return NULL;
+
+  return gsk_renderer_render_texture(self->renderer, node,
+                                     &GRAPHENE_RECT_INIT(0, 0, self->width, self->height));
+}
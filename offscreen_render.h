@@ -0,0 +1,29 @@
+#pragma once
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* Hosts a widget tree in a realized but never presented window and
+ * renders it with the software (cairo) GskRenderer. Nothing appears on
+ * screen; GTK still needs a display connection (e.g. GDK_BACKEND=broadway
+ * or a virtual X server on headless machines). */
+typedef struct _OffscreenRender OffscreenRender;
+
+/* Takes a floating/owned reference to @content. A width or height <= 0
+ * uses the tree's natural size. */
+OffscreenRender *offscreen_render_new(GtkWidget *content, int width, int height, GError **error);
+void             offscreen_render_free(OffscreenRender *self);
+
+GtkWidget       *offscreen_render_get_content(OffscreenRender *self);
+GdkFrameClock   *offscreen_render_get_frame_clock(OffscreenRender *self);
+int              offscreen_render_get_width(OffscreenRender *self);
+int              offscreen_render_get_height(OffscreenRender *self);
+
+/* Snapshot the whole tree. Widgets that did not queue a draw since the
+ * previous snapshot reuse their cached render nodes, as in a real frame. */
+GskRenderNode   *offscreen_render_snapshot(OffscreenRender *self);
+
+/* Rasterize @node to a texture of the content size */
+GdkTexture      *offscreen_render_render(OffscreenRender *self, GskRenderNode *node);
+
+G_END_DECLS
@@ -0,0 +1,103 @@
+#include "page_telemetry.h"
+#include "gauge_model.h"
+
+void
+page_telemetry_init(PageTelemetry *self, GPtrArray *channels)
+{
+  self->source         = NULL;
+  self->scheduler      = NULL;
+  self->alarms         = NULL;
+  self->alarms_handler = 0;
+  self->channels       = channels;
+}
+
+void
+page_telemetry_clear(PageTelemetry *self)
+{
+  if (self->alarms != NULL)
+    g_clear_signal_handler(&self->alarms_handler, self->alarms);
+
+  g_clear_object(&self->source);
+  g_clear_object(&self->scheduler);
+  g_clear_object(&self->alarms);
+}
+
+YourAppApplication *
+page_telemetry_lookup_application(GtkWidget *page)
+{
+  GtkRoot *root = gtk_widget_get_root(page);
+  GtkApplication *app = GTK_IS_WINDOW(root) ? gtk_window_get_application(GTK_WINDOW(root)) : NULL;
+
+  return YOUR_APP_IS_APPLICATION(app) ? YOUR_APP_APPLICATION(app) : NULL;
+}
+
+/* --- Alarms --- */
+
+/* Like samples, alarms land on every model, shown or not */
+static void
+on_alarm_transitions(AlarmEngine           *engine,
+                     const AlarmTransition *transitions,
+                     guint                  n_transitions,
+                     PageTelemetry         *self)
+{
+  gauge_model_begin_batch();
+  for (guint i = 0; i < n_transitions; i++) {
+    GaugeModel *model;
+
+    if (transitions[i].channel < self->channels->len &&
+        (model = g_ptr_array_index(self->channels, transitions[i].channel)) != NULL)
+      gauge_model_set_alarm(model, transitions[i].new_alarm);
+  }
+  gauge_model_end_batch();
+}
+
+/* Transitions only report changes: catch up on alarms raised before us */
+static void
+connect_alarms(PageTelemetry *self, AlarmEngine *engine)
+{
+  self->alarms = g_object_ref(engine);
+  self->alarms_handler = g_signal_connect(engine, "transitions",
+                                          G_CALLBACK(on_alarm_transitions), self);
+
+  gauge_model_begin_batch();
+  for (guint i = 0; i < self->channels->len; i++) {
+    GaugeModel *model = g_ptr_array_index(self->channels, i);
+
+    if (model != NULL)
+      gauge_model_set_alarm(model, alarm_engine_get_alarm(engine, i));
+  }
+  gauge_model_end_batch();
+}
+
+/* --- Wiring --- */
+void
+page_telemetry_connect(PageTelemetry *self, YourAppApplication *app)
+{
+  if (self->source == NULL) {
+    TelemetrySource *source = your_app_application_get_telemetry_source(app);
+    UpdateScheduler *scheduler = your_app_application_get_update_scheduler(app);
+
+    if (source)
+      self->source = g_object_ref(source);
+    if (source && scheduler)
+      self->scheduler = g_object_ref(scheduler);
+  }
+
+  if (self->alarms == NULL) {
+    AlarmEngine *engine = your_app_application_get_alarm_engine(app);
+    if (engine)
+      connect_alarms(self, engine);
+  }
+}
+
+void
+page_telemetry_drain(PageTelemetry *self, TelemetrySampleFunc func, gpointer user_data)
+{
+  if (self->scheduler != NULL) {
+    update_scheduler_drain(self->scheduler, self->source, func, user_data);
+  } else {
+    gauge_model_begin_batch();
+    telemetry_source_drain(self->source, func, user_data);
+    gauge_model_end_batch();
+  }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <gtk/gtk.h>
+#include "your_app.h"
+
+G_BEGIN_DECLS
+
+/* The live data wiring shared by the pages that show channels: the
+ * application's telemetry source, its update scheduler and its alarm
+ * engine, feeding one GaugeModel per channel. Embedded in the page;
+ * main thread only. */
+typedef struct {
+  TelemetrySource *source;          /* application's live data source, if any */
+  UpdateScheduler *scheduler;       /* paces the source into the models */
+  AlarmEngine     *alarms;          /* application's alarm engine, if any */
+  gulong           alarms_handler;
+  GPtrArray       *channels;        /* channel → GaugeModel or NULL, not owned */
+} PageTelemetry;
+
+/* @channels belongs to the page and must outlive page_telemetry_clear() */
+void                page_telemetry_init(PageTelemetry *self, GPtrArray *channels);
+void                page_telemetry_clear(PageTelemetry *self);
+
+/* The application of @page's window; NULL until the window is shown */
+YourAppApplication *page_telemetry_lookup_application(GtkWidget *page);
+
+/* Takes whatever of the source, scheduler and alarm engine @app has and
+ * was not taken before. Alarm transitions land on the channels' models,
+ * and alarms raised before connecting are caught up on. */
+void                page_telemetry_connect(PageTelemetry *self, YourAppApplication *app);
+
+/* Once per frame: drain the source through @func, paced by the scheduler
+ * if there is one, otherwise in one model batch */
+void                page_telemetry_drain(PageTelemetry      *self,
+                                         TelemetrySampleFunc func,
+                                         gpointer            user_data);
+
+G_END_DECLS
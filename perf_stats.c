@@ -0,0 +1,227 @@
+#include "perf_stats.h"
+#include "dial_cache.h"
+#include "memory_budget.h"
+#include "quality_governor.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* All counters live on the main thread, like the widgets feeding them */
+static GaugeStats     gauge_totals;
+static guint          active_animations;
+
+static GdkFrameClock *frame_clock;   /* weak */
+static gulong         after_paint_id;
+static guint64        frames;
+static gint64         last_frame_time;
+static double         interval_ms[PERF_FRAME_HISTORY];
+static double         paint_ms[PERF_FRAME_HISTORY];
+static guint          n_history;     /* valid entries, up to PERF_FRAME_HISTORY */
+
+/* --- Hot path --- */
+void
+perf_stats_record_snapshot(gint64 us)
+{
+  gauge_totals.snapshots++;
+  gauge_totals.snapshot_us += us;
+}
+
+void
+perf_stats_record_dial_rebuild(void)
+{
+  gauge_totals.dial_rebuilds++;
+}
+
+void
+perf_stats_record_anim_step(gint64 us)
+{
+  gauge_totals.anim_steps++;
+  gauge_totals.anim_us += us;
+}
+
+void
+perf_stats_animation_started(void)
+{
+  active_animations++;
+}
+
+void
+perf_stats_animation_stopped(void)
+{
+  if (active_animations > 0)
+    active_animations--;
+}
+
+void
+perf_stats_get_gauge_totals(GaugeStats *stats)
+{
+  *stats = gauge_totals;
+}
+
+guint
+perf_stats_get_active_animations(void)
+{
+  return active_animations;
+}
+
+/* --- Frame timings --- */
+static void
+on_after_paint(GdkFrameClock *clock, gpointer user_data)
+{
+  const gint64 frame_time = gdk_frame_clock_get_frame_time(clock);
+  const guint slot = frames % PERF_FRAME_HISTORY;
+
+  interval_ms[slot] = last_frame_time ? (frame_time - last_frame_time) / 1000.0 : 0.0;
+  paint_ms[slot]    = (g_get_monotonic_time() - frame_time) / 1000.0;
+
+  last_frame_time = frame_time;
+  frames++;
+  n_history = MIN(n_history + 1, PERF_FRAME_HISTORY);
+}
+
+static void
+on_frame_clock_finalized(gpointer data, GObject *where_the_object_was)
+{
+  frame_clock = NULL;
+  after_paint_id = 0;
+}
+
+void
+perf_stats_attach_frame_clock(GdkFrameClock *clock)
+{
+  if (clock == frame_clock)
+    return;
+
+  if (frame_clock != NULL) {
+    g_signal_handler_disconnect(frame_clock, after_paint_id);
+    g_object_weak_unref(G_OBJECT(frame_clock), on_frame_clock_finalized, NULL);
+  }
+
+  frame_clock = clock;
+  frames = 0;
+  last_frame_time = 0;
+  n_history = 0;
+
+  if (frame_clock != NULL) {
+    after_paint_id = g_signal_connect(frame_clock, "after-paint", G_CALLBACK(on_after_paint), NULL);
+    g_object_weak_ref(G_OBJECT(frame_clock), on_frame_clock_finalized, NULL);
+  }
+}
+
+static int
+compare_double(gconstpointer a, gconstpointer b)
+{
+  const double x = *(const double *)a;
+  const double y = *(const double *)b;
+  return (x > y) - (x < y);
+}
+
+/* Percentile of the first @n values of @src, without disturbing @src */
+static double
+history_percentile(const double *src, guint n, double p)
+{
+  double sorted[PERF_FRAME_HISTORY];
+
+  if (n == 0)
+    return 0.0;
+
+  memcpy(sorted, src, n * sizeof(double));
+  qsort(sorted, n, sizeof(double), compare_double);
+  return sorted[(guint)(p * (n - 1) + 0.5)];
+}
+
+void
+perf_stats_get_frame_stats(FrameStats *stats)
+{
+  stats->frames          = frames;
+  stats->fps             = frame_clock ? gdk_frame_clock_get_fps(frame_clock) : 0.0;
+  stats->interval_ms_p50 = history_percentile(interval_ms, n_history, 0.50);
+  stats->interval_ms_max = history_percentile(interval_ms, n_history, 1.00);
+  stats->paint_ms_p50    = history_percentile(paint_ms, n_history, 0.50);
+  stats->paint_ms_p99    = history_percentile(paint_ms, n_history, 0.99);
+  stats->paint_ms_max    = history_percentile(paint_ms, n_history, 1.00);
+}
+
+/* --- Reporting --- */
+GVariant *
+perf_stats_to_variant(void)
+{
+  FrameStats frame;
+  DialCacheStats cache;
+  GVariantDict dict;
+  guint quality_down, quality_up;
+
+  perf_stats_get_frame_stats(&frame);
+  dial_cache_get_stats(&cache);
+  quality_governor_get_steps(&quality_down, &quality_up);
+
+  g_variant_dict_init(&dict, NULL);
+  g_variant_dict_insert(&dict, "gauge-snapshots",     "t", gauge_totals.snapshots);
+  g_variant_dict_insert(&dict, "gauge-snapshot-us",   "x", gauge_totals.snapshot_us);
+  g_variant_dict_insert(&dict, "gauge-dial-rebuilds", "t", gauge_totals.dial_rebuilds);
+  g_variant_dict_insert(&dict, "gauge-anim-steps",    "t", gauge_totals.anim_steps);
+  g_variant_dict_insert(&dict, "gauge-anim-us",       "x", gauge_totals.anim_us);
+  g_variant_dict_insert(&dict, "active-animations",   "u", active_animations);
+  g_variant_dict_insert(&dict, "frames",              "t", frame.frames);
+  g_variant_dict_insert(&dict, "fps",                 "d", frame.fps);
+  g_variant_dict_insert(&dict, "frame-interval-ms-p50", "d", frame.interval_ms_p50);
+  g_variant_dict_insert(&dict, "frame-interval-ms-max", "d", frame.interval_ms_max);
+  g_variant_dict_insert(&dict, "frame-paint-ms-p50",  "d", frame.paint_ms_p50);
+  g_variant_dict_insert(&dict, "frame-paint-ms-p99",  "d", frame.paint_ms_p99);
+  g_variant_dict_insert(&dict, "frame-paint-ms-max",  "d", frame.paint_ms_max);
+  g_variant_dict_insert(&dict, "dial-cache-hits",     "t", cache.hits);
+  g_variant_dict_insert(&dict, "dial-cache-misses",   "t", cache.misses);
+  g_variant_dict_insert(&dict, "dial-cache-bytes",    "t", (guint64)cache.bytes);
+  g_variant_dict_insert(&dict, "cache-bytes",         "t", (guint64)memory_budget_get_bytes());
+  g_variant_dict_insert(&dict, "cache-budget-bytes",  "t", (guint64)memory_budget_get_limit());
+  g_variant_dict_insert(&dict, "quality-level",       "u", (guint32)quality_governor_get_level());
+  g_variant_dict_insert(&dict, "quality-steps-down",  "u", quality_down);
+  g_variant_dict_insert(&dict, "quality-steps-up",    "u", quality_up);
+
+  return g_variant_dict_end(&dict);
+}
+
+static const char *
+quality_nick(GaugeDetail quality)
+{
+  g_autoptr(GEnumClass) klass = g_type_class_ref(GAUGE_TYPE_DETAIL);
+  GEnumValue *value = g_enum_get_value(klass, quality);
+
+  /* Nicks are static strings, they outlive the class reference */
+  return value ? value->value_nick : "?";
+}
+
+char *
+perf_stats_format(void)
+{
+  FrameStats frame;
+  DialCacheStats cache;
+
+  perf_stats_get_frame_stats(&frame);
+  dial_cache_get_stats(&cache);
+
+  const double snapshot_avg = gauge_totals.snapshots
+                            ? (double)gauge_totals.snapshot_us / gauge_totals.snapshots : 0.0;
+  const double anim_avg = gauge_totals.anim_steps
+                        ? (double)gauge_totals.anim_us / gauge_totals.anim_steps : 0.0;
+
+  return g_strdup_printf("fps        %6.1f\n"
+                         "interval   %6.2f ms p50  %6.2f max\n"
+                         "paint      %6.2f ms p50  %6.2f p99  %6.2f max\n"
+                         "snapshots  %6" G_GUINT64_FORMAT "  avg %5.1f µs\n"
+                         "anim steps %6" G_GUINT64_FORMAT "  avg %5.1f µs\n"
+                         "animating  %6u\n"
+                         "rebuilds   %6" G_GUINT64_FORMAT "\n"
+                         "dial cache %6u entries  %" G_GUINT64_FORMAT "/%" G_GUINT64_FORMAT " hit/miss  %.1f MiB\n"
+                         "quality    %6s%s",
+                         frame.fps,
+                         frame.interval_ms_p50, frame.interval_ms_max,
+                         frame.paint_ms_p50, frame.paint_ms_p99, frame.paint_ms_max,
+                         gauge_totals.snapshots, snapshot_avg,
+                         gauge_totals.anim_steps, anim_avg,
+                         active_animations,
+                         gauge_totals.dial_rebuilds,
+                         cache.entries, cache.hits, cache.misses,
+                         cache.bytes / (1024.0 * 1024.0),
+                         quality_nick(quality_governor_get_level()),
+                         quality_governor_is_adaptive() ? "  (adaptive)" : "");
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* Rendering cost counters, kept per gauge and summed process-wide */
+typedef struct {
+  guint64 snapshots;      /* gauge_widget_snapshot() calls */
+  guint64 dial_rebuilds;  /* dials rasterized on a dial cache miss */
+  guint64 anim_steps;     /* animator updates of the needle */
+  gint64  snapshot_us;    /* time spent in gauge_widget_snapshot() */
+  gint64  anim_us;        /* time spent in animator updates */
+} GaugeStats;
+
+/* Window frame statistics over the last PERF_FRAME_HISTORY frames */
+#define PERF_FRAME_HISTORY 120
+
+typedef struct {
+  guint64 frames;             /* frames painted since attach */
+  double  fps;                /* as reported by the frame clock */
+  double  interval_ms_p50;    /* time between frame starts */
+  double  interval_ms_max;
+  double  paint_ms_p50;       /* frame start to end of paint */
+  double  paint_ms_p99;
+  double  paint_ms_max;
+} FrameStats;
+
+/* Hot-path recorders, called by GaugeWidget and the gauge animator */
+void perf_stats_record_snapshot(gint64 us);
+void perf_stats_record_dial_rebuild(void);
+void perf_stats_record_anim_step(gint64 us);
+void perf_stats_animation_started(void);
+void perf_stats_animation_stopped(void);
+
+void  perf_stats_get_gauge_totals(GaugeStats *stats);
+guint perf_stats_get_active_animations(void);
+
+/* Follow frame timings of @frame_clock (one clock at a time) */
+void perf_stats_attach_frame_clock(GdkFrameClock *frame_clock);
+void perf_stats_get_frame_stats(FrameStats *stats);
+
+/* Everything above plus the dial cache, as an a{sv} dictionary */
+GVariant *perf_stats_to_variant(void);
+
+/* Multi-line human-readable summary for the HUD */
+char *perf_stats_format(void);
+
+G_END_DECLS
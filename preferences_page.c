@@ -34,6 +34,16 @@ on_page_deactivated(GObject *stack, GParamSpec *pspec, gpointer user_data)
 {
 }
 
+/* Switch the whole application between the system's and a forced dark
+ * style. Widgets pick the change up through their CSS, gauges included. */
+static void
+on_dark_mode_changed(GtkSwitch *toggle, GParamSpec *pspec, gpointer user_data)
+{
+  adw_style_manager_set_color_scheme(adw_style_manager_get_default(),
+                                     gtk_switch_get_active(toggle) ? ADW_COLOR_SCHEME_FORCE_DARK
+                                                                   : ADW_COLOR_SCHEME_DEFAULT);
+}
+
 static void
 preferences_page_init (PreferencesPage *self)
 {
@@ -42,7 +52,9 @@ preferences_page_init (PreferencesPage *self)
   g_signal_connect (self, "activated", G_CALLBACK (on_page_activated), NULL);
   g_signal_connect (self, "deactivated", G_CALLBACK (on_page_deactivated), NULL);
 
-  /* Example: connect signal to dark_mode_switch */
+  gtk_switch_set_active (self->dark_mode_switch,
+                         adw_style_manager_get_color_scheme (adw_style_manager_get_default ())
+                         == ADW_COLOR_SCHEME_FORCE_DARK);
   g_signal_connect (self->dark_mode_switch, "notify::active",
-                    G_CALLBACK (gtk_widget_queue_draw), self);
+                    G_CALLBACK (on_dark_mode_changed), NULL);
 }
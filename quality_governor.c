@@ -0,0 +1,231 @@
+#include "quality_governor.h"
+
+/* Frames per decision */
+#define QUALITY_WINDOW                60
+/* A window with this many frames over the refresh interval steps down */
+#define QUALITY_OVERRUN_FRAMES        6
+/* Windows painting within half the interval before stepping up, and the
+ * cap it backs off to when a step up gets undone straight away */
+#define QUALITY_HEADROOM_WINDOWS      3
+#define QUALITY_MAX_HEADROOM_WINDOWS  48
+/* Refresh interval when the clock does not know one, µs */
+#define QUALITY_DEFAULT_INTERVAL_US   16667
+
+static const GaugeDetailFeatures level_features[] = {
+  [GAUGE_DETAIL_MINIMAL] = { CAIRO_ANTIALIAS_FAST, FALSE, FALSE, 2 },
+  [GAUGE_DETAIL_BASIC]   = { CAIRO_ANTIALIAS_FAST, FALSE, FALSE, 1 },
+  [GAUGE_DETAIL_FLAT]    = { CAIRO_ANTIALIAS_GOOD, FALSE, TRUE,  1 },
+  [GAUGE_DETAIL_REDUCED] = { CAIRO_ANTIALIAS_GOOD, TRUE,  TRUE,  1 },
+  [GAUGE_DETAIL_FULL]    = { CAIRO_ANTIALIAS_BEST, TRUE,  TRUE,  1 },
+};
+
+/* Main thread only, like the frame clock feeding it */
+static GdkFrameClock *frame_clock;     /* weak */
+static gulong         after_paint_id;
+static GaugeDetail    level    = GAUGE_DETAIL_FULL;
+static gboolean       adaptive = TRUE;
+static GHashTable    *watched;         /* GtkWidget set */
+
+static guint    window_frames;
+static guint    window_overruns;
+static gboolean window_headroom;       /* every frame within half the interval */
+static guint    headroom_windows;      /* consecutive windows with headroom */
+static guint    headroom_needed = QUALITY_HEADROOM_WINDOWS;
+static guint    windows_since_up = G_MAXUINT;
+static guint    steps_down;
+static guint    steps_up;
+
+GType
+gauge_detail_get_type(void)
+{
+  static gsize type_id = 0;
+
+  if (g_once_init_enter(&type_id)) {
+    static const GEnumValue values[] = {
+      { GAUGE_DETAIL_AUTO,    "GAUGE_DETAIL_AUTO",    "auto" },
+      { GAUGE_DETAIL_MINIMAL, "GAUGE_DETAIL_MINIMAL", "minimal" },
+      { GAUGE_DETAIL_BASIC,   "GAUGE_DETAIL_BASIC",   "basic" },
+      { GAUGE_DETAIL_FLAT,    "GAUGE_DETAIL_FLAT",    "flat" },
+      { GAUGE_DETAIL_REDUCED, "GAUGE_DETAIL_REDUCED", "reduced" },
+      { GAUGE_DETAIL_FULL,    "GAUGE_DETAIL_FULL",    "full" },
+      { 0, NULL, NULL }
+    };
+    GType type = g_enum_register_static(g_intern_static_string("GaugeDetail"), values);
+    g_once_init_leave(&type_id, type);
+  }
+
+  return type_id;
+}
+
+const GaugeDetailFeatures *
+gauge_detail_get_features(GaugeDetail quality)
+{
+  g_return_val_if_fail(quality >= GAUGE_DETAIL_MINIMAL && quality <= GAUGE_DETAIL_FULL,
+                       &level_features[GAUGE_DETAIL_FULL]);
+
+  return &level_features[quality];
+}
+
+/* --- Level --- */
+static void
+change_level(GaugeDetail new_level)
+{
+  GHashTableIter iter;
+  gpointer widget;
+
+  if (new_level == level)
+    return;
+
+  level = new_level;
+
+  /* Each widget rebuilds against the new level on its next snapshot */
+  if (watched == NULL)
+    return;
+  g_hash_table_iter_init(&iter, watched);
+  while (g_hash_table_iter_next(&iter, &widget, NULL))
+    gtk_widget_queue_draw(widget);
+}
+
+static void
+reset_window(void)
+{
+  window_frames   = 0;
+  window_overruns = 0;
+  window_headroom = TRUE;
+}
+
+/* Step down at once, step up only after sustained headroom. A step up
+ * that overruns right away doubles the wait before the next one, so a
+ * load sitting between two levels does not flip between them. */
+static void
+decide(void)
+{
+  if (windows_since_up < G_MAXUINT)
+    windows_since_up++;
+
+  if (window_overruns >= QUALITY_OVERRUN_FRAMES) {
+    headroom_windows = 0;
+    if (level > GAUGE_DETAIL_MINIMAL) {
+      if (windows_since_up <= 1)
+        headroom_needed = MIN(headroom_needed * 2, QUALITY_MAX_HEADROOM_WINDOWS);
+      steps_down++;
+      change_level(level - 1);
+    }
+  } else if (window_headroom) {
+    if (++headroom_windows >= headroom_needed && level < GAUGE_DETAIL_FULL) {
+      headroom_windows = 0;
+      windows_since_up = 0;
+      steps_up++;
+      change_level(level + 1);
+    }
+  } else {
+    headroom_windows = 0;
+  }
+}
+
+/* --- Frame timings --- */
+static void
+on_after_paint(GdkFrameClock *clock, gpointer user_data)
+{
+  const gint64 frame_time = gdk_frame_clock_get_frame_time(clock);
+  const gint64 paint_us = g_get_monotonic_time() - frame_time;
+  gint64 interval = 0;
+
+  if (!adaptive)
+    return;
+
+  gdk_frame_clock_get_refresh_info(clock, frame_time, &interval, NULL);
+  if (interval <= 0)
+    interval = QUALITY_DEFAULT_INTERVAL_US;
+
+  if (paint_us > interval)
+    window_overruns++;
+  if (paint_us * 2 > interval)
+    window_headroom = FALSE;
+
+  if (++window_frames == QUALITY_WINDOW) {
+    decide();
+    reset_window();
+  }
+}
+
+static void
+on_frame_clock_finalized(gpointer data, GObject *where_the_object_was)
+{
+  frame_clock = NULL;
+  after_paint_id = 0;
+}
+
+void
+quality_governor_attach_frame_clock(GdkFrameClock *clock)
+{
+  if (clock == frame_clock)
+    return;
+
+  if (frame_clock != NULL) {
+    g_signal_handler_disconnect(frame_clock, after_paint_id);
+    g_object_weak_unref(G_OBJECT(frame_clock), on_frame_clock_finalized, NULL);
+  }
+
+  frame_clock = clock;
+  reset_window();
+  headroom_windows = 0;
+
+  if (frame_clock != NULL) {
+    after_paint_id = g_signal_connect(frame_clock, "after-paint", G_CALLBACK(on_after_paint), NULL);
+    g_object_weak_ref(G_OBJECT(frame_clock), on_frame_clock_finalized, NULL);
+  }
+}
+
+/* --- Public API --- */
+GaugeDetail
+quality_governor_get_level(void)
+{
+  return level;
+}
+
+void
+quality_governor_set_level(GaugeDetail new_level, gboolean new_adaptive)
+{
+  g_return_if_fail(new_level >= GAUGE_DETAIL_MINIMAL && new_level <= GAUGE_DETAIL_FULL);
+
+  adaptive = new_adaptive;
+  reset_window();
+  headroom_windows = 0;
+  headroom_needed  = QUALITY_HEADROOM_WINDOWS;
+  change_level(new_level);
+}
+
+gboolean
+quality_governor_is_adaptive(void)
+{
+  return adaptive;
+}
+
+void
+quality_governor_get_steps(guint *down, guint *up)
+{
+  if (down)
+    *down = steps_down;
+  if (up)
+    *up = steps_up;
+}
+
+void
+quality_governor_watch(GtkWidget *widget)
+{
+  g_return_if_fail(GTK_IS_WIDGET(widget));
+
+  if (watched == NULL)
+    watched = g_hash_table_new(NULL, NULL);
+  g_hash_table_add(watched, widget);
+}
+
+void
+quality_governor_unwatch(GtkWidget *widget)
+{
+  g_return_if_fail(GTK_IS_WIDGET(widget));
+
+  if (watched != NULL)
+    g_hash_table_remove(watched, widget);
+}
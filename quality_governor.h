@@ -0,0 +1,52 @@
+#pragma once
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define GAUGE_TYPE_DETAIL (gauge_detail_get_type())
+
+/* Rendering detail, cheapest first. Each level drops one more thing than
+ * the level above it. */
+typedef enum {
+  GAUGE_DETAIL_AUTO,     /* whatever the governor currently picks */
+  GAUGE_DETAIL_MINIMAL,  /* needles move on every other frame */
+  GAUGE_DETAIL_BASIC,    /* major ticks only, fast antialiasing */
+  GAUGE_DETAIL_FLAT,     /* solid fills instead of gradients */
+  GAUGE_DETAIL_REDUCED,  /* good instead of best antialiasing */
+  GAUGE_DETAIL_FULL,
+} GaugeDetail;
+
+GType gauge_detail_get_type(void);
+
+/* What a level draws */
+typedef struct {
+  cairo_antialias_t antialias;
+  gboolean          gradients;
+  gboolean          minor_ticks;
+  guint             frame_divisor;  /* animate on every Nth frame */
+} GaugeDetailFeatures;
+
+/* @quality must not be AUTO */
+const GaugeDetailFeatures *gauge_detail_get_features(GaugeDetail quality);
+
+/* The governor watches how long frames of one clock take to paint. When
+ * they overrun the refresh interval it steps the level down; after a few
+ * seconds of ample headroom it steps back up. */
+void         quality_governor_attach_frame_clock(GdkFrameClock *frame_clock);
+
+/* Level AUTO gauges draw at, between MINIMAL and FULL */
+GaugeDetail  quality_governor_get_level(void);
+
+/* Pin the level; with @adaptive, the governor starts from @level and
+ * keeps adjusting it */
+void         quality_governor_set_level(GaugeDetail level, gboolean adaptive);
+gboolean     quality_governor_is_adaptive(void);
+
+/* Times the governor stepped down and up since start */
+void         quality_governor_get_steps(guint *down, guint *up);
+
+/* @widget is redrawn whenever the level changes; watch while mapped */
+void         quality_governor_watch(GtkWidget *widget);
+void         quality_governor_unwatch(GtkWidget *widget);
+
+G_END_DECLS
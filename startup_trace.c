@@ -0,0 +1,128 @@
+#include "startup_trace.h"
+
+#define STARTUP_TRACE_MAX_MARKS 64
+
+/* How often, and for how long after the paint, to look whether the
+ * first frame's presentation time came in */
+#define FIRST_FRAME_POLL_MS    5
+#define FIRST_FRAME_TIMEOUT_US G_USEC_PER_SEC
+
+typedef struct {
+  gint64  time;    /* monotonic µs */
+  char   *phase;
+} TraceMark;
+
+static TraceMark marks[STARTUP_TRACE_MAX_MARKS];
+static guint     n_marks;
+static gboolean  enabled;
+
+/* --- Output --- */
+static void
+print_mark(guint i)
+{
+  const double since_start = (marks[i].time - marks[0].time) / 1000.0;
+  const double since_prev  = i > 0 ? (marks[i].time - marks[i - 1].time) / 1000.0 : 0.0;
+
+  g_printerr("startup %9.3f ms  (+%8.3f)  %s\n", since_start, since_prev, marks[i].phase);
+}
+
+static void
+add_mark(const char *phase, gint64 time)
+{
+  /* Past the budget of marks: a trace, not a log */
+  if (n_marks == STARTUP_TRACE_MAX_MARKS)
+    return;
+
+  marks[n_marks].time  = time;
+  marks[n_marks].phase = g_strdup(phase);
+
+  if (enabled)
+    print_mark(n_marks);
+  n_marks++;
+}
+
+/* --- Public API --- */
+void
+startup_trace_mark(const char *phase)
+{
+  g_return_if_fail(phase != NULL);
+
+  add_mark(phase, g_get_monotonic_time());
+}
+
+void
+startup_trace_enable(void)
+{
+  if (enabled)
+    return;
+
+  enabled = TRUE;
+  for (guint i = 0; i < n_marks; i++)
+    print_mark(i);
+}
+
+gboolean
+startup_trace_is_enabled(void)
+{
+  return enabled;
+}
+
+/* --- First frame --- */
+typedef struct {
+  GdkFrameClock *frame_clock;
+  gint64         frame_counter;
+  gint64         painted;        /* monotonic µs, after the paint */
+} FirstFrame;
+
+static void
+first_frame_free(gpointer data)
+{
+  FirstFrame *first = data;
+
+  g_object_unref(first->frame_clock);
+  g_free(first);
+}
+
+/* Timings complete once the compositor reported back. Backends that do
+ * not report presentation leave the time at 0; then, or if the report
+ * never comes, the paint is the best we know. */
+static gboolean
+poll_presentation(gpointer user_data)
+{
+  FirstFrame *first = user_data;
+  GdkFrameTimings *timings = gdk_frame_clock_get_timings(first->frame_clock, first->frame_counter);
+  const gboolean complete = timings != NULL && gdk_frame_timings_get_complete(timings);
+
+  if (timings != NULL && !complete &&
+      g_get_monotonic_time() - first->painted < FIRST_FRAME_TIMEOUT_US)
+    return G_SOURCE_CONTINUE;
+
+  const gint64 presented = complete ? gdk_frame_timings_get_presentation_time(timings) : 0;
+  if (presented > 0)
+    add_mark("first frame presented", presented);
+  else
+    add_mark("first frame painted", first->painted);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+on_after_paint(GdkFrameClock *frame_clock, gpointer user_data)
+{
+  FirstFrame *first = g_new0(FirstFrame, 1);
+
+  g_signal_handlers_disconnect_by_func(frame_clock, on_after_paint, user_data);
+
+  first->frame_clock   = g_object_ref(frame_clock);
+  first->frame_counter = gdk_frame_clock_get_frame_counter(frame_clock);
+  first->painted       = g_get_monotonic_time();
+  g_timeout_add_full(G_PRIORITY_DEFAULT, FIRST_FRAME_POLL_MS, poll_presentation, first, first_frame_free);
+}
+
+void
+startup_trace_watch_first_frame(GdkFrameClock *frame_clock)
+{
+  g_return_if_fail(GDK_IS_FRAME_CLOCK(frame_clock));
+
+  g_signal_connect(frame_clock, "after-paint", G_CALLBACK(on_after_paint), NULL);
+}
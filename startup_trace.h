@@ -0,0 +1,24 @@
+#pragma once
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+/* Timestamped startup phases. Marks are always recorded (a few dozen
+ * entries at most); they are only printed once tracing is enabled, which
+ * happens after option parsing, so earlier marks are printed then. Main
+ * thread only. */
+
+/* Record @phase, in ms since the first mark */
+void     startup_trace_mark(const char *phase);
+
+/* Print every mark so far to stderr, and each later one as it happens */
+void     startup_trace_enable(void);
+gboolean startup_trace_is_enabled(void);
+
+/* Mark "first frame presented" when the next frame of @frame_clock
+ * reached the screen, as the compositor reports it. Where the backend
+ * does not report presentation, mark "first frame painted" at the end of
+ * that frame's paint instead. */
+void     startup_trace_watch_first_frame(GdkFrameClock *frame_clock);
+
+G_END_DECLS
@@ -0,0 +1,519 @@
+#include "telemetry_aggregator.h"
+#include <math.h>
+#include <string.h>
+
+/* Neighbouring channels staged and reduced together, one pool job each */
+#define AGGREGATOR_BLOCK          1024
+/* How often the collector drains the inner source */
+#define AGGREGATOR_POLL_US        1000
+/* Below this many staged samples an interval is reduced on the collector:
+ * handing it to the pool would cost more than it saves */
+#define AGGREGATOR_INLINE_SAMPLES 8192
+/* Reduced samples waiting for the main thread, in intervals of all channels */
+#define AGGREGATOR_OUTPUT_INTERVALS 2
+#define AGGREGATOR_DRAIN_CHUNK    256
+
+/* A run of AGGREGATOR_BLOCK channels. The collector stages samples into
+ * it; at the end of an interval one thread owns it to reduce them. */
+typedef struct {
+  guint         first;      /* first channel */
+  guint         n;          /* channels in the block */
+  const guint8 *reduction;  /* TelemetryReduction per channel */
+  GArray       *staged;     /* TelemetrySample */
+  GArray       *out;        /* TelemetrySample, one per channel seen */
+
+  /* Accumulators of the interval, per channel */
+  guint32      *count;
+  double       *sum;
+  double       *sum_sq;
+  double       *min;
+  double       *max;
+  double       *last;
+  gint64       *timestamp;
+} AggregatorBlock;
+
+struct _TelemetryAggregator {
+  GObject parent_instance;
+
+  TelemetrySource *inner;
+  guint            n_channels;
+  guint8          *reduction;     /* TelemetryReduction per channel */
+  gint64           interval;      /* µs */
+  guint            n_workers;     /* 0: one per processor */
+
+  /* Collector only */
+  AggregatorBlock *blocks;
+  guint            n_blocks;
+  GArray          *dirty;         /* indices of blocks with staged samples */
+  guint            n_staged;
+  guint64          samples_in;
+  guint64          ignored;
+
+  TelemetryRing   *output;        /* collector → main thread */
+  guint            output_size;   /* its capacity, and the most one drain hands out */
+  GThreadPool     *pool;
+  GThread         *collector;
+  GMutex           lock;
+  GCond            cond;
+  gboolean         stopping;      /* lock */
+  guint            pending;       /* blocks in the pool, lock */
+  TelemetryAggregatorStats stats; /* lock, except dropped */
+};
+
+static void telemetry_aggregator_source_iface_init(TelemetrySourceInterface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(TelemetryAggregator, telemetry_aggregator, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(TELEMETRY_TYPE_SOURCE,
+                                                    telemetry_aggregator_source_iface_init))
+
+GType
+telemetry_reduction_get_type(void)
+{
+  static gsize type_id = 0;
+
+  if (g_once_init_enter(&type_id)) {
+    static const GEnumValue values[] = {
+      { TELEMETRY_REDUCE_LAST, "TELEMETRY_REDUCE_LAST", "last" },
+      { TELEMETRY_REDUCE_MEAN, "TELEMETRY_REDUCE_MEAN", "mean" },
+      { TELEMETRY_REDUCE_MIN,  "TELEMETRY_REDUCE_MIN",  "min" },
+      { TELEMETRY_REDUCE_MAX,  "TELEMETRY_REDUCE_MAX",  "max" },
+      { TELEMETRY_REDUCE_RMS,  "TELEMETRY_REDUCE_RMS",  "rms" },
+      { 0, NULL, NULL }
+    };
+    GType type = g_enum_register_static(g_intern_static_string("TelemetryReduction"), values);
+    g_once_init_leave(&type_id, type);
+  }
+
+  return type_id;
+}
+
+/* --- Blocks --- */
+static void
+block_init(AggregatorBlock *block, guint first, guint n, const guint8 *reduction)
+{
+  block->first     = first;
+  block->n         = n;
+  block->reduction = reduction + first;
+  block->staged    = g_array_new(FALSE, FALSE, sizeof(TelemetrySample));
+  block->out       = g_array_sized_new(FALSE, FALSE, sizeof(TelemetrySample), n);
+  block->count     = g_new0(guint32, n);
+  block->sum       = g_new(double, n);
+  block->sum_sq    = g_new(double, n);
+  block->min       = g_new(double, n);
+  block->max       = g_new(double, n);
+  block->last      = g_new(double, n);
+  block->timestamp = g_new(gint64, n);
+}
+
+static void
+block_clear(AggregatorBlock *block)
+{
+  g_array_unref(block->staged);
+  g_array_unref(block->out);
+  g_free(block->count);
+  g_free(block->sum);
+  g_free(block->sum_sq);
+  g_free(block->min);
+  g_free(block->max);
+  g_free(block->last);
+  g_free(block->timestamp);
+}
+
+static double
+reduce_channel(const AggregatorBlock *block, guint k)
+{
+  switch ((TelemetryReduction)block->reduction[k]) {
+  case TELEMETRY_REDUCE_MEAN:
+    return block->sum[k] / block->count[k];
+  case TELEMETRY_REDUCE_MIN:
+    return block->min[k];
+  case TELEMETRY_REDUCE_MAX:
+    return block->max[k];
+  case TELEMETRY_REDUCE_RMS:
+    return sqrt(block->sum_sq[k] / block->count[k]);
+  case TELEMETRY_REDUCE_LAST:
+  default:
+    return block->last[k];
+  }
+}
+
+/* Fold the staged samples into the accumulators, then sweep the block's
+ * channels in order and emit one sample for each that had any. Touches
+ * nothing outside the block, so blocks reduce in parallel. */
+static void
+block_reduce(AggregatorBlock *block)
+{
+  const TelemetrySample *samples = (const TelemetrySample *)block->staged->data;
+  const guint n_samples = block->staged->len;
+
+  for (guint i = 0; i < n_samples; i++) {
+    const guint k = samples[i].channel - block->first;
+    const double v = samples[i].value;
+
+    if (block->count[k]++ == 0) {
+      block->sum[k]    = v;
+      block->sum_sq[k] = v * v;
+      block->min[k]    = v;
+      block->max[k]    = v;
+    } else {
+      block->sum[k]    += v;
+      block->sum_sq[k] += v * v;
+      block->min[k]     = MIN(block->min[k], v);
+      block->max[k]     = MAX(block->max[k], v);
+    }
+    block->last[k]      = v;
+    block->timestamp[k] = samples[i].timestamp;
+  }
+  g_array_set_size(block->staged, 0);
+
+  for (guint k = 0; k < block->n; k++) {
+    if (block->count[k] == 0)
+      continue;
+
+    const TelemetrySample sample = {
+      .channel   = block->first + k,
+      .timestamp = block->timestamp[k],
+      .value     = reduce_channel(block, k),
+    };
+    g_array_append_val(block->out, sample);
+    block->count[k] = 0;
+  }
+}
+
+static void
+reduce_job(gpointer data, gpointer user_data)
+{
+  TelemetryAggregator *self = user_data;
+
+  block_reduce(data);
+
+  g_mutex_lock(&self->lock);
+  if (--self->pending == 0)
+    g_cond_signal(&self->cond);
+  g_mutex_unlock(&self->lock);
+}
+
+/* --- Collector thread --- */
+static void
+stage_sample(const TelemetrySample *sample, gpointer user_data)
+{
+  TelemetryAggregator *self = user_data;
+
+  if (sample->channel >= self->n_channels) {
+    self->ignored++;
+    return;
+  }
+
+  const guint b = sample->channel / AGGREGATOR_BLOCK;
+  AggregatorBlock *block = &self->blocks[b];
+
+  if (block->staged->len == 0)
+    g_array_append_val(self->dirty, b);
+  g_array_append_val(block->staged, *sample);
+  self->n_staged++;
+  self->samples_in++;
+}
+
+static int
+compare_block(gconstpointer a, gconstpointer b)
+{
+  const guint x = *(const guint *)a;
+  const guint y = *(const guint *)b;
+  return (x > y) - (x < y);
+}
+
+/* End of an interval: reduce every block with samples, on the pool when
+ * there is enough to share, and queue the results for the main thread */
+static void
+flush_interval(TelemetryAggregator *self)
+{
+  const guint *dirty = (const guint *)self->dirty->data;
+  const guint n_dirty = self->dirty->len;
+  const gint64 start = g_get_monotonic_time();
+  guint64 n_out = 0;
+
+  if (n_dirty > 1 && self->n_staged >= AGGREGATOR_INLINE_SAMPLES) {
+    g_mutex_lock(&self->lock);
+    self->pending = n_dirty;
+    g_mutex_unlock(&self->lock);
+
+    for (guint i = 0; i < n_dirty; i++)
+      g_thread_pool_push(self->pool, &self->blocks[dirty[i]], NULL);
+
+    g_mutex_lock(&self->lock);
+    while (self->pending > 0)
+      g_cond_wait(&self->cond, &self->lock);
+    g_mutex_unlock(&self->lock);
+  } else {
+    for (guint i = 0; i < n_dirty; i++)
+      block_reduce(&self->blocks[dirty[i]]);
+  }
+
+  /* Blocks got dirty in order of their first sample; each block's output
+   * is in channel order, so sorting the blocks orders the whole interval */
+  g_array_sort(self->dirty, compare_block);
+  for (guint i = 0; i < n_dirty; i++) {
+    GArray *out = self->blocks[dirty[i]].out;
+
+    for (guint j = 0; j < out->len; j++)
+      telemetry_ring_push(self->output, &g_array_index(out, TelemetrySample, j));
+    n_out += out->len;
+    g_array_set_size(out, 0);
+  }
+
+  g_array_set_size(self->dirty, 0);
+  self->n_staged = 0;
+
+  const gint64 elapsed = g_get_monotonic_time() - start;
+
+  g_mutex_lock(&self->lock);
+  self->stats.samples_in     = self->samples_in;
+  self->stats.samples_out   += n_out;
+  self->stats.ignored        = self->ignored;
+  self->stats.intervals++;
+  self->stats.last_reduce_us = elapsed;
+  self->stats.max_reduce_us  = MAX(self->stats.max_reduce_us, elapsed);
+  g_mutex_unlock(&self->lock);
+}
+
+static gpointer
+telemetry_aggregator_collector(gpointer data)
+{
+  TelemetryAggregator *self = data;
+  gint64 next = g_get_monotonic_time();
+  gint64 next_flush = next + self->interval;
+
+  g_mutex_lock(&self->lock);
+  while (!self->stopping) {
+    next += AGGREGATOR_POLL_US;
+    while (!self->stopping && g_cond_wait_until(&self->cond, &self->lock, next))
+      ;  /* woken early: only stop() signals */
+    if (self->stopping)
+      break;
+
+    g_mutex_unlock(&self->lock);
+    telemetry_source_drain(self->inner, stage_sample, self);
+
+    const gint64 now = g_get_monotonic_time();
+    if (now >= next_flush) {
+      flush_interval(self);
+      /* Fell behind: start a fresh interval instead of flushing back to back */
+      next_flush += self->interval;
+      if (next_flush <= now)
+        next_flush = now + self->interval;
+    }
+    if (now > next + AGGREGATOR_POLL_US)
+      next = now;
+    g_mutex_lock(&self->lock);
+  }
+  g_mutex_unlock(&self->lock);
+
+  /* Whatever was staged still reaches the display */
+  flush_interval(self);
+
+  return NULL;
+}
+
+/* --- TelemetrySource --- */
+static gboolean
+telemetry_aggregator_start(TelemetrySource *source, GError **error)
+{
+  TelemetryAggregator *self = TELEMETRY_AGGREGATOR(source);
+
+  if (self->collector != NULL)
+    return TRUE;
+
+  if (!telemetry_source_start(self->inner, error))
+    return FALSE;
+
+  const guint n_workers = self->n_workers > 0 ? self->n_workers : MAX(g_get_num_processors(), 1);
+  self->pool = g_thread_pool_new(reduce_job, self, (int)n_workers, TRUE, error);
+  if (self->pool != NULL) {
+    self->stopping = FALSE;
+    self->collector = g_thread_try_new("telemetry-aggregate", telemetry_aggregator_collector,
+                                       self, error);
+  }
+
+  if (self->collector == NULL) {
+    if (self->pool != NULL)
+      g_thread_pool_free(g_steal_pointer(&self->pool), FALSE, TRUE);
+    telemetry_source_stop(self->inner);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static void
+telemetry_aggregator_stop(TelemetrySource *source)
+{
+  TelemetryAggregator *self = TELEMETRY_AGGREGATOR(source);
+
+  if (self->collector == NULL)
+    return;
+
+  g_mutex_lock(&self->lock);
+  self->stopping = TRUE;
+  g_cond_signal(&self->cond);
+  g_mutex_unlock(&self->lock);
+
+  g_thread_join(self->collector);
+  self->collector = NULL;
+  g_thread_pool_free(g_steal_pointer(&self->pool), FALSE, TRUE);
+
+  telemetry_source_stop(self->inner);
+}
+
+static guint
+telemetry_aggregator_drain(TelemetrySource *source, TelemetrySampleFunc func, gpointer user_data)
+{
+  TelemetryAggregator *self = TELEMETRY_AGGREGATOR(source);
+  TelemetrySample chunk[AGGREGATOR_DRAIN_CHUNK];
+  guint total = 0;
+  guint n;
+
+  /* The collector keeps pushing while we pop: stop after one ring's
+   * worth and leave the rest for the next frame */
+  while (total < self->output_size &&
+         (n = telemetry_ring_pop(self->output, chunk, G_N_ELEMENTS(chunk))) > 0) {
+    for (guint i = 0; i < n; i++)
+      func(&chunk[i], user_data);
+    total += n;
+  }
+
+  return total;
+}
+
+static void
+telemetry_aggregator_source_iface_init(TelemetrySourceInterface *iface)
+{
+  iface->start = telemetry_aggregator_start;
+  iface->stop  = telemetry_aggregator_stop;
+  iface->drain = telemetry_aggregator_drain;
+}
+
+/* --- GObject --- */
+static void
+telemetry_aggregator_finalize(GObject *object)
+{
+  TelemetryAggregator *self = TELEMETRY_AGGREGATOR(object);
+
+  telemetry_aggregator_stop(TELEMETRY_SOURCE(self));
+
+  for (guint b = 0; b < self->n_blocks; b++)
+    block_clear(&self->blocks[b]);
+  g_free(self->blocks);
+  g_free(self->reduction);
+  g_array_unref(self->dirty);
+  telemetry_ring_free(self->output);
+  g_clear_object(&self->inner);
+  g_mutex_clear(&self->lock);
+  g_cond_clear(&self->cond);
+
+  G_OBJECT_CLASS(telemetry_aggregator_parent_class)->finalize(object);
+}
+
+static void
+telemetry_aggregator_class_init(TelemetryAggregatorClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->finalize = telemetry_aggregator_finalize;
+}
+
+static void
+telemetry_aggregator_init(TelemetryAggregator *self)
+{
+  self->inner      = NULL;
+  self->n_channels = 0;
+  self->reduction  = NULL;
+  self->interval   = G_USEC_PER_SEC / 60;
+  self->n_workers  = 0;
+  self->blocks     = NULL;
+  self->n_blocks   = 0;
+  self->dirty      = g_array_new(FALSE, FALSE, sizeof(guint));
+  self->n_staged   = 0;
+  self->samples_in = 0;
+  self->ignored    = 0;
+  self->output     = NULL;
+  self->pool       = NULL;
+  self->collector  = NULL;
+  self->stopping   = FALSE;
+  self->pending    = 0;
+  self->stats      = (TelemetryAggregatorStats) { 0 };
+  g_mutex_init(&self->lock);
+  g_cond_init(&self->cond);
+}
+
+/* --- Public API --- */
+TelemetryAggregator *
+telemetry_aggregator_new(TelemetrySource *inner, guint n_channels, TelemetryReduction reduction)
+{
+  g_return_val_if_fail(TELEMETRY_IS_SOURCE(inner), NULL);
+  g_return_val_if_fail(n_channels > 0, NULL);
+
+  TelemetryAggregator *self = g_object_new(TELEMETRY_TYPE_AGGREGATOR, NULL);
+  self->inner      = g_object_ref(inner);
+  self->n_channels = n_channels;
+  self->reduction  = g_malloc(n_channels);
+  memset(self->reduction, reduction, n_channels);
+
+  self->n_blocks = (n_channels + AGGREGATOR_BLOCK - 1) / AGGREGATOR_BLOCK;
+  self->blocks   = g_new(AggregatorBlock, self->n_blocks);
+  for (guint b = 0; b < self->n_blocks; b++) {
+    const guint first = b * AGGREGATOR_BLOCK;
+    block_init(&self->blocks[b], first, MIN(AGGREGATOR_BLOCK, n_channels - first), self->reduction);
+  }
+
+  self->output_size = MAX(n_channels * AGGREGATOR_OUTPUT_INTERVALS, 4096);
+  self->output      = telemetry_ring_new(self->output_size);
+
+  return self;
+}
+
+void
+telemetry_aggregator_set_reduction(TelemetryAggregator *self, guint channel, TelemetryReduction reduction)
+{
+  g_return_if_fail(TELEMETRY_IS_AGGREGATOR(self));
+  g_return_if_fail(self->collector == NULL);
+  g_return_if_fail(channel < self->n_channels);
+
+  self->reduction[channel] = reduction;
+}
+
+void
+telemetry_aggregator_set_interval(TelemetryAggregator *self, gint64 interval_us)
+{
+  g_return_if_fail(TELEMETRY_IS_AGGREGATOR(self));
+  g_return_if_fail(self->collector == NULL);
+
+  self->interval = MAX(interval_us, AGGREGATOR_POLL_US);
+}
+
+gint64
+telemetry_aggregator_get_interval(TelemetryAggregator *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_AGGREGATOR(self), 0);
+
+  return self->interval;
+}
+
+void
+telemetry_aggregator_set_n_workers(TelemetryAggregator *self, guint n_workers)
+{
+  g_return_if_fail(TELEMETRY_IS_AGGREGATOR(self));
+  g_return_if_fail(self->collector == NULL);
+
+  self->n_workers = n_workers;
+}
+
+void
+telemetry_aggregator_get_stats(TelemetryAggregator *self, TelemetryAggregatorStats *stats)
+{
+  g_return_if_fail(TELEMETRY_IS_AGGREGATOR(self));
+
+  g_mutex_lock(&self->lock);
+  *stats = self->stats;
+  g_mutex_unlock(&self->lock);
+
+  stats->dropped = telemetry_ring_get_dropped(self->output);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <glib-object.h>
+#include "telemetry_source.h"
+
+G_BEGIN_DECLS
+
+#define TELEMETRY_TYPE_AGGREGATOR (telemetry_aggregator_get_type())
+#define TELEMETRY_TYPE_REDUCTION  (telemetry_reduction_get_type())
+
+/* What one display interval of a channel's samples is reduced to */
+typedef enum {
+  TELEMETRY_REDUCE_LAST,
+  TELEMETRY_REDUCE_MEAN,
+  TELEMETRY_REDUCE_MIN,
+  TELEMETRY_REDUCE_MAX,
+  TELEMETRY_REDUCE_RMS,
+} TelemetryReduction;
+
+GType telemetry_reduction_get_type(void);
+
+typedef struct {
+  guint64 samples_in;     /* drained from the inner source */
+  guint64 samples_out;    /* reduced samples produced */
+  guint64 ignored;        /* samples of channels beyond n_channels */
+  guint64 intervals;
+  guint   dropped;        /* reduced samples lost because nobody drained */
+  gint64  last_reduce_us; /* cost of the last interval's reduction */
+  gint64  max_reduce_us;
+} TelemetryAggregatorStats;
+
+/* A TelemetrySource that reduces another source to at most one sample per
+ * channel per display interval. A collector thread drains the inner
+ * source and stages samples in blocks of neighbouring channels; at the
+ * end of each interval a thread pool reduces the blocks in parallel. A
+ * drain on the main thread then only sees the reduced samples.
+ *
+ * Between start() and stop() the inner source is drained on the collector
+ * thread, so it must not be drained or reconfigured elsewhere meanwhile. */
+G_DECLARE_FINAL_TYPE(TelemetryAggregator, telemetry_aggregator, TELEMETRY, AGGREGATOR, GObject)
+
+TelemetryAggregator *telemetry_aggregator_new(TelemetrySource   *inner,
+                                              guint              n_channels,
+                                              TelemetryReduction reduction);
+
+/* Before start() */
+void     telemetry_aggregator_set_reduction(TelemetryAggregator *self,
+                                            guint                channel,
+                                            TelemetryReduction   reduction);
+void     telemetry_aggregator_set_interval(TelemetryAggregator *self, gint64 interval_us);
+gint64   telemetry_aggregator_get_interval(TelemetryAggregator *self);
+
+/* Reduction threads; 0 (the default) for one per processor */
+void     telemetry_aggregator_set_n_workers(TelemetryAggregator *self, guint n_workers);
+
+void     telemetry_aggregator_get_stats(TelemetryAggregator *self, TelemetryAggregatorStats *stats);
+
+G_END_DECLS
@@ -0,0 +1,56 @@
+#pragma once
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* On-disk telemetry capture, written by TelemetryRecorder and read by
+ * TelemetryReplay:
+ *
+ *   header | record × n_records | index entry × n_index | footer
+ *
+ * All fields are in the recorder's byte order, see byte_order. The index
+ * and footer are written when the recorder is closed; a capture cut short
+ * by a crash has neither and is searched record by record instead. */
+
+#define TELEMETRY_FILE_MAGIC          "GTLMREC1"
+#define TELEMETRY_FILE_INDEX_MAGIC    "GTLMIDX1"
+#define TELEMETRY_FILE_VERSION        1
+#define TELEMETRY_FILE_BYTE_ORDER     0x01020304u
+#define TELEMETRY_FILE_INDEX_INTERVAL 4096  /* records per index entry */
+
+typedef struct {
+  char    magic[8];
+  guint32 version;
+  guint32 record_size;     /* sizeof(TelemetryFileRecord) */
+  guint32 index_interval;
+  guint32 byte_order;      /* TELEMETRY_FILE_BYTE_ORDER as the writer saw it */
+  gint64  created;         /* wall-clock µs */
+} TelemetryFileHeader;
+
+typedef struct {
+  guint32 channel;
+  guint32 flags;           /* reserved, 0 */
+  gint64  timestamp;       /* µs, non-decreasing through the file: the
+                            * recorder writes a sample stamped earlier than
+                            * the record before it with that record's time */
+  double  value;
+} TelemetryFileRecord;
+
+typedef struct {
+  gint64  timestamp;       /* of record number @record */
+  guint64 record;
+} TelemetryFileIndexEntry;
+
+typedef struct {
+  char    magic[8];
+  guint64 index_offset;    /* byte offset of the first index entry */
+  guint64 n_index;
+  guint64 n_records;
+} TelemetryFileFooter;
+
+G_STATIC_ASSERT(sizeof(TelemetryFileHeader) == 32);
+G_STATIC_ASSERT(sizeof(TelemetryFileRecord) == 24);
+G_STATIC_ASSERT(sizeof(TelemetryFileIndexEntry) == 16);
+G_STATIC_ASSERT(sizeof(TelemetryFileFooter) == 32);
+
+G_END_DECLS
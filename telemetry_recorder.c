@@ -0,0 +1,239 @@
+#include "telemetry_recorder.h"
+#include "telemetry_file.h"
+#include <gio/gio.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TELEMETRY_RECORDER_BUFFER_SIZE (1 << 20)
+
+struct _TelemetryRecorder {
+  GObject parent_instance;
+
+  TelemetrySource *inner;
+  char            *path;
+  FILE            *file;         /* NULL once closed or after a write error */
+  char            *buffer;       /* stdio buffer, so records go out in big writes */
+  guint64          n_records;
+  gint64           last_timestamp; /* of the last record written */
+  GArray          *index;        /* TelemetryFileIndexEntry */
+
+  /* Forwarding state of the drain in progress */
+  TelemetrySampleFunc func;
+  gpointer            user_data;
+};
+
+static void telemetry_recorder_source_iface_init(TelemetrySourceInterface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(TelemetryRecorder, telemetry_recorder, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(TELEMETRY_TYPE_SOURCE,
+                                                    telemetry_recorder_source_iface_init))
+
+/* --- Writing --- */
+static gboolean
+write_all(TelemetryRecorder *self, const void *data, gsize size, GError **error)
+{
+  if (fwrite(data, 1, size, self->file) == size)
+    return TRUE;
+
+  int saved = errno;
+  g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved),
+              "Cannot write telemetry capture %s: %s", self->path, g_strerror(saved));
+  return FALSE;
+}
+
+/* Give up on the capture but keep the data flowing to the dashboard */
+static void
+abandon(TelemetryRecorder *self, GError *error)
+{
+  g_warning("Telemetry recording stopped: %s", error->message);
+  fclose(self->file);
+  self->file = NULL;
+}
+
+static void
+record_sample(const TelemetrySample *sample, gpointer user_data)
+{
+  TelemetryRecorder *self = TELEMETRY_RECORDER(user_data);
+
+  if (self->file != NULL) {
+    /* Replay seeks by timestamp: a sample stamped before the last record
+     * is recorded at the last record's time */
+    const gint64 timestamp = MAX(sample->timestamp, self->last_timestamp);
+    const TelemetryFileRecord record = {
+      .channel   = sample->channel,
+      .flags     = 0,
+      .timestamp = timestamp,
+      .value     = sample->value,
+    };
+    g_autoptr(GError) error = NULL;
+
+    if (self->n_records % TELEMETRY_FILE_INDEX_INTERVAL == 0) {
+      const TelemetryFileIndexEntry entry = { timestamp, self->n_records };
+      g_array_append_val(self->index, entry);
+    }
+
+    if (write_all(self, &record, sizeof(record), &error)) {
+      self->n_records++;
+      self->last_timestamp = timestamp;
+    } else {
+      abandon(self, error);
+    }
+  }
+
+  self->func(sample, self->user_data);
+}
+
+/* --- TelemetrySource --- */
+static gboolean
+telemetry_recorder_start(TelemetrySource *source, GError **error)
+{
+  return telemetry_source_start(TELEMETRY_RECORDER(source)->inner, error);
+}
+
+static void
+telemetry_recorder_stop(TelemetrySource *source)
+{
+  TelemetryRecorder *self = TELEMETRY_RECORDER(source);
+
+  telemetry_source_stop(self->inner);
+
+  /* Nothing more will arrive: get what we have onto disk */
+  if (self->file != NULL)
+    fflush(self->file);
+}
+
+static guint
+telemetry_recorder_drain(TelemetrySource *source, TelemetrySampleFunc func, gpointer user_data)
+{
+  TelemetryRecorder *self = TELEMETRY_RECORDER(source);
+
+  self->func = func;
+  self->user_data = user_data;
+
+  return telemetry_source_drain(self->inner, record_sample, self);
+}
+
+static void
+telemetry_recorder_source_iface_init(TelemetrySourceInterface *iface)
+{
+  iface->start = telemetry_recorder_start;
+  iface->stop  = telemetry_recorder_stop;
+  iface->drain = telemetry_recorder_drain;
+}
+
+/* --- GObject --- */
+static void
+telemetry_recorder_finalize(GObject *object)
+{
+  TelemetryRecorder *self = TELEMETRY_RECORDER(object);
+  g_autoptr(GError) error = NULL;
+
+  if (!telemetry_recorder_close(self, &error))
+    g_warning("%s", error->message);
+
+  g_clear_object(&self->inner);
+  g_free(self->path);
+  g_free(self->buffer);
+  g_array_unref(self->index);
+
+  G_OBJECT_CLASS(telemetry_recorder_parent_class)->finalize(object);
+}
+
+static void
+telemetry_recorder_class_init(TelemetryRecorderClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->finalize = telemetry_recorder_finalize;
+}
+
+static void
+telemetry_recorder_init(TelemetryRecorder *self)
+{
+  self->inner     = NULL;
+  self->path      = NULL;
+  self->file      = NULL;
+  self->buffer    = NULL;
+  self->n_records = 0;
+  self->index     = g_array_new(FALSE, FALSE, sizeof(TelemetryFileIndexEntry));
+
+  self->last_timestamp = G_MININT64;
+}
+
+/* --- Public API --- */
+TelemetryRecorder *
+telemetry_recorder_new(TelemetrySource *inner, const char *path, GError **error)
+{
+  g_return_val_if_fail(TELEMETRY_IS_SOURCE(inner), NULL);
+  g_return_val_if_fail(path != NULL, NULL);
+
+  FILE *file = fopen(path, "wbe");
+  if (file == NULL) {
+    int saved = errno;
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved),
+                "Cannot create telemetry capture %s: %s", path, g_strerror(saved));
+    return NULL;
+  }
+
+  TelemetryRecorder *self = g_object_new(TELEMETRY_TYPE_RECORDER, NULL);
+  self->inner  = g_object_ref(inner);
+  self->path   = g_strdup(path);
+  self->file   = file;
+  self->buffer = g_malloc(TELEMETRY_RECORDER_BUFFER_SIZE);
+  setvbuf(self->file, self->buffer, _IOFBF, TELEMETRY_RECORDER_BUFFER_SIZE);
+
+  TelemetryFileHeader header = {
+    .version        = TELEMETRY_FILE_VERSION,
+    .record_size    = sizeof(TelemetryFileRecord),
+    .index_interval = TELEMETRY_FILE_INDEX_INTERVAL,
+    .byte_order     = TELEMETRY_FILE_BYTE_ORDER,
+    .created        = g_get_real_time(),
+  };
+  memcpy(header.magic, TELEMETRY_FILE_MAGIC, sizeof(header.magic));
+
+  if (!write_all(self, &header, sizeof(header), error)) {
+    fclose(self->file);
+    self->file = NULL;
+    g_object_unref(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+gboolean
+telemetry_recorder_close(TelemetryRecorder *self, GError **error)
+{
+  g_return_val_if_fail(TELEMETRY_IS_RECORDER(self), FALSE);
+
+  if (self->file == NULL)
+    return TRUE;
+
+  TelemetryFileFooter footer = {
+    .index_offset = sizeof(TelemetryFileHeader) + self->n_records * sizeof(TelemetryFileRecord),
+    .n_index      = self->index->len,
+    .n_records    = self->n_records,
+  };
+  memcpy(footer.magic, TELEMETRY_FILE_INDEX_MAGIC, sizeof(footer.magic));
+
+  gboolean ok = write_all(self, self->index->data,
+                          self->index->len * sizeof(TelemetryFileIndexEntry), error) &&
+                write_all(self, &footer, sizeof(footer), error);
+
+  if (fclose(self->file) != 0 && ok) {
+    int saved = errno;
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved),
+                "Cannot write telemetry capture %s: %s", self->path, g_strerror(saved));
+    ok = FALSE;
+  }
+  self->file = NULL;
+
+  return ok;
+}
+
+guint64
+telemetry_recorder_get_n_records(TelemetryRecorder *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_RECORDER(self), 0);
+  return self->n_records;
+}
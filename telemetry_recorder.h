@@ -0,0 +1,25 @@
+#pragma once
+#include <glib-object.h>
+#include "telemetry_source.h"
+
+G_BEGIN_DECLS
+
+#define TELEMETRY_TYPE_RECORDER (telemetry_recorder_get_type())
+
+/* A TelemetrySource that passes another source through unchanged while
+ * appending every drained sample to a capture file (see telemetry_file.h).
+ * It records exactly what the dashboard was handed, except that a sample
+ * stamped earlier than the previous record is recorded at that record's
+ * time, keeping the file's timestamps non-decreasing. */
+G_DECLARE_FINAL_TYPE(TelemetryRecorder, telemetry_recorder, TELEMETRY, RECORDER, GObject)
+
+TelemetryRecorder *telemetry_recorder_new(TelemetrySource *inner,
+                                          const char      *path,
+                                          GError         **error);
+
+/* Writes the time index and footer. Called by finalize if not before. */
+gboolean           telemetry_recorder_close(TelemetryRecorder *self, GError **error);
+
+guint64            telemetry_recorder_get_n_records(TelemetryRecorder *self);
+
+G_END_DECLS
@@ -0,0 +1,360 @@
+#include "telemetry_replay.h"
+#include "telemetry_file.h"
+#include <gio/gio.h>
+#include <string.h>
+
+/* Upper bound on samples handed out per drain, so a fast or lagging
+ * replay cannot stall a frame; the rest follows on the next frame */
+#define TELEMETRY_REPLAY_MAX_PER_DRAIN 262144
+
+struct _TelemetryReplay {
+  GObject parent_instance;
+
+  GMappedFile                   *map;
+  const TelemetryFileRecord     *records;
+  guint64                        n_records;
+  const TelemetryFileIndexEntry *index;     /* NULL for captures without a footer */
+  guint64                        n_index;
+
+  guint64  cursor;       /* next record to hand out */
+  double   speed;        /* 0: as fast as possible */
+  gboolean running;
+  TelemetryRing *tap;    /* second consumer of every sample, not owned */
+
+  /* Playback clock: capture time anchor_ts corresponds to anchor_wall */
+  gint64   anchor_wall;
+  gint64   anchor_ts;
+};
+
+static void telemetry_replay_source_iface_init(TelemetrySourceInterface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(TelemetryReplay, telemetry_replay, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(TELEMETRY_TYPE_SOURCE,
+                                                    telemetry_replay_source_iface_init))
+
+/* --- Playback clock --- */
+static gint64
+playback_time(TelemetryReplay *self, gint64 now)
+{
+  return self->anchor_ts + (gint64)((now - self->anchor_wall) * self->speed);
+}
+
+static void
+anchor(TelemetryReplay *self, gint64 capture_time)
+{
+  self->anchor_wall = g_get_monotonic_time();
+  self->anchor_ts   = capture_time;
+}
+
+static gint64
+cursor_time(TelemetryReplay *self)
+{
+  if (self->n_records == 0)
+    return 0;
+
+  return self->records[MIN(self->cursor, self->n_records - 1)].timestamp;
+}
+
+/* --- Seeking --- */
+
+/* First record in [lo, hi) with a timestamp >= @ts, or @hi */
+static guint64
+lower_bound(TelemetryReplay *self, guint64 lo, guint64 hi, gint64 ts)
+{
+  while (lo < hi) {
+    guint64 mid = lo + (hi - lo) / 2;
+
+    if (self->records[mid].timestamp < ts)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/* The index narrows the search to one interval of records, so a seek
+ * touches a handful of index entries and one or two pages of records */
+static guint64
+find_record(TelemetryReplay *self, gint64 ts)
+{
+  guint64 lo = 0, hi = self->n_records;
+
+  if (self->index != NULL) {
+    guint64 a = 0, b = self->n_index;
+
+    while (a < b) {
+      guint64 mid = a + (b - a) / 2;
+
+      if (self->index[mid].timestamp < ts)
+        a = mid + 1;
+      else
+        b = mid;
+    }
+
+    /* Entry a is the first at or after ts; the answer is past entry a-1 */
+    if (a > 0)
+      lo = self->index[a - 1].record;
+    if (a < self->n_index)
+      hi = MIN(self->index[a].record + 1, self->n_records);
+  }
+
+  return lower_bound(self, lo, hi, ts);
+}
+
+/* --- TelemetrySource --- */
+static gboolean
+telemetry_replay_start(TelemetrySource *source, GError **error)
+{
+  TelemetryReplay *self = TELEMETRY_REPLAY(source);
+
+  if (!self->running) {
+    anchor(self, cursor_time(self));
+    self->running = TRUE;
+  }
+
+  return TRUE;
+}
+
+static void
+telemetry_replay_stop(TelemetrySource *source)
+{
+  TELEMETRY_REPLAY(source)->running = FALSE;
+}
+
+static guint
+telemetry_replay_drain(TelemetrySource *source, TelemetrySampleFunc func, gpointer user_data)
+{
+  TelemetryReplay *self = TELEMETRY_REPLAY(source);
+
+  if (!self->running)
+    return 0;
+
+  const guint64 end   = MIN(self->n_records, self->cursor + TELEMETRY_REPLAY_MAX_PER_DRAIN);
+  const gboolean afap = self->speed <= 0.0;
+  const gint64 until  = afap ? G_MAXINT64 : playback_time(self, g_get_monotonic_time());
+  guint n = 0;
+
+  while (self->cursor < end && self->records[self->cursor].timestamp <= until) {
+    const TelemetryFileRecord *r = &self->records[self->cursor++];
+    const TelemetrySample sample = { r->channel, r->timestamp, r->value };
+
+    func(&sample, user_data);
+    if (self->tap != NULL)
+      telemetry_ring_push(self->tap, &sample);
+    n++;
+  }
+
+  return n;
+}
+
+static void
+telemetry_replay_source_iface_init(TelemetrySourceInterface *iface)
+{
+  iface->start = telemetry_replay_start;
+  iface->stop  = telemetry_replay_stop;
+  iface->drain = telemetry_replay_drain;
+}
+
+/* --- GObject --- */
+static void
+telemetry_replay_finalize(GObject *object)
+{
+  TelemetryReplay *self = TELEMETRY_REPLAY(object);
+
+  g_clear_pointer(&self->map, g_mapped_file_unref);
+
+  G_OBJECT_CLASS(telemetry_replay_parent_class)->finalize(object);
+}
+
+static void
+telemetry_replay_class_init(TelemetryReplayClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->finalize = telemetry_replay_finalize;
+}
+
+static void
+telemetry_replay_init(TelemetryReplay *self)
+{
+  self->map       = NULL;
+  self->records   = NULL;
+  self->n_records = 0;
+  self->index     = NULL;
+  self->n_index   = 0;
+  self->cursor    = 0;
+  self->speed     = 1.0;
+  self->running   = FALSE;
+  self->tap       = NULL;
+}
+
+/* --- Public API --- */
+static gboolean
+invalid_capture(const char *path, const char *reason, GError **error)
+{
+  g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+              "%s is not a usable telemetry capture: %s", path, reason);
+  return FALSE;
+}
+
+/* Trust the footer only if it describes this very file */
+static void
+load_index(TelemetryReplay *self, const char *data, gsize size)
+{
+  const gsize records_at = sizeof(TelemetryFileHeader);
+  TelemetryFileFooter footer;
+
+  if (size < records_at + sizeof(footer))
+    return;
+
+  memcpy(&footer, data + size - sizeof(footer), sizeof(footer));
+  if (memcmp(footer.magic, TELEMETRY_FILE_INDEX_MAGIC, sizeof(footer.magic)) != 0)
+    return;
+
+  if (footer.n_records > (size - records_at) / sizeof(TelemetryFileRecord) ||
+      footer.index_offset != records_at + footer.n_records * sizeof(TelemetryFileRecord) ||
+      footer.n_index > (size - footer.index_offset) / sizeof(TelemetryFileIndexEntry) ||
+      footer.index_offset + footer.n_index * sizeof(TelemetryFileIndexEntry) + sizeof(footer) != size)
+    return;
+
+  self->n_records = footer.n_records;
+  self->index     = (const TelemetryFileIndexEntry *)(data + footer.index_offset);
+  self->n_index   = footer.n_index;
+}
+
+static gboolean
+telemetry_replay_load(TelemetryReplay *self, const char *path, GError **error)
+{
+  const char *data = g_mapped_file_get_contents(self->map);
+  const gsize size = g_mapped_file_get_length(self->map);
+  TelemetryFileHeader header;
+
+  if (size < sizeof(header))
+    return invalid_capture(path, "too short", error);
+
+  memcpy(&header, data, sizeof(header));
+  if (memcmp(header.magic, TELEMETRY_FILE_MAGIC, sizeof(header.magic)) != 0)
+    return invalid_capture(path, "bad magic", error);
+  if (header.byte_order != TELEMETRY_FILE_BYTE_ORDER)
+    return invalid_capture(path, "recorded with a different byte order", error);
+  if (header.version != TELEMETRY_FILE_VERSION ||
+      header.record_size != sizeof(TelemetryFileRecord))
+    return invalid_capture(path, "unsupported version", error);
+
+  self->records = (const TelemetryFileRecord *)(data + sizeof(header));
+
+  /* Without a footer (recorder killed), use every whole record */
+  self->n_records = (size - sizeof(header)) / sizeof(TelemetryFileRecord);
+  load_index(self, data, size);
+
+  return TRUE;
+}
+
+TelemetryReplay *
+telemetry_replay_new(const char *path, GError **error)
+{
+  g_return_val_if_fail(path != NULL, NULL);
+
+  GMappedFile *map = g_mapped_file_new(path, FALSE, error);
+  if (map == NULL)
+    return NULL;
+
+  TelemetryReplay *self = g_object_new(TELEMETRY_TYPE_REPLAY, NULL);
+  self->map = map;
+
+  if (!telemetry_replay_load(self, path, error)) {
+    g_object_unref(self);
+    return NULL;
+  }
+
+  return self;
+}
+
+void
+telemetry_replay_set_tap(TelemetryReplay *self, TelemetryRing *tap)
+{
+  g_return_if_fail(TELEMETRY_IS_REPLAY(self));
+  self->tap = tap;
+}
+
+void
+telemetry_replay_set_speed(TelemetryReplay *self, double speed)
+{
+  g_return_if_fail(TELEMETRY_IS_REPLAY(self));
+
+  /* Keep the playback position continuous across the change */
+  if (self->running && self->speed > 0.0)
+    anchor(self, playback_time(self, g_get_monotonic_time()));
+  else
+    anchor(self, cursor_time(self));
+
+  self->speed = MAX(speed, 0.0);
+}
+
+double
+telemetry_replay_get_speed(TelemetryReplay *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_REPLAY(self), 0.0);
+  return self->speed;
+}
+
+void
+telemetry_replay_seek(TelemetryReplay *self, gint64 timestamp)
+{
+  g_return_if_fail(TELEMETRY_IS_REPLAY(self));
+
+  self->cursor = find_record(self, timestamp);
+  anchor(self, timestamp);
+}
+
+guint64
+telemetry_replay_read_until(TelemetryReplay   *self,
+                            gint64             timestamp,
+                            TelemetrySampleFunc func,
+                            gpointer           user_data)
+{
+  g_return_val_if_fail(TELEMETRY_IS_REPLAY(self), 0);
+  g_return_val_if_fail(func != NULL, 0);
+
+  const guint64 first = self->cursor;
+
+  while (self->cursor < self->n_records && self->records[self->cursor].timestamp <= timestamp) {
+    const TelemetryFileRecord *r = &self->records[self->cursor++];
+    const TelemetrySample sample = { r->channel, r->timestamp, r->value };
+
+    func(&sample, user_data);
+    if (self->tap != NULL)
+      telemetry_ring_push(self->tap, &sample);
+  }
+
+  anchor(self, timestamp);
+  return self->cursor - first;
+}
+
+guint64
+telemetry_replay_get_n_records(TelemetryReplay *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_REPLAY(self), 0);
+  return self->n_records;
+}
+
+gint64
+telemetry_replay_get_start_time(TelemetryReplay *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_REPLAY(self), 0);
+  return self->n_records ? self->records[0].timestamp : 0;
+}
+
+gint64
+telemetry_replay_get_end_time(TelemetryReplay *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_REPLAY(self), 0);
+  return self->n_records ? self->records[self->n_records - 1].timestamp : 0;
+}
+
+gboolean
+telemetry_replay_is_finished(TelemetryReplay *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_REPLAY(self), TRUE);
+  return self->cursor >= self->n_records;
+}
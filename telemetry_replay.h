@@ -0,0 +1,40 @@
+#pragma once
+#include <glib-object.h>
+#include "telemetry_source.h"
+
+G_BEGIN_DECLS
+
+#define TELEMETRY_TYPE_REPLAY (telemetry_replay_get_type())
+
+/* Plays back a capture written by TelemetryRecorder. The file is mapped,
+ * not read: opening and seeking touch only the header, the index and the
+ * pages around the seek target, whatever the size of the capture. */
+G_DECLARE_FINAL_TYPE(TelemetryReplay, telemetry_replay, TELEMETRY, REPLAY, GObject)
+
+TelemetryReplay *telemetry_replay_new(const char *path, GError **error);
+
+/* Every sample handed out is also pushed to @tap. Replay has no worker,
+ * so this happens during drain(), on the main thread. */
+void     telemetry_replay_set_tap(TelemetryReplay *self, TelemetryRing *tap);
+
+/* 1.0 plays in real time, N plays N times faster, 0 as fast as possible */
+void     telemetry_replay_set_speed(TelemetryReplay *self, double speed);
+double   telemetry_replay_get_speed(TelemetryReplay *self);
+
+/* Continue from the first record at or after @timestamp (µs) */
+void     telemetry_replay_seek(TelemetryReplay *self, gint64 timestamp);
+
+/* Hand out every record up to and including @timestamp (µs), whatever the
+ * speed and whether or not the replay is running. For drivers that step
+ * through capture time themselves, such as export. */
+guint64  telemetry_replay_read_until(TelemetryReplay   *self,
+                                     gint64             timestamp,
+                                     TelemetrySampleFunc func,
+                                     gpointer           user_data);
+
+guint64  telemetry_replay_get_n_records(TelemetryReplay *self);
+gint64   telemetry_replay_get_start_time(TelemetryReplay *self);
+gint64   telemetry_replay_get_end_time(TelemetryReplay *self);
+gboolean telemetry_replay_is_finished(TelemetryReplay *self);
+
+G_END_DECLS
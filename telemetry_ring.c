@@ -0,0 +1,97 @@
+#include "telemetry_ring.h"
+
+#define CACHELINE 64
+
+struct _TelemetryRing {
+  /* Written by the producer only */
+  guint   head;
+  guint   cached_tail;   /* producer's last view of tail */
+  guint   dropped;
+  char    pad0[CACHELINE - 3 * sizeof(guint)];
+
+  /* Written by the consumer only */
+  guint   tail;
+  guint   cached_head;   /* consumer's last view of head */
+  char    pad1[CACHELINE - 2 * sizeof(guint)];
+
+  guint            mask;  /* capacity - 1, capacity is a power of two */
+  TelemetrySample *slots;
+};
+
+TelemetryRing *
+telemetry_ring_new(guint capacity)
+{
+  g_return_val_if_fail(capacity > 0 && capacity <= (1u << 30), NULL);
+
+  guint size = 1;
+  while (size < capacity)
+    size <<= 1;
+
+  TelemetryRing *ring = g_new0(TelemetryRing, 1);
+  ring->mask  = size - 1;
+  ring->slots = g_new(TelemetrySample, size);
+
+  return ring;
+}
+
+void
+telemetry_ring_free(TelemetryRing *ring)
+{
+  if (ring == NULL)
+    return;
+
+  g_free(ring->slots);
+  g_free(ring);
+}
+
+gboolean
+telemetry_ring_push(TelemetryRing *ring, const TelemetrySample *sample)
+{
+  const guint head = ring->head;
+
+  /* Only reload the consumer's index when our cached copy says "full" */
+  if (head - ring->cached_tail > ring->mask) {
+    ring->cached_tail = (guint)g_atomic_int_get((gint *)&ring->tail);
+    if (head - ring->cached_tail > ring->mask) {
+      g_atomic_int_inc((gint *)&ring->dropped);
+      return FALSE;
+    }
+  }
+
+  ring->slots[head & ring->mask] = *sample;
+
+  /* Publish the slot; the atomic store orders it after the write above */
+  g_atomic_int_set((gint *)&ring->head, (gint)(head + 1));
+  return TRUE;
+}
+
+guint
+telemetry_ring_pop(TelemetryRing *ring, TelemetrySample *out, guint max)
+{
+  guint tail = ring->tail;
+
+  if (ring->cached_head == tail)
+    ring->cached_head = (guint)g_atomic_int_get((gint *)&ring->head);
+
+  guint avail = ring->cached_head - tail;
+  guint n = MIN(avail, max);
+
+  for (guint i = 0; i < n; i++)
+    out[i] = ring->slots[(tail + i) & ring->mask];
+
+  /* Hand the slots back to the producer */
+  g_atomic_int_set((gint *)&ring->tail, (gint)(tail + n));
+  return n;
+}
+
+guint
+telemetry_ring_get_capacity(TelemetryRing *ring)
+{
+  return ring->mask + 1;
+}
+
+guint
+telemetry_ring_get_dropped(TelemetryRing *ring)
+{
+  return (guint)g_atomic_int_get((gint *)&ring->dropped);
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* One telemetry record as it travels from a data source to the UI */
+typedef struct {
+  guint32 channel;
+  gint64  timestamp;  /* µs; g_get_monotonic_time() unless the source supplies one */
+  double  value;
+} TelemetrySample;
+
+/* Bounded single-producer/single-consumer queue of samples. One thread may
+ * push and one other thread may pop, without locks. */
+typedef struct _TelemetryRing TelemetryRing;
+
+TelemetryRing *telemetry_ring_new(guint capacity);
+void           telemetry_ring_free(TelemetryRing *ring);
+
+/* Producer side. Returns FALSE (and counts a drop) when the ring is full. */
+gboolean       telemetry_ring_push(TelemetryRing *ring, const TelemetrySample *sample);
+
+/* Consumer side. Copies up to @max samples into @out, returns how many. */
+guint          telemetry_ring_pop(TelemetryRing *ring, TelemetrySample *out, guint max);
+
+guint          telemetry_ring_get_capacity(TelemetryRing *ring);
+guint          telemetry_ring_get_dropped(TelemetryRing *ring);
+
+G_END_DECLS
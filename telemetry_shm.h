@@ -0,0 +1,119 @@
+#pragma once
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* POSIX shared-memory telemetry segment, updated in place by one writer
+ * process and polled by any number of readers (TelemetryShmSource):
+ *
+ *   header | block generation × n_blocks | slot × n_channels
+ *
+ * Each slot is a seqlock: the writer makes seq odd, writes the sample and
+ * makes seq even again. A reader copies the sample between two reads of
+ * seq and keeps it only if both are the same even number. Neither side
+ * ever blocks the other, and a reader costs no syscalls.
+ *
+ * The writer bumps the slot's block generation and the header generation
+ * after each update, so readers skip blocks, or the whole segment, that
+ * did not change. Fields are in host byte order; the segment never leaves
+ * the machine. */
+
+#define TELEMETRY_SHM_MAGIC    "GTLMSHM1"
+#define TELEMETRY_SHM_VERSION  1
+#define TELEMETRY_SHM_BLOCK    64   /* channels per block generation */
+
+typedef struct {
+  char    magic[8];        /* written last, once the rest is initialized */
+  guint32 version;
+  guint32 n_channels;
+  guint64 generation;      /* bumped after every update */
+  guint8  reserved[40];
+} TelemetryShmHeader;
+
+/* One cache line per channel, so readers of one channel never share a
+ * line with the writer of another */
+typedef struct {
+  guint32 seq;             /* odd while the writer is inside */
+  guint32 reserved;
+  gint64  timestamp;       /* µs */
+  double  value;
+  guint8  pad[40];
+} TelemetryShmSlot;
+
+G_STATIC_ASSERT(sizeof(TelemetryShmHeader) == 64);
+G_STATIC_ASSERT(sizeof(TelemetryShmSlot) == 64);
+
+static inline guint
+telemetry_shm_n_blocks(guint n_channels)
+{
+  return (n_channels + TELEMETRY_SHM_BLOCK - 1) / TELEMETRY_SHM_BLOCK;
+}
+
+/* Block generations, padded to whole cache lines */
+static inline gsize
+telemetry_shm_blocks_size(guint n_channels)
+{
+  return (telemetry_shm_n_blocks(n_channels) * sizeof(guint64) + 63) & ~(gsize)63;
+}
+
+static inline gsize
+telemetry_shm_size(guint n_channels)
+{
+  return sizeof(TelemetryShmHeader) + telemetry_shm_blocks_size(n_channels) +
+         (gsize)n_channels * sizeof(TelemetryShmSlot);
+}
+
+static inline guint64 *
+telemetry_shm_blocks(const TelemetryShmHeader *header)
+{
+  return (guint64 *)(header + 1);
+}
+
+static inline TelemetryShmSlot *
+telemetry_shm_slots(const TelemetryShmHeader *header)
+{
+  return (TelemetryShmSlot *)((char *)(header + 1) + telemetry_shm_blocks_size(header->n_channels));
+}
+
+/* Writer side; one writer per segment. The counters have a single writer
+ * too, so plain load/store pairs replace read-modify-write. */
+static inline void
+telemetry_shm_write(TelemetryShmHeader *header, guint channel, gint64 timestamp, double value)
+{
+  TelemetryShmSlot *slot = &telemetry_shm_slots(header)[channel];
+  guint64 *block = &telemetry_shm_blocks(header)[channel / TELEMETRY_SHM_BLOCK];
+  const guint32 seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+
+  __atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  __atomic_store(&slot->timestamp, &timestamp, __ATOMIC_RELAXED);
+  __atomic_store(&slot->value, &value, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+
+  __atomic_store_n(block, __atomic_load_n(block, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+  __atomic_store_n(&header->generation,
+                   __atomic_load_n(&header->generation, __ATOMIC_RELAXED) + 1, __ATOMIC_RELEASE);
+}
+
+/* Reader side. Copies a consistent sample and its seq, or returns FALSE
+ * if the writer was inside the slot; the caller decides whether to retry. */
+static inline gboolean
+telemetry_shm_read(const TelemetryShmSlot *slot, guint32 *seq, gint64 *timestamp, double *value)
+{
+  const guint32 before = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+  if (before & 1)
+    return FALSE;
+
+  __atomic_load(&slot->timestamp, timestamp, __ATOMIC_RELAXED);
+  __atomic_load(&slot->value, value, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+  if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != before)
+    return FALSE;
+
+  *seq = before;
+  return TRUE;
+}
+
+G_END_DECLS
@@ -0,0 +1,263 @@
+#include "telemetry_shm_source.h"
+#include "telemetry_shm.h"
+#include <gio/gio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/* Reads of one slot per drain before leaving it to the next drain */
+#define TELEMETRY_SHM_READ_ATTEMPTS 4
+
+struct _TelemetryShmSource {
+  GObject parent_instance;
+
+  const TelemetryShmHeader *header;   /* read-only mapping */
+  const TelemetryShmSlot   *slots;
+  gsize                     map_size;
+  guint                     n_channels;
+  guint                     n_blocks;
+  gboolean                  running;
+  TelemetryRing            *tap;      /* not owned */
+
+  /* What the previous drain saw */
+  guint64  last_generation;
+  guint64 *last_block;                /* per block */
+  guint32 *last_seq;                  /* per channel; 0: never written */
+  guint64  retries;
+};
+
+static void telemetry_shm_source_source_iface_init(TelemetrySourceInterface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(TelemetryShmSource, telemetry_shm_source, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(TELEMETRY_TYPE_SOURCE,
+                                                    telemetry_shm_source_source_iface_init))
+
+/* --- Polling --- */
+static gboolean
+read_slot(TelemetryShmSource *self, const TelemetryShmSlot *slot, guint32 *seq, TelemetrySample *sample)
+{
+  for (guint attempt = 0; attempt < TELEMETRY_SHM_READ_ATTEMPTS; attempt++) {
+    if (telemetry_shm_read(slot, seq, &sample->timestamp, &sample->value))
+      return TRUE;
+    self->retries++;
+  }
+
+  return FALSE;
+}
+
+/* --- TelemetrySource --- */
+static gboolean
+telemetry_shm_source_start(TelemetrySource *source, GError **error)
+{
+  TELEMETRY_SHM_SOURCE(source)->running = TRUE;
+  return TRUE;
+}
+
+static void
+telemetry_shm_source_stop(TelemetrySource *source)
+{
+  TELEMETRY_SHM_SOURCE(source)->running = FALSE;
+}
+
+/* Skip the segment if nothing changed, then every block that did not
+ * change, then every slot whose seq is the one we last read */
+static guint
+telemetry_shm_source_drain(TelemetrySource *source, TelemetrySampleFunc func, gpointer user_data)
+{
+  TelemetryShmSource *self = TELEMETRY_SHM_SOURCE(source);
+
+  if (!self->running)
+    return 0;
+
+  const guint64 generation = __atomic_load_n(&self->header->generation, __ATOMIC_ACQUIRE);
+  if (generation == self->last_generation)
+    return 0;
+
+  const guint64 *blocks = telemetry_shm_blocks(self->header);
+  gboolean missed = FALSE;
+  guint n = 0;
+
+  for (guint b = 0; b < self->n_blocks; b++) {
+    const guint64 block = __atomic_load_n(&blocks[b], __ATOMIC_ACQUIRE);
+    const guint end = MIN((b + 1) * TELEMETRY_SHM_BLOCK, self->n_channels);
+    gboolean block_missed = FALSE;
+
+    if (block == self->last_block[b])
+      continue;
+
+    for (guint c = b * TELEMETRY_SHM_BLOCK; c < end; c++) {
+      TelemetrySample sample = { .channel = c };
+      guint32 seq;
+
+      if (__atomic_load_n(&self->slots[c].seq, __ATOMIC_RELAXED) == self->last_seq[c])
+        continue;
+
+      if (!read_slot(self, &self->slots[c], &seq, &sample)) {
+        block_missed = TRUE;
+        continue;
+      }
+      if (seq == self->last_seq[c])
+        continue;
+
+      self->last_seq[c] = seq;
+      func(&sample, user_data);
+      if (self->tap != NULL)
+        telemetry_ring_push(self->tap, &sample);
+      n++;
+    }
+
+    /* A slot the writer kept us out of is picked up by the next drain */
+    if (block_missed)
+      missed = TRUE;
+    else
+      self->last_block[b] = block;
+  }
+
+  if (!missed)
+    self->last_generation = generation;
+
+  return n;
+}
+
+static void
+telemetry_shm_source_source_iface_init(TelemetrySourceInterface *iface)
+{
+  iface->start = telemetry_shm_source_start;
+  iface->stop  = telemetry_shm_source_stop;
+  iface->drain = telemetry_shm_source_drain;
+}
+
+/* --- GObject --- */
+static void
+telemetry_shm_source_finalize(GObject *object)
+{
+  TelemetryShmSource *self = TELEMETRY_SHM_SOURCE(object);
+
+  if (self->header != NULL)
+    munmap((void *)self->header, self->map_size);
+  g_free(self->last_block);
+  g_free(self->last_seq);
+
+  G_OBJECT_CLASS(telemetry_shm_source_parent_class)->finalize(object);
+}
+
+static void
+telemetry_shm_source_class_init(TelemetryShmSourceClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->finalize = telemetry_shm_source_finalize;
+}
+
+static void
+telemetry_shm_source_init(TelemetryShmSource *self)
+{
+  self->header          = NULL;
+  self->slots           = NULL;
+  self->map_size        = 0;
+  self->n_channels      = 0;
+  self->n_blocks        = 0;
+  self->running         = FALSE;
+  self->tap             = NULL;
+  self->last_generation = 0;
+  self->last_block      = NULL;
+  self->last_seq        = NULL;
+  self->retries         = 0;
+}
+
+/* --- Public API --- */
+static gboolean
+invalid_segment(const char *name, const char *reason, GError **error)
+{
+  g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+              "%s is not a usable telemetry segment: %s", name, reason);
+  return FALSE;
+}
+
+static gboolean
+map_segment(TelemetryShmSource *self, const char *name, GError **error)
+{
+  struct stat st;
+  int fd = shm_open(name, O_RDONLY, 0);
+
+  if (fd < 0) {
+    int saved_errno = errno;
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved_errno),
+                "Cannot open shared memory %s: %s", name, g_strerror(saved_errno));
+    return FALSE;
+  }
+
+  if (fstat(fd, &st) < 0 || (gsize)st.st_size < sizeof(TelemetryShmHeader)) {
+    close(fd);
+    return invalid_segment(name, "too small for a header", error);
+  }
+
+  void *map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);  /* the mapping keeps the segment */
+
+  if (map == MAP_FAILED) {
+    int saved_errno = errno;
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved_errno),
+                "Cannot map shared memory %s: %s", name, g_strerror(saved_errno));
+    return FALSE;
+  }
+
+  self->header   = map;
+  self->map_size = st.st_size;
+
+  /* The magic is written last: once it is there, so is everything else */
+  if (memcmp(self->header->magic, TELEMETRY_SHM_MAGIC, sizeof(self->header->magic)) != 0)
+    return invalid_segment(name, "bad magic, or its writer is still setting it up", error);
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+  if (self->header->version != TELEMETRY_SHM_VERSION)
+    return invalid_segment(name, "unsupported version", error);
+  if (self->header->n_channels == 0 || self->map_size < telemetry_shm_size(self->header->n_channels))
+    return invalid_segment(name, "channel table does not fit the segment", error);
+
+  return TRUE;
+}
+
+TelemetryShmSource *
+telemetry_shm_source_new(const char *name, GError **error)
+{
+  g_return_val_if_fail(name != NULL, NULL);
+
+  TelemetryShmSource *self = g_object_new(TELEMETRY_TYPE_SHM_SOURCE, NULL);
+
+  if (!map_segment(self, name, error)) {
+    g_object_unref(self);
+    return NULL;
+  }
+
+  self->n_channels = self->header->n_channels;
+  self->n_blocks   = telemetry_shm_n_blocks(self->n_channels);
+  self->slots      = telemetry_shm_slots(self->header);
+  self->last_block = g_new0(guint64, self->n_blocks);
+  self->last_seq   = g_new0(guint32, self->n_channels);
+
+  return self;
+}
+
+void
+telemetry_shm_source_set_tap(TelemetryShmSource *self, TelemetryRing *tap)
+{
+  g_return_if_fail(TELEMETRY_IS_SHM_SOURCE(self));
+  self->tap = tap;
+}
+
+guint
+telemetry_shm_source_get_n_channels(TelemetryShmSource *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_SHM_SOURCE(self), 0);
+  return self->n_channels;
+}
+
+guint64
+telemetry_shm_source_get_retries(TelemetryShmSource *self)
+{
+  g_return_val_if_fail(TELEMETRY_IS_SHM_SOURCE(self), 0);
+  return self->retries;
+}
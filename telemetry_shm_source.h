@@ -0,0 +1,27 @@
+#pragma once
+#include <glib-object.h>
+#include "telemetry_source.h"
+
+G_BEGIN_DECLS
+
+#define TELEMETRY_TYPE_SHM_SOURCE (telemetry_shm_source_get_type())
+
+/* Polls a shared-memory telemetry segment (see telemetry_shm.h) on every
+ * drain. A drain hands out each channel whose slot changed since the
+ * previous drain, once, with its newest value: intermediate values the
+ * writer overwrote in between are not seen. No thread, no syscalls. */
+G_DECLARE_FINAL_TYPE(TelemetryShmSource, telemetry_shm_source, TELEMETRY, SHM_SOURCE, GObject)
+
+/* @name as for shm_open(), e.g. "/gauge-telemetry". The segment must
+ * already exist and be initialized by its writer. */
+TelemetryShmSource *telemetry_shm_source_new(const char *name, GError **error);
+
+/* Every sample handed out is also pushed to @tap, on the main thread */
+void     telemetry_shm_source_set_tap(TelemetryShmSource *self, TelemetryRing *tap);
+
+guint    telemetry_shm_source_get_n_channels(TelemetryShmSource *self);
+
+/* Reads that raced the writer and were retried */
+guint64  telemetry_shm_source_get_retries(TelemetryShmSource *self);
+
+G_END_DECLS
@@ -0,0 +1,274 @@
+/* Local writer for shared-memory telemetry segments (see telemetry_shm.h).
+ *
+ * By default creates the segment and writes a sine wave per channel at a
+ * fixed rate until interrupted, for running the dashboard against with
+ * --telemetry-shm. --verify instead hammers one private segment with a
+ * writer thread and --readers reader threads and checks that no read ever
+ * returns a torn sample; it prints one JSON object and exits non-zero on
+ * the first failure. */
+
+#include <glib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "telemetry_shm.h"
+
+static char    *opt_name     = NULL;   /* default "/gauge-telemetry" */
+static int      opt_channels = 1000;
+static double   opt_rate     = 100.0;  /* updates per channel per second */
+static double   opt_seconds  = 0.0;    /* 0: until interrupted */
+static gboolean opt_keep     = FALSE;
+static gboolean opt_verify   = FALSE;
+static int      opt_readers  = 4;
+
+static const GOptionEntry tool_options[] = {
+  { "name",     'n', 0, G_OPTION_ARG_STRING, &opt_name,     "Segment name (default /gauge-telemetry)", "NAME" },
+  { "channels", 'c', 0, G_OPTION_ARG_INT,    &opt_channels, "Number of channels", "N" },
+  { "rate",     'r', 0, G_OPTION_ARG_DOUBLE, &opt_rate,     "Updates per channel per second", "HZ" },
+  { "seconds",  's', 0, G_OPTION_ARG_DOUBLE, &opt_seconds,  "Run time (default: until interrupted; 5 with --verify)", "SECONDS" },
+  { "keep",     'k', 0, G_OPTION_ARG_NONE,   &opt_keep,     "Leave the segment behind on exit", NULL },
+  { "verify",   0,   0, G_OPTION_ARG_NONE,   &opt_verify,   "Run the torn-read stress check instead of writing a waveform", NULL },
+  { "readers",  0,   0, G_OPTION_ARG_INT,    &opt_readers,  "Reader threads of --verify", "N" },
+  { NULL }
+};
+
+static volatile sig_atomic_t interrupted = 0;
+
+static void
+on_signal(int signum)
+{
+  interrupted = 1;
+}
+
+/* --- Segment --- */
+static TelemetryShmHeader *
+create_segment(const char *name, guint n_channels, gsize *size, GError **error)
+{
+  int fd = shm_open(name, O_CREAT | O_RDWR | O_TRUNC, 0644);
+
+  if (fd < 0) {
+    int saved_errno = errno;
+    g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved_errno),
+                "Cannot create shared memory %s: %s", name, g_strerror(saved_errno));
+    return NULL;
+  }
+
+  *size = telemetry_shm_size(n_channels);
+
+  void *map = MAP_FAILED;
+  if (ftruncate(fd, (off_t)*size) == 0)
+    map = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+  int saved_errno = errno;
+  close(fd);
+
+  if (map == MAP_FAILED) {
+    g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved_errno),
+                "Cannot map shared memory %s: %s", name, g_strerror(saved_errno));
+    shm_unlink(name);
+    return NULL;
+  }
+
+  /* Fresh pages are zero: every seq and generation starts at 0. The magic
+   * goes last, so a reader that sees it sees the rest. */
+  TelemetryShmHeader *header = map;
+  header->version    = TELEMETRY_SHM_VERSION;
+  header->n_channels = n_channels;
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(header->magic, TELEMETRY_SHM_MAGIC, sizeof(header->magic));
+
+  return header;
+}
+
+/* --- Waveform writer --- */
+static void
+run_writer(TelemetryShmHeader *header, guint n_channels)
+{
+  const gint64 period = (gint64)(G_USEC_PER_SEC / opt_rate);
+  const gint64 start  = g_get_monotonic_time();
+  const gint64 stop   = opt_seconds > 0 ? start + (gint64)(opt_seconds * G_USEC_PER_SEC) : G_MAXINT64;
+  guint64 updates = 0;
+
+  for (gint64 next = start; !interrupted && next < stop; next += period) {
+    const gint64 now = g_get_real_time();
+    const double t = (double)(next - start) / G_USEC_PER_SEC;
+
+    for (guint c = 0; c < n_channels; c++)
+      telemetry_shm_write(header, c, now, 50.0 + 45.0 * sin(t * (0.2 + 0.01 * (c % 50)) + c));
+    updates += n_channels;
+
+    const gint64 wait = next + period - g_get_monotonic_time();
+    if (wait > 0)
+      g_usleep(wait);
+  }
+
+  g_printerr("Wrote %" G_GUINT64_FORMAT " updates\n", updates);
+}
+
+/* --- Torn-read stress check --- */
+
+/* The writer stores timestamp n and value n / 2 + channel; any mix of two
+ * updates breaks the relation. Both are exact in a double up to 2^52. */
+#define VERIFY_VALUE(n, channel) ((double)(n) * 0.5 + (double)(channel))
+
+typedef struct {
+  TelemetryShmHeader *header;
+  guint               n_channels;
+  gint                stop;      /* atomic */
+  guint64             writes;
+} VerifyShared;
+
+typedef struct {
+  VerifyShared *shared;
+  guint32       seed;
+  guint64       reads;
+  guint64       retries;
+  guint64       torn;
+  guint64       stale;           /* seq went backwards */
+} VerifyReader;
+
+static gpointer
+verify_write(gpointer data)
+{
+  VerifyShared *shared = data;
+  guint64 n = 0;
+
+  /* Round-robin over a small window of channels so readers hit slots
+   * the writer is inside as often as possible */
+  const guint hot = MIN(shared->n_channels, 8);
+
+  while (!g_atomic_int_get(&shared->stop)) {
+    const guint c = (guint)(n % hot);
+    n++;
+    telemetry_shm_write(shared->header, c, (gint64)n, VERIFY_VALUE(n, c));
+  }
+
+  shared->writes = n;
+  return NULL;
+}
+
+static gpointer
+verify_read(gpointer data)
+{
+  VerifyReader *reader = data;
+  VerifyShared *shared = reader->shared;
+  const TelemetryShmSlot *slots = telemetry_shm_slots(shared->header);
+  const guint hot = MIN(shared->n_channels, 8);
+  g_autofree guint32 *last_seq = g_new0(guint32, hot);
+  GRand *rand = g_rand_new_with_seed(reader->seed);
+
+  while (!g_atomic_int_get(&shared->stop)) {
+    const guint c = g_rand_int_range(rand, 0, (gint32)hot);
+    guint32 seq;
+    gint64 timestamp;
+    double value;
+
+    if (!telemetry_shm_read(&slots[c], &seq, &timestamp, &value)) {
+      reader->retries++;
+      continue;
+    }
+
+    reader->reads++;
+    if (seq == 0)
+      continue;  /* not written yet */
+    if (value != VERIFY_VALUE(timestamp, c))
+      reader->torn++;
+    if ((gint32)(seq - last_seq[c]) < 0)
+      reader->stale++;
+    last_seq[c] = seq;
+  }
+
+  g_rand_free(rand);
+  return NULL;
+}
+
+static int
+run_verify(TelemetryShmHeader *header, guint n_channels)
+{
+  const guint n_readers = (guint)MAX(opt_readers, 1);
+  const double seconds = opt_seconds > 0 ? opt_seconds : 5.0;
+  VerifyShared shared = { header, n_channels, 0, 0 };
+  VerifyReader *readers = g_new0(VerifyReader, n_readers);
+  GThread **threads = g_new(GThread *, n_readers);
+
+  for (guint i = 0; i < n_readers; i++) {
+    readers[i].shared = &shared;
+    readers[i].seed   = i + 1;
+    threads[i] = g_thread_new("shm-verify-read", verify_read, &readers[i]);
+  }
+  GThread *writer = g_thread_new("shm-verify-write", verify_write, &shared);
+
+  for (gint64 end = g_get_monotonic_time() + (gint64)(seconds * G_USEC_PER_SEC);
+       !interrupted && g_get_monotonic_time() < end;)
+    g_usleep(10000);
+
+  g_atomic_int_set(&shared.stop, 1);
+  g_thread_join(writer);
+
+  guint64 reads = 0, retries = 0, torn = 0, stale = 0;
+  for (guint i = 0; i < n_readers; i++) {
+    g_thread_join(threads[i]);
+    reads   += readers[i].reads;
+    retries += readers[i].retries;
+    torn    += readers[i].torn;
+    stale   += readers[i].stale;
+  }
+
+  g_print("{\"readers\": %u, \"seconds\": %.1f, \"writes\": %" G_GUINT64_FORMAT
+          ", \"reads\": %" G_GUINT64_FORMAT ", \"retries\": %" G_GUINT64_FORMAT
+          ", \"torn\": %" G_GUINT64_FORMAT ", \"stale\": %" G_GUINT64_FORMAT "}\n",
+          n_readers, seconds, shared.writes, reads, retries, torn, stale);
+
+  g_free(threads);
+  g_free(readers);
+
+  return torn == 0 && stale == 0 ? 0 : 1;
+}
+
+/* --- Main --- */
+int
+main(int argc, char **argv)
+{
+  g_autoptr(GOptionContext) context = g_option_context_new("- write a shared-memory telemetry segment");
+  g_autoptr(GError) error = NULL;
+
+  g_option_context_add_main_entries(context, tool_options, NULL);
+  if (!g_option_context_parse(context, &argc, &argv, &error)) {
+    g_printerr("%s\n", error->message);
+    return 2;
+  }
+  if (opt_channels <= 0 || opt_rate <= 0) {
+    g_printerr("--channels and --rate must be positive\n");
+    return 2;
+  }
+
+  /* The stress check never touches a segment the dashboard may be reading */
+  g_autofree char *name = opt_verify ? g_strdup_printf("/gauge-telemetry-verify-%d", (int)getpid())
+                                     : g_strdup(opt_name != NULL ? opt_name : "/gauge-telemetry");
+  gsize size;
+  TelemetryShmHeader *header = create_segment(name, (guint)opt_channels, &size, &error);
+  if (header == NULL) {
+    g_printerr("%s\n", error->message);
+    return 1;
+  }
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+
+  int status = 0;
+  if (opt_verify)
+    status = run_verify(header, (guint)opt_channels);
+  else
+    run_writer(header, (guint)opt_channels);
+
+  munmap(header, size);
+  if (opt_verify || !opt_keep)
+    shm_unlink(name);
+
+  return status;
+}
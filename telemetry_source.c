@@ -0,0 +1,39 @@
+#include "telemetry_source.h"
+
+G_DEFINE_INTERFACE(TelemetrySource, telemetry_source, G_TYPE_OBJECT)
+
+static void
+telemetry_source_default_init(TelemetrySourceInterface *iface)
+{
+}
+
+gboolean
+telemetry_source_start(TelemetrySource *self, GError **error)
+{
+  g_return_val_if_fail(TELEMETRY_IS_SOURCE(self), FALSE);
+
+  TelemetrySourceInterface *iface = TELEMETRY_SOURCE_GET_IFACE(self);
+  if (iface->start == NULL)
+    return TRUE;
+
+  return iface->start(self, error);
+}
+
+void
+telemetry_source_stop(TelemetrySource *self)
+{
+  g_return_if_fail(TELEMETRY_IS_SOURCE(self));
+
+  TelemetrySourceInterface *iface = TELEMETRY_SOURCE_GET_IFACE(self);
+  if (iface->stop)
+    iface->stop(self);
+}
+
+guint
+telemetry_source_drain(TelemetrySource *self, TelemetrySampleFunc func, gpointer user_data)
+{
+  g_return_val_if_fail(TELEMETRY_IS_SOURCE(self), 0);
+  g_return_val_if_fail(func != NULL, 0);
+
+  return TELEMETRY_SOURCE_GET_IFACE(self)->drain(self, func, user_data);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <glib-object.h>
+#include "telemetry_ring.h"
+
+G_BEGIN_DECLS
+
+#define TELEMETRY_TYPE_SOURCE (telemetry_source_get_type())
+
+/* A producer of telemetry samples. Implementations may do their I/O on
+ * any thread, but drain() is always called on the main thread. */
+G_DECLARE_INTERFACE(TelemetrySource, telemetry_source, TELEMETRY, SOURCE, GObject)
+
+typedef void (*TelemetrySampleFunc)(const TelemetrySample *sample, gpointer user_data);
+
+struct _TelemetrySourceInterface {
+  GTypeInterface parent_iface;
+
+  gboolean (*start)(TelemetrySource *self, GError **error);
+  void     (*stop) (TelemetrySource *self);
+  guint    (*drain)(TelemetrySource *self, TelemetrySampleFunc func, gpointer user_data);
+};
+
+gboolean telemetry_source_start(TelemetrySource *self, GError **error);
+void     telemetry_source_stop (TelemetrySource *self);
+
+/* Hands the samples received since the last drain to @func, oldest first.
+ * Implementations may stop after a bounded number and keep the rest for
+ * the next drain. */
+guint    telemetry_source_drain(TelemetrySource    *self,
+                                TelemetrySampleFunc func,
+                                gpointer            user_data);
+
+G_END_DECLS
@@ -0,0 +1,312 @@
+#include "telemetry_stream.h"
+#include <gio/gio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#define TELEMETRY_STREAM_RING_SIZE  65536
+#define TELEMETRY_STREAM_READ_SIZE  65536
+#define TELEMETRY_STREAM_DRAIN_CHUNK  256
+
+/* Upper bound on samples handed out per drain: one ring's worth, so a
+ * producer that keeps writing cannot hold the main thread; the rest
+ * stays in the ring for the next frame */
+#define TELEMETRY_STREAM_MAX_PER_DRAIN TELEMETRY_STREAM_RING_SIZE
+
+struct _TelemetryStream {
+  GObject parent_instance;
+
+  int            fd;
+  TelemetryRing *ring;          /* worker → main thread */
+  TelemetryRing *tap;           /* worker → a second consumer, not owned */
+  GThread       *worker;
+  GCancellable  *cancellable;   /* wakes the worker out of poll() */
+  guint          parse_errors;  /* atomic, written by the worker */
+};
+
+static void telemetry_stream_source_iface_init(TelemetrySourceInterface *iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(TelemetryStream, telemetry_stream, G_TYPE_OBJECT,
+                              G_IMPLEMENT_INTERFACE(TELEMETRY_TYPE_SOURCE,
+                                                    telemetry_stream_source_iface_init))
+
+/* --- Worker thread --- */
+
+/* "<channel> <value>" or "<channel> <timestamp-µs> <value>" */
+static gboolean
+parse_line(const char *line, TelemetrySample *sample)
+{
+  char *end = NULL;
+  const char *p = line;
+
+  while (g_ascii_isspace(*p))
+    p++;
+  if (*p == '\0' || *p == '#')
+    return FALSE;
+
+  guint64 channel = g_ascii_strtoull(p, &end, 10);
+  if (end == p || channel > G_MAXUINT32)
+    return FALSE;
+  p = end;
+
+  /* An integer followed by another number is a timestamp */
+  gint64 ts = g_ascii_strtoll(p, &end, 10);
+  if (end != p && g_ascii_isspace(*end)) {
+    const char *v = end;
+    double value = g_ascii_strtod(v, &end);
+    if (end != v) {
+      sample->channel   = (guint32)channel;
+      sample->timestamp = ts;
+      sample->value     = value;
+      return TRUE;
+    }
+  }
+
+  double value = g_ascii_strtod(p, &end);
+  if (end == p)
+    return FALSE;
+
+  sample->channel   = (guint32)channel;
+  sample->timestamp = g_get_monotonic_time();
+  sample->value     = value;
+  return TRUE;
+}
+
+static gpointer
+telemetry_stream_worker(gpointer data)
+{
+  TelemetryStream *self = data;
+  char *buf = g_malloc(TELEMETRY_STREAM_READ_SIZE);
+  gsize fill = 0;
+
+  GPollFD fds[2] = {
+    { self->fd, G_IO_IN | G_IO_HUP | G_IO_ERR, 0 },
+    { -1, G_IO_IN, 0 },
+  };
+  g_cancellable_make_pollfd(self->cancellable, &fds[1]);
+
+  while (!g_cancellable_is_cancelled(self->cancellable)) {
+    if (g_poll(fds, G_N_ELEMENTS(fds), -1) < 0) {
+      if (errno == EINTR)
+        continue;
+      break;
+    }
+    if (fds[1].revents)
+      break;
+
+    ssize_t n = read(self->fd, buf + fill, TELEMETRY_STREAM_READ_SIZE - fill);
+    if (n < 0 && (errno == EINTR || errno == EAGAIN))
+      continue;
+    if (n <= 0)
+      break;  /* EOF or error: the producer is gone */
+
+    fill += n;
+
+    /* Parse every complete line, keep the partial tail for the next read */
+    char *line = buf;
+    char *nl;
+    while ((nl = memchr(line, '\n', fill - (line - buf))) != NULL) {
+      TelemetrySample sample;
+
+      *nl = '\0';
+      if (parse_line(line, &sample)) {
+        telemetry_ring_push(self->ring, &sample);
+        if (self->tap != NULL)
+          telemetry_ring_push(self->tap, &sample);
+      } else if (*line != '\0' && *line != '#')
+        g_atomic_int_inc((gint *)&self->parse_errors);
+      line = nl + 1;
+    }
+
+    fill -= line - buf;
+    if (fill == TELEMETRY_STREAM_READ_SIZE) {
+      /* A single line longer than the buffer: discard it */
+      g_atomic_int_inc((gint *)&self->parse_errors);
+      fill = 0;
+    } else if (line != buf) {
+      memmove(buf, line, fill);
+    }
+  }
+
+  g_cancellable_release_fd(self->cancellable);
+  g_free(buf);
+  return NULL;
+}
+
+/* --- TelemetrySource --- */
+static gboolean
+telemetry_stream_start(TelemetrySource *source, GError **error)
+{
+  TelemetryStream *self = TELEMETRY_STREAM(source);
+
+  if (self->worker != NULL)
+    return TRUE;
+
+  g_cancellable_reset(self->cancellable);
+  self->worker = g_thread_try_new("telemetry-stream", telemetry_stream_worker, self, error);
+
+  return self->worker != NULL;
+}
+
+static void
+telemetry_stream_stop(TelemetrySource *source)
+{
+  TelemetryStream *self = TELEMETRY_STREAM(source);
+
+  if (self->worker == NULL)
+    return;
+
+  g_cancellable_cancel(self->cancellable);
+  g_thread_join(self->worker);
+  self->worker = NULL;
+}
+
+static guint
+telemetry_stream_drain(TelemetrySource *source, TelemetrySampleFunc func, gpointer user_data)
+{
+  TelemetryStream *self = TELEMETRY_STREAM(source);
+  TelemetrySample chunk[TELEMETRY_STREAM_DRAIN_CHUNK];
+  guint total = 0;
+  guint n;
+
+  while (total < TELEMETRY_STREAM_MAX_PER_DRAIN &&
+         (n = telemetry_ring_pop(self->ring, chunk, G_N_ELEMENTS(chunk))) > 0) {
+    for (guint i = 0; i < n; i++)
+      func(&chunk[i], user_data);
+    total += n;
+  }
+
+  return total;
+}
+
+static void
+telemetry_stream_source_iface_init(TelemetrySourceInterface *iface)
+{
+  iface->start = telemetry_stream_start;
+  iface->stop  = telemetry_stream_stop;
+  iface->drain = telemetry_stream_drain;
+}
+
+/* --- GObject --- */
+static void
+telemetry_stream_finalize(GObject *object)
+{
+  TelemetryStream *self = TELEMETRY_STREAM(object);
+
+  telemetry_stream_stop(TELEMETRY_SOURCE(self));
+
+  if (self->fd >= 0)
+    close(self->fd);
+  g_clear_object(&self->cancellable);
+  telemetry_ring_free(self->ring);
+
+  G_OBJECT_CLASS(telemetry_stream_parent_class)->finalize(object);
+}
+
+static void
+telemetry_stream_class_init(TelemetryStreamClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->finalize = telemetry_stream_finalize;
+}
+
+static void
+telemetry_stream_init(TelemetryStream *self)
+{
+  self->fd           = -1;
+  self->ring         = telemetry_ring_new(TELEMETRY_STREAM_RING_SIZE);
+  self->tap          = NULL;
+  self->worker       = NULL;
+  self->cancellable  = g_cancellable_new();
+  self->parse_errors = 0;
+}
+
+/* --- Public API --- */
+TelemetryStream *
+telemetry_stream_new_for_fd(int fd)
+{
+  g_return_val_if_fail(fd >= 0, NULL);
+
+  TelemetryStream *self = g_object_new(TELEMETRY_TYPE_STREAM, NULL);
+  self->fd = fd;
+  return self;
+}
+
+static int
+connect_unix_socket(const char *path)
+{
+  struct sockaddr_un addr = { .sun_family = AF_UNIX };
+
+  if (strlen(path) >= sizeof(addr.sun_path)) {
+    errno = ENAMETOOLONG;
+    return -1;
+  }
+  strcpy(addr.sun_path, path);
+
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0)
+    return -1;
+
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return -1;
+  }
+
+  return fd;
+}
+
+TelemetryStream *
+telemetry_stream_new_for_path(const char *path, GError **error)
+{
+  struct stat st;
+  int fd;
+
+  g_return_val_if_fail(path != NULL, NULL);
+
+  const gboolean have_stat = stat(path, &st) == 0;
+
+  if (g_strcmp0(path, "-") == 0)
+    fd = dup(STDIN_FILENO);
+  else if (have_stat && S_ISSOCK(st.st_mode))
+    fd = connect_unix_socket(path);
+  else if (have_stat && S_ISFIFO(st.st_mode))
+    fd = open(path, O_RDWR | O_CLOEXEC);  /* our own writer end: no EOF between producers */
+  else
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0) {
+    int saved = errno;
+    g_set_error(error, G_IO_ERROR, g_io_error_from_errno(saved),
+                "Cannot open telemetry source %s: %s", path, g_strerror(saved));
+    return NULL;
+  }
+
+  return telemetry_stream_new_for_fd(fd);
+}
+
+guint
+telemetry_stream_get_parse_errors(TelemetryStream *self)
+{
+  return (guint)g_atomic_int_get((gint *)&self->parse_errors);
+}
+
+void
+telemetry_stream_set_tap(TelemetryStream *self, TelemetryRing *tap)
+{
+  g_return_if_fail(TELEMETRY_IS_STREAM(self));
+  g_return_if_fail(self->worker == NULL);
+
+  self->tap = tap;
+}
+
+guint
+telemetry_stream_get_dropped(TelemetryStream *self)
+{
+  return telemetry_ring_get_dropped(self->ring);
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <glib-object.h>
+#include "telemetry_source.h"
+
+G_BEGIN_DECLS
+
+#define TELEMETRY_TYPE_STREAM (telemetry_stream_get_type())
+
+/* Text telemetry read from a file descriptor on a worker thread. One
+ * sample per line: "<channel> <value>" or "<channel> <timestamp-µs> <value>". */
+G_DECLARE_FINAL_TYPE(TelemetryStream, telemetry_stream, TELEMETRY, STREAM, GObject)
+
+/* Takes ownership of @fd; a pipe or socketpair end works as a stand-in */
+TelemetryStream *telemetry_stream_new_for_fd(int fd);
+
+/* Opens a FIFO, Unix stream socket, regular file or "-" for stdin */
+TelemetryStream *telemetry_stream_new_for_path(const char *path, GError **error);
+
+/* Every parsed sample is also pushed to @tap, from the worker, so another
+ * thread sees it without waiting for the main loop. @tap must outlive the
+ * stream's run; set it only while stopped. */
+void             telemetry_stream_set_tap(TelemetryStream *self, TelemetryRing *tap);
+
+guint            telemetry_stream_get_parse_errors(TelemetryStream *self);
+guint            telemetry_stream_get_dropped(TelemetryStream *self);
+
+G_END_DECLS
@@ -0,0 +1,351 @@
+#include "trend_buffer.h"
+#include <math.h>
+#include <string.h>
+
+struct _TrendBuffer {
+  grefcount ref_count;
+
+  guint    capacity;    /* multiple of TREND_BLOCK */
+  guint    head;        /* next slot to write */
+  guint64  total;
+
+  float   *values;      /* NULL until the first append or after a release */
+  float   *block_min;   /* per block, over the samples written this lap */
+  float   *block_max;
+};
+
+/* --- Min/max kernels --- */
+#if defined(__GNUC__)
+/* Four lanes with GCC vector extensions: SSE on x86-64 and NEON on
+ * arm64 without extra flags, plain scalar code elsewhere. Wider vectors
+ * would change the calling convention of these helpers without AVX. */
+typedef float v4sf __attribute__((vector_size(16)));
+typedef int   v4si __attribute__((vector_size(16)));
+
+static inline v4sf
+v4_load(const float *p)
+{
+  v4sf v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline v4sf
+v4_splat(float x)
+{
+  return (v4sf) { x, x, x, x };
+}
+
+static inline v4sf
+v4_min(v4sf a, v4sf b)
+{
+  v4si m = a < b;
+  return (v4sf)(((v4si)a & m) | ((v4si)b & ~m));
+}
+
+static inline v4sf
+v4_max(v4sf a, v4sf b)
+{
+  v4si m = a > b;
+  return (v4sf)(((v4si)a & m) | ((v4si)b & ~m));
+}
+
+static inline float
+v4_hmin(v4sf v)
+{
+  float r = v[0];
+  for (int i = 1; i < 4; i++)
+    r = MIN(r, v[i]);
+  return r;
+}
+
+static inline float
+v4_hmax(v4sf v)
+{
+  float r = v[0];
+  for (int i = 1; i < 4; i++)
+    r = MAX(r, v[i]);
+  return r;
+}
+
+/* Folds @n values into *mn and *mx */
+static void
+kernel_minmax(const float *v, gsize n, float *mn, float *mx)
+{
+  gsize i = 0;
+
+  if (n >= 4) {
+    v4sf vmin = v4_splat(*mn), vmax = v4_splat(*mx);
+
+    for (; i + 4 <= n; i += 4) {
+      v4sf x = v4_load(v + i);
+      vmin = v4_min(vmin, x);
+      vmax = v4_max(vmax, x);
+    }
+    *mn = v4_hmin(vmin);
+    *mx = v4_hmax(vmax);
+  }
+
+  for (; i < n; i++) {
+    *mn = MIN(*mn, v[i]);
+    *mx = MAX(*mx, v[i]);
+  }
+}
+
+static void
+kernel_min(const float *v, gsize n, float *mn)
+{
+  gsize i = 0;
+
+  if (n >= 4) {
+    v4sf vmin = v4_splat(*mn);
+
+    for (; i + 4 <= n; i += 4)
+      vmin = v4_min(vmin, v4_load(v + i));
+    *mn = v4_hmin(vmin);
+  }
+
+  for (; i < n; i++)
+    *mn = MIN(*mn, v[i]);
+}
+
+static void
+kernel_max(const float *v, gsize n, float *mx)
+{
+  gsize i = 0;
+
+  if (n >= 4) {
+    v4sf vmax = v4_splat(*mx);
+
+    for (; i + 4 <= n; i += 4)
+      vmax = v4_max(vmax, v4_load(v + i));
+    *mx = v4_hmax(vmax);
+  }
+
+  for (; i < n; i++)
+    *mx = MAX(*mx, v[i]);
+}
+#else
+static void
+kernel_minmax(const float *v, gsize n, float *mn, float *mx)
+{
+  for (gsize i = 0; i < n; i++) {
+    *mn = MIN(*mn, v[i]);
+    *mx = MAX(*mx, v[i]);
+  }
+}
+
+static void
+kernel_min(const float *v, gsize n, float *mn)
+{
+  for (gsize i = 0; i < n; i++)
+    *mn = MIN(*mn, v[i]);
+}
+
+static void
+kernel_max(const float *v, gsize n, float *mx)
+{
+  for (gsize i = 0; i < n; i++)
+    *mx = MAX(*mx, v[i]);
+}
+#endif
+
+/* --- Lifecycle --- */
+TrendBuffer *
+trend_buffer_new(guint capacity)
+{
+  g_return_val_if_fail(capacity > 0 && capacity <= G_MAXUINT - TREND_BLOCK, NULL);
+
+  capacity = (capacity + TREND_BLOCK - 1) / TREND_BLOCK * TREND_BLOCK;
+
+  /* Storage comes with the first sample: channels that never get one
+   * cost nothing */
+  TrendBuffer *self = g_new0(TrendBuffer, 1);
+  g_ref_count_init(&self->ref_count);
+  self->capacity = capacity;
+
+  return self;
+}
+
+TrendBuffer *
+trend_buffer_ref(TrendBuffer *self)
+{
+  g_return_val_if_fail(self != NULL, NULL);
+
+  g_ref_count_inc(&self->ref_count);
+  return self;
+}
+
+void
+trend_buffer_unref(TrendBuffer *self)
+{
+  g_return_if_fail(self != NULL);
+
+  if (!g_ref_count_dec(&self->ref_count))
+    return;
+
+  g_free(self->values);
+  g_free(self->block_min);
+  g_free(self->block_max);
+  g_free(self);
+}
+
+/* --- Storage --- */
+static void
+allocate_storage(TrendBuffer *self)
+{
+  self->values    = g_new(float, self->capacity);
+  self->block_min = g_new(float, self->capacity / TREND_BLOCK);
+  self->block_max = g_new(float, self->capacity / TREND_BLOCK);
+}
+
+void
+trend_buffer_release(TrendBuffer *self)
+{
+  g_clear_pointer(&self->values, g_free);
+  g_clear_pointer(&self->block_min, g_free);
+  g_clear_pointer(&self->block_max, g_free);
+  trend_buffer_clear(self);
+}
+
+gsize
+trend_buffer_get_bytes(TrendBuffer *self)
+{
+  if (self->values == NULL)
+    return 0;
+
+  return (gsize)self->capacity * sizeof(float) +
+         2 * (gsize)(self->capacity / TREND_BLOCK) * sizeof(float);
+}
+
+/* --- Appending --- */
+void
+trend_buffer_append(TrendBuffer *self, float value)
+{
+  const guint h = self->head;
+  const guint b = h / TREND_BLOCK;
+
+  if (G_UNLIKELY(self->values == NULL))
+    allocate_storage(self);
+
+  self->values[h] = value;
+
+  /* Entering a block restarts its summary: what it held is a lap old */
+  if (h % TREND_BLOCK == 0) {
+    self->block_min[b] = value;
+    self->block_max[b] = value;
+  } else {
+    self->block_min[b] = MIN(self->block_min[b], value);
+    self->block_max[b] = MAX(self->block_max[b], value);
+  }
+
+  self->head = (h + 1 == self->capacity) ? 0 : h + 1;
+  self->total++;
+}
+
+void
+trend_buffer_clear(TrendBuffer *self)
+{
+  self->head  = 0;
+  self->total = 0;
+}
+
+guint
+trend_buffer_get_capacity(TrendBuffer *self)
+{
+  return self->capacity;
+}
+
+guint
+trend_buffer_get_length(TrendBuffer *self)
+{
+  return (guint)MIN(self->total, (guint64)self->capacity);
+}
+
+guint64
+trend_buffer_get_total(TrendBuffer *self)
+{
+  return self->total;
+}
+
+/* --- Decimation --- */
+
+/* Folds slots [start, end) into *mn and *mx, without wrapping. Whole
+ * blocks come from the summaries, except the block being overwritten:
+ * its summary covers only the part written this lap. */
+static void
+range_minmax(TrendBuffer *self, guint start, guint end, float *mn, float *mx)
+{
+  const gboolean head_partial = self->head % TREND_BLOCK != 0;
+  const guint    head_block   = self->head / TREND_BLOCK;
+
+  while (start < end) {
+    const guint b        = start / TREND_BLOCK;
+    const guint b_start  = b * TREND_BLOCK;
+    const guint b_end    = b_start + TREND_BLOCK;
+    const gboolean whole = start == b_start && end >= b_end &&
+                           !(head_partial && b == head_block);
+
+    if (whole) {
+      guint nb = (end - start) / TREND_BLOCK;
+
+      if (head_partial && head_block > b && head_block < b + nb)
+        nb = head_block - b;
+
+      kernel_min(self->block_min + b, nb, mn);
+      kernel_max(self->block_max + b, nb, mx);
+      start += nb * TREND_BLOCK;
+    } else {
+      const guint stop = MIN(end, b_end);
+
+      kernel_minmax(self->values + start, stop - start, mn, mx);
+      start = stop;
+    }
+  }
+}
+
+void
+trend_buffer_decimate(TrendBuffer *self,
+                      guint        window,
+                      guint        n_columns,
+                      float       *out_min,
+                      float       *out_max)
+{
+  g_return_if_fail(self != NULL);
+
+  if (n_columns == 0)
+    return;
+  if (window == 0)
+    window = self->capacity;
+
+  const guint64 len    = trend_buffer_get_length(self);
+  const guint   oldest = self->total > self->capacity ? self->head : 0;
+  const gint64  offset = (gint64)len - (gint64)window;  /* window start, in held samples */
+
+  for (guint c = 0; c < n_columns; c++) {
+    gint64 first = offset + (gint64)((guint64)window * c / n_columns);
+    gint64 last  = offset + (gint64)((guint64)window * (c + 1) / n_columns);
+    float mn = INFINITY, mx = -INFINITY;
+
+    /* Narrow windows repeat a sample across several columns */
+    if (last <= first)
+      last = first + 1;
+    first = MAX(first, 0);
+    last  = MIN(last, (gint64)len);
+
+    if (first < last) {
+      guint start = (guint)((oldest + (guint64)first) % self->capacity);
+      guint count = (guint)(last - first);
+
+      if ((guint64)start + count <= self->capacity) {
+        range_minmax(self, start, start + count, &mn, &mx);
+      } else {
+        range_minmax(self, start, self->capacity, &mn, &mx);
+        range_minmax(self, 0, start + count - self->capacity, &mn, &mx);
+      }
+    }
+
+    out_min[c] = mn;
+    out_max[c] = mx;
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Samples per summary block. Every block keeps the min and max of its
+ * samples, so a long span is reduced block by block instead of sample
+ * by sample. */
+#define TREND_BLOCK 256
+
+/* Fixed-capacity history of one channel. Appending is O(1) and only
+ * allocates for the first sample; the oldest sample is overwritten once
+ * the buffer is full.
+ * Main thread only, like the widgets drawing it. */
+typedef struct _TrendBuffer TrendBuffer;
+
+/* @capacity is rounded up to a multiple of TREND_BLOCK */
+TrendBuffer *trend_buffer_new(guint capacity);
+TrendBuffer *trend_buffer_ref(TrendBuffer *self);
+void         trend_buffer_unref(TrendBuffer *self);
+
+void    trend_buffer_append(TrendBuffer *self, float value);
+void    trend_buffer_clear(TrendBuffer *self);
+
+/* Free the sample storage, dropping the history; the next append
+ * allocates it again */
+void    trend_buffer_release(TrendBuffer *self);
+gsize   trend_buffer_get_bytes(TrendBuffer *self);        /* storage held */
+
+guint   trend_buffer_get_capacity(TrendBuffer *self);
+guint   trend_buffer_get_length(TrendBuffer *self);   /* samples held */
+guint64 trend_buffer_get_total(TrendBuffer *self);    /* samples ever appended */
+
+/* Reduce the newest @window samples to @n_columns min/max pairs, oldest
+ * column first. The window is right-aligned: columns before the first
+ * held sample come back empty, with min > max. Cost grows with
+ * @n_columns and @window / TREND_BLOCK, not with @window itself. */
+void    trend_buffer_decimate(TrendBuffer *self,
+                              guint        window,
+                              guint        n_columns,
+                              float       *out_min,
+                              float       *out_max);
+
+G_END_DECLS
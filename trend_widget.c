@@ -0,0 +1,356 @@
+#include "trend_widget.h"
+#include <math.h>
+
+/* Properties */
+enum {
+  PROP_0,
+  PROP_MIN,
+  PROP_MAX,
+  PROP_WINDOW,
+  N_PROPERTIES
+};
+
+static GParamSpec *obj_properties[N_PROPERTIES] = { NULL, };
+
+/* Instance struct */
+struct _TrendWidget {
+  GtkWidget parent_instance;
+
+  double min;
+  double max;
+  guint  window;          /* samples across the full width, 0 = buffer capacity */
+
+  TrendBuffer *buffer;
+
+  float *col_min;         /* decimated columns, reused between frames */
+  float *col_max;
+  guint  n_cols;          /* allocated columns */
+
+  /* Bars of the last snapshot, and what they were built from */
+  GskRenderNode *bars;
+  guint64        bars_total;
+  guint          bars_length;
+  int            bars_width;
+  int            bars_height;
+  int            bars_scale;
+};
+
+G_DEFINE_TYPE(TrendWidget, trend_widget, GTK_TYPE_WIDGET)
+
+/* --- Helpers --- */
+
+/* Grow the column arrays only when the widget gets wider */
+static void
+ensure_columns(TrendWidget *self, guint n)
+{
+  if (n <= self->n_cols)
+    return;
+
+  self->col_min = g_renew(float, self->col_min, n);
+  self->col_max = g_renew(float, self->col_max, n);
+  self->n_cols  = n;
+}
+
+static inline double
+y_from_value(TrendWidget *self, double v, int h)
+{
+  const double range = self->max - self->min;
+  double frac = range > 0.0 ? (v - self->min) / range : 0.0;
+
+  return h - CLAMP(frac, 0.0, 1.0) * h;
+}
+
+static inline void
+invalidate_bars(TrendWidget *self)
+{
+  g_clear_pointer(&self->bars, gsk_render_node_unref);
+}
+
+/* --- Snapshot --- */
+
+/* One color node per run of columns with the same bar. Each bar is
+ * stretched to touch its neighbour so steep edges stay connected. */
+static GskRenderNode *
+trend_widget_build_bars(TrendWidget *self, guint n, int h, int scale)
+{
+  static const GdkRGBA bar_color = { 0.21f, 0.52f, 0.89f, 1.0f };
+  GtkSnapshot *snapshot = gtk_snapshot_new();
+  const float px = 1.0f / scale;
+  float prev_min = INFINITY, prev_max = -INFINITY;
+  float run_top = 0, run_height = 0;
+  guint run_start = 0, run_length = 0;
+
+  for (guint c = 0; c <= n; c++) {
+    float top = 0, height = 0;
+    gboolean empty = TRUE;
+
+    if (c < n && self->col_min[c] <= self->col_max[c]) {
+      float lo = self->col_min[c];
+      float hi = self->col_max[c];
+
+      if (prev_min <= prev_max) {
+        if (lo > prev_max) lo = prev_max;
+        if (hi < prev_min) hi = prev_min;
+      }
+      prev_min = self->col_min[c];
+      prev_max = self->col_max[c];
+
+      top    = (float)y_from_value(self, hi, h);
+      height = MAX((float)y_from_value(self, lo, h) - top, px);
+      empty  = FALSE;
+    } else {
+      prev_min = INFINITY;  /* no samples yet */
+      prev_max = -INFINITY;
+    }
+
+    if (run_length > 0 && (empty || top != run_top || height != run_height)) {
+      gtk_snapshot_append_color(snapshot, &bar_color,
+                                &GRAPHENE_RECT_INIT(run_start * px, run_top,
+                                                    run_length * px, run_height));
+      run_length = 0;
+    }
+    if (!empty && run_length++ == 0) {
+      run_start  = c;
+      run_top    = top;
+      run_height = height;
+    }
+  }
+
+  return gtk_snapshot_free_to_node(snapshot);
+}
+
+static void
+trend_widget_snapshot(GtkWidget *widget, GtkSnapshot *snapshot)
+{
+  TrendWidget *self = TREND_WIDGET(widget);
+  const int w = gtk_widget_get_width(widget);
+  const int h = gtk_widget_get_height(widget);
+  const int scale = gtk_widget_get_scale_factor(widget);
+  const guint n = (guint)(w * scale);
+
+  if (self->buffer == NULL || n == 0 || h <= 0 || trend_buffer_get_length(self->buffer) == 0)
+    return;
+
+  /* Frames without new samples reuse the bars as they are */
+  const guint64 total  = trend_buffer_get_total(self->buffer);
+  const guint   length = trend_buffer_get_length(self->buffer);
+
+  if (self->bars == NULL || self->bars_total != total || self->bars_length != length ||
+      self->bars_width != w || self->bars_height != h || self->bars_scale != scale) {
+    /* Cost scales with the width in device pixels, not with the samples */
+    ensure_columns(self, n);
+    trend_buffer_decimate(self->buffer, self->window, n, self->col_min, self->col_max);
+
+    invalidate_bars(self);
+    self->bars        = trend_widget_build_bars(self, n, h, scale);
+    self->bars_total  = total;
+    self->bars_length = length;
+    self->bars_width  = w;
+    self->bars_height = h;
+    self->bars_scale  = scale;
+  }
+
+  if (self->bars != NULL)
+    gtk_snapshot_append_node(snapshot, self->bars);
+}
+
+/* --- Measure --- */
+static void
+trend_widget_measure(GtkWidget *widget,
+                     GtkOrientation orientation,
+                     int for_size,
+                     int *minimum,
+                     int *natural,
+                     int *minimum_baseline,
+                     int *natural_baseline)
+{
+  const int base = orientation == GTK_ORIENTATION_HORIZONTAL ? 240 : 64;
+  if (minimum) *minimum = orientation == GTK_ORIENTATION_HORIZONTAL ? 32 : 16;
+  if (natural) *natural = base;
+  if (minimum_baseline) *minimum_baseline = -1;
+  if (natural_baseline) *natural_baseline = -1;
+}
+
+/* --- Properties --- */
+static void
+trend_widget_set_property(GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+  TrendWidget *self = TREND_WIDGET(object);
+  switch (prop_id) {
+  case PROP_MIN:
+    trend_widget_set_range(self, g_value_get_double(value), self->max);
+    break;
+  case PROP_MAX:
+    trend_widget_set_range(self, self->min, g_value_get_double(value));
+    break;
+  case PROP_WINDOW:
+    trend_widget_set_window(self, g_value_get_uint(value));
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+    break;
+  }
+}
+
+static void
+trend_widget_get_property(GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+  TrendWidget *self = TREND_WIDGET(object);
+  switch (prop_id) {
+  case PROP_MIN:
+    g_value_set_double(value, self->min);
+    break;
+  case PROP_MAX:
+    g_value_set_double(value, self->max);
+    break;
+  case PROP_WINDOW:
+    g_value_set_uint(value, self->window);
+    break;
+  default:
+    G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+    break;
+  }
+}
+
+/* --- Dispose --- */
+static void
+trend_widget_dispose(GObject *object)
+{
+  TrendWidget *self = TREND_WIDGET(object);
+  g_clear_pointer(&self->buffer, trend_buffer_unref);
+  invalidate_bars(self);
+  G_OBJECT_CLASS(trend_widget_parent_class)->dispose(object);
+}
+
+static void
+trend_widget_finalize(GObject *object)
+{
+  TrendWidget *self = TREND_WIDGET(object);
+  g_free(self->col_min);
+  g_free(self->col_max);
+  G_OBJECT_CLASS(trend_widget_parent_class)->finalize(object);
+}
+
+/* --- Class/init --- */
+static void
+trend_widget_class_init(TrendWidgetClass *klass)
+{
+  GtkWidgetClass *widget_class = GTK_WIDGET_CLASS(klass);
+  widget_class->snapshot = trend_widget_snapshot;
+  widget_class->measure  = trend_widget_measure;
+
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->set_property = trend_widget_set_property;
+  object_class->get_property = trend_widget_get_property;
+  object_class->dispose      = trend_widget_dispose;
+  object_class->finalize     = trend_widget_finalize;
+
+  obj_properties[PROP_MIN] = g_param_spec_double("min", "Minimum", "Value at the bottom edge",
+                                                 -G_MAXDOUBLE, G_MAXDOUBLE, 0.0,
+                                                 G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                 G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_MAX] = g_param_spec_double("max", "Maximum", "Value at the top edge",
+                                                 -G_MAXDOUBLE, G_MAXDOUBLE, 100.0,
+                                                 G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                 G_PARAM_STATIC_STRINGS);
+  obj_properties[PROP_WINDOW] = g_param_spec_uint("window", "Window",
+                                                  "Samples spanning the full width (0: the whole buffer)",
+                                                  0, G_MAXUINT, 0,
+                                                  G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY |
+                                                  G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties(object_class, N_PROPERTIES, obj_properties);
+  gtk_widget_class_set_css_name(widget_class, "trendwidget");
+}
+
+static void
+trend_widget_init(TrendWidget *self)
+{
+  self->min = 0.0;
+  self->max = 100.0;
+  self->window = 0;
+
+  self->buffer = NULL;
+
+  self->col_min = NULL;
+  self->col_max = NULL;
+  self->n_cols  = 0;
+
+  self->bars = NULL;
+}
+
+/* --- Public API --- */
+GtkWidget *
+trend_widget_new(void)
+{
+  return g_object_new(TREND_TYPE_WIDGET, NULL);
+}
+
+/* The owner appends to @buffer and queues a draw when it did */
+void
+trend_widget_set_buffer(TrendWidget *self, TrendBuffer *buffer)
+{
+  g_return_if_fail(TREND_IS_WIDGET(self));
+
+  if (buffer == self->buffer)
+    return;
+
+  if (buffer)
+    trend_buffer_ref(buffer);
+  g_clear_pointer(&self->buffer, trend_buffer_unref);
+  self->buffer = buffer;
+
+  invalidate_bars(self);
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+TrendBuffer *
+trend_widget_get_buffer(TrendWidget *self)
+{
+  g_return_val_if_fail(TREND_IS_WIDGET(self), NULL);
+  return self->buffer;
+}
+
+void
+trend_widget_set_range(TrendWidget *self, double min, double max)
+{
+  g_return_if_fail(TREND_IS_WIDGET(self));
+
+  if (min == self->min && max == self->max)
+    return;
+
+  g_object_freeze_notify(G_OBJECT(self));
+  if (min != self->min) {
+    self->min = min;
+    g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MIN]);
+  }
+  if (max != self->max) {
+    self->max = max;
+    g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_MAX]);
+  }
+  g_object_thaw_notify(G_OBJECT(self));
+
+  invalidate_bars(self);
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+void
+trend_widget_set_window(TrendWidget *self, guint samples)
+{
+  g_return_if_fail(TREND_IS_WIDGET(self));
+
+  if (samples == self->window)
+    return;
+
+  self->window = samples;
+  g_object_notify_by_pspec(G_OBJECT(self), obj_properties[PROP_WINDOW]);
+  invalidate_bars(self);
+  gtk_widget_queue_draw(GTK_WIDGET(self));
+}
+
+guint
+trend_widget_get_window(TrendWidget *self)
+{
+  g_return_val_if_fail(TREND_IS_WIDGET(self), 0);
+  return self->window;
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <gtk/gtk.h>
+#include "trend_buffer.h"
+
+G_BEGIN_DECLS
+
+#define TREND_TYPE_WIDGET (trend_widget_get_type())
+
+/* Sparkline of a TrendBuffer, drawn as one min/max bar per device pixel
+ * column */
+G_DECLARE_FINAL_TYPE(TrendWidget, trend_widget, TREND, WIDGET, GtkWidget)
+
+/* Public API */
+GtkWidget *trend_widget_new(void);
+
+void         trend_widget_set_buffer(TrendWidget *self, TrendBuffer *buffer);
+TrendBuffer *trend_widget_get_buffer(TrendWidget *self);
+void         trend_widget_set_range(TrendWidget *self, double min, double max);
+void         trend_widget_set_window(TrendWidget *self, guint samples);
+guint        trend_widget_get_window(TrendWidget *self);
+
+G_END_DECLS
@@ -0,0 +1,410 @@
+#include "update_scheduler.h"
+#include "gauge_model.h"
+#include <math.h>
+#include <string.h>
+
+/* Updates applied per model batch, between two looks at the clock */
+#define UPDATE_SCHEDULER_CHUNK     64
+#define UPDATE_SCHEDULER_BUDGET_US 4000
+
+struct _UpdateScheduler {
+  GObject parent_instance;
+
+  guint            n_channels;
+  guint8          *priority;       /* UpdatePriority per channel */
+  gint64          *min_interval;   /* µs between applied updates; 0: no limit */
+  gint64          *last_applied;   /* monotonic µs */
+  TelemetrySample *pending;        /* newest unapplied sample per channel */
+  guint8          *queued;         /* channel waits in one of the queues */
+  GArray          *queues[UPDATE_N_PRIORITIES];  /* channel ids, oldest first */
+  gint64           budget_us;
+  AlarmEngine     *alarms;         /* promotes channels in alarm, if set */
+
+  /* Drain callbacks, for the duration of one drain */
+  TelemetrySampleFunc func;
+  gpointer            user_data;
+
+  UpdateSchedulerStats stats;
+};
+
+G_DEFINE_FINAL_TYPE(UpdateScheduler, update_scheduler, G_TYPE_OBJECT)
+
+GType
+update_priority_get_type(void)
+{
+  static gsize type_id = 0;
+
+  if (g_once_init_enter(&type_id)) {
+    static const GEnumValue values[] = {
+      { UPDATE_PRIORITY_CRITICAL,   "UPDATE_PRIORITY_CRITICAL",   "critical" },
+      { UPDATE_PRIORITY_NORMAL,     "UPDATE_PRIORITY_NORMAL",     "normal" },
+      { UPDATE_PRIORITY_BACKGROUND, "UPDATE_PRIORITY_BACKGROUND", "background" },
+      { 0, NULL, NULL }
+    };
+    GType type = g_enum_register_static(g_intern_static_string("UpdatePriority"), values);
+    g_once_init_leave(&type_id, type);
+  }
+
+  return type_id;
+}
+
+/* --- Collecting --- */
+
+/* Keep the newest sample; a channel joins a queue only once */
+static void
+push_sample(const TelemetrySample *sample, gpointer user_data)
+{
+  UpdateScheduler *self = user_data;
+  const guint c = sample->channel;
+
+  if (c >= self->n_channels) {
+    self->func(sample, self->user_data);
+    self->stats.applied++;
+    return;
+  }
+
+  if (self->queued[c]) {
+    self->stats.coalesced++;
+  } else {
+    UpdatePriority priority = self->priority[c];
+
+    if (self->alarms != NULL && alarm_engine_get_alarm(self->alarms, c) != GAUGE_ALARM_NONE)
+      priority = UPDATE_PRIORITY_CRITICAL;
+
+    self->queued[c] = TRUE;
+    g_array_append_val(self->queues[priority], c);
+  }
+
+  self->pending[c] = *sample;
+}
+
+/* --- Applying --- */
+
+/* Apply what one queue may have now, chunk by chunk until @deadline
+ * (0: none), keeping the rest in arrival order */
+static void
+apply_queue(UpdateScheduler *self, GArray *queue, gint64 now, gint64 deadline)
+{
+  guint *channels = (guint *)queue->data;
+  gboolean in_budget = TRUE;
+  guint kept = 0;
+  guint i = 0;
+
+  while (i < queue->len && in_budget) {
+    const guint end = MIN(i + UPDATE_SCHEDULER_CHUNK, queue->len);
+
+    gauge_model_begin_batch();
+    for (; i < end; i++) {
+      const guint c = channels[i];
+
+      if (self->min_interval[c] > 0 && now - self->last_applied[c] < self->min_interval[c]) {
+        channels[kept++] = c;
+        self->stats.rate_limited++;
+        continue;
+      }
+
+      self->func(&self->pending[c], self->user_data);
+      self->queued[c] = FALSE;
+      self->last_applied[c] = now;
+      self->stats.applied++;
+    }
+    gauge_model_end_batch();
+
+    if (deadline > 0 && g_get_monotonic_time() >= deadline)
+      in_budget = FALSE;
+  }
+
+  /* Out of budget: the rest waits behind the rate-limited ones, in
+   * arrival order */
+  const guint rest = queue->len - i;
+
+  self->stats.deferred += rest;
+  if (kept < i) {
+    memmove(channels + kept, channels + i, rest * sizeof(guint));
+    g_array_set_size(queue, kept + rest);
+  }
+}
+
+/* --- GObject --- */
+static void
+update_scheduler_dispose(GObject *object)
+{
+  UpdateScheduler *self = UPDATE_SCHEDULER(object);
+
+  g_clear_object(&self->alarms);
+
+  G_OBJECT_CLASS(update_scheduler_parent_class)->dispose(object);
+}
+
+static void
+update_scheduler_finalize(GObject *object)
+{
+  UpdateScheduler *self = UPDATE_SCHEDULER(object);
+
+  g_free(self->priority);
+  g_free(self->min_interval);
+  g_free(self->last_applied);
+  g_free(self->pending);
+  g_free(self->queued);
+  for (guint p = 0; p < UPDATE_N_PRIORITIES; p++)
+    g_array_unref(self->queues[p]);
+
+  G_OBJECT_CLASS(update_scheduler_parent_class)->finalize(object);
+}
+
+static void
+update_scheduler_class_init(UpdateSchedulerClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS(klass);
+  object_class->dispose  = update_scheduler_dispose;
+  object_class->finalize = update_scheduler_finalize;
+}
+
+static void
+update_scheduler_init(UpdateScheduler *self)
+{
+  self->n_channels   = 0;
+  self->priority     = NULL;
+  self->min_interval = NULL;
+  self->last_applied = NULL;
+  self->pending      = NULL;
+  self->queued       = NULL;
+  self->budget_us    = UPDATE_SCHEDULER_BUDGET_US;
+  self->alarms       = NULL;
+  self->func         = NULL;
+  self->user_data    = NULL;
+  memset(&self->stats, 0, sizeof(self->stats));
+
+  for (guint p = 0; p < UPDATE_N_PRIORITIES; p++)
+    self->queues[p] = g_array_new(FALSE, FALSE, sizeof(guint));
+}
+
+/* --- Policy file --- */
+typedef struct {
+  UpdatePriority priority;
+  double         max_rate;
+} ChannelPolicy;
+
+typedef struct {
+  guint         channel;
+  ChannelPolicy policy;
+} PolicyUpdate;
+
+/* Keys missing from @group keep what @policy has */
+static gboolean
+read_policy(GKeyFile *key_file, const char *group, ChannelPolicy *policy, GError **error)
+{
+  GError *local_error = NULL;
+
+  if (g_key_file_has_key(key_file, group, "priority", NULL)) {
+    g_autofree char *nick = g_key_file_get_string(key_file, group, "priority", error);
+    if (nick == NULL)
+      return FALSE;
+
+    g_autoptr(GEnumClass) klass = g_type_class_ref(UPDATE_TYPE_PRIORITY);
+    GEnumValue *value = g_enum_get_value_by_nick(klass, g_strstrip(nick));
+    if (value == NULL) {
+      g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                  "[%s] priority must be critical, normal or background, not %s", group, nick);
+      return FALSE;
+    }
+    policy->priority = value->value;
+  }
+
+  if (g_key_file_has_key(key_file, group, "max-rate", NULL)) {
+    const double rate = g_key_file_get_double(key_file, group, "max-rate", &local_error);
+    if (local_error != NULL) {
+      g_propagate_error(error, local_error);
+      return FALSE;
+    }
+    if (!isfinite(rate) || rate < 0) {
+      g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                  "[%s] max-rate must be 0 or more", group);
+      return FALSE;
+    }
+    policy->max_rate = rate;
+  }
+
+  return TRUE;
+}
+
+static void
+apply_policy(UpdateScheduler *self, guint channel, const ChannelPolicy *policy)
+{
+  update_scheduler_set_priority(self, channel, policy->priority);
+  update_scheduler_set_max_rate(self, channel, policy->max_rate);
+}
+
+/* --- Public API --- */
+UpdateScheduler *
+update_scheduler_new(guint n_channels)
+{
+  g_return_val_if_fail(n_channels > 0, NULL);
+
+  UpdateScheduler *self = g_object_new(UPDATE_TYPE_SCHEDULER, NULL);
+
+  self->n_channels   = n_channels;
+  self->priority     = g_new(guint8, n_channels);
+  self->min_interval = g_new0(gint64, n_channels);
+  self->last_applied = g_new0(gint64, n_channels);
+  self->pending      = g_new0(TelemetrySample, n_channels);
+  self->queued       = g_new0(guint8, n_channels);
+  memset(self->priority, UPDATE_PRIORITY_NORMAL, n_channels);
+
+  return self;
+}
+
+void
+update_scheduler_set_priority(UpdateScheduler *self, guint channel, UpdatePriority priority)
+{
+  g_return_if_fail(UPDATE_IS_SCHEDULER(self));
+  g_return_if_fail(channel < self->n_channels);
+  g_return_if_fail(priority < UPDATE_N_PRIORITIES);
+
+  /* A waiting update finishes in the queue it joined */
+  self->priority[channel] = priority;
+}
+
+void
+update_scheduler_set_max_rate(UpdateScheduler *self, guint channel, double max_rate)
+{
+  g_return_if_fail(UPDATE_IS_SCHEDULER(self));
+  g_return_if_fail(channel < self->n_channels);
+
+  self->min_interval[channel] = max_rate > 0 ? (gint64)(G_USEC_PER_SEC / max_rate) : 0;
+}
+
+void
+update_scheduler_set_budget(UpdateScheduler *self, gint64 budget_us)
+{
+  g_return_if_fail(UPDATE_IS_SCHEDULER(self));
+  g_return_if_fail(budget_us > 0);
+
+  self->budget_us = budget_us;
+}
+
+void
+update_scheduler_set_alarm_engine(UpdateScheduler *self, AlarmEngine *engine)
+{
+  g_return_if_fail(UPDATE_IS_SCHEDULER(self));
+  g_return_if_fail(engine == NULL || ALARM_IS_ENGINE(engine));
+
+  g_set_object(&self->alarms, engine);
+}
+
+gboolean
+update_scheduler_load_policy(UpdateScheduler *self, const char *path, GError **error)
+{
+  g_return_val_if_fail(UPDATE_IS_SCHEDULER(self), FALSE);
+  g_return_val_if_fail(path != NULL, FALSE);
+
+  g_autoptr(GKeyFile) key_file = g_key_file_new();
+  if (!g_key_file_load_from_file(key_file, path, G_KEY_FILE_NONE, error))
+    return FALSE;
+
+  gint64 budget_us = self->budget_us;
+  if (g_key_file_has_key(key_file, "scheduler", "frame-budget", NULL)) {
+    GError *local_error = NULL;
+    const double ms = g_key_file_get_double(key_file, "scheduler", "frame-budget", &local_error);
+
+    if (local_error != NULL) {
+      g_propagate_error(error, local_error);
+      return FALSE;
+    }
+    if (!isfinite(ms) || ms <= 0 || ms > 1000) {
+      g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_INVALID_VALUE,
+                  "[scheduler] frame-budget must be between 0 and 1000 ms");
+      return FALSE;
+    }
+    budget_us = (gint64)(ms * 1000);
+  }
+
+  ChannelPolicy defaults = { UPDATE_PRIORITY_NORMAL, 0.0 };
+  if (g_key_file_has_group(key_file, "default") &&
+      !read_policy(key_file, "default", &defaults, error))
+    return FALSE;
+
+  /* Check every group before applying any, so a bad file changes nothing */
+  g_auto(GStrv) groups = g_key_file_get_groups(key_file, NULL);
+  g_autoptr(GArray) channels = g_array_new(FALSE, FALSE, sizeof(PolicyUpdate));
+
+  for (guint i = 0; groups[i] != NULL; i++) {
+    PolicyUpdate update = { 0, defaults };
+    guint64 channel;
+
+    if (g_str_equal(groups[i], "default") || g_str_equal(groups[i], "scheduler"))
+      continue;
+
+    if (!g_str_has_prefix(groups[i], "channel ")) {
+      g_set_error(error, G_KEY_FILE_ERROR, G_KEY_FILE_ERROR_GROUP_NOT_FOUND,
+                  "Unknown group [%s]: expected [scheduler], [default] or [channel N]", groups[i]);
+      return FALSE;
+    }
+    if (!g_ascii_string_to_unsigned(groups[i] + strlen("channel "), 10,
+                                    0, self->n_channels - 1, &channel, error) ||
+        !read_policy(key_file, groups[i], &update.policy, error))
+      return FALSE;
+
+    update.channel = (guint)channel;
+    g_array_append_val(channels, update);
+  }
+
+  self->budget_us = budget_us;
+  for (guint c = 0; c < self->n_channels; c++)
+    apply_policy(self, c, &defaults);
+  for (guint i = 0; i < channels->len; i++) {
+    const PolicyUpdate *update = &g_array_index(channels, PolicyUpdate, i);
+    apply_policy(self, update->channel, &update->policy);
+  }
+
+  return TRUE;
+}
+
+/* Collecting counts against the budget: the source's drain is bounded,
+ * so a producer that keeps writing cannot hold the frame for good.
+ * Critical first and in full; then normal and background while the
+ * budget lasts. Past the deadline each lower class still gets its
+ * oldest chunk, so a frame overruns by two chunks at most and no class
+ * starves for good. */
+void
+update_scheduler_drain(UpdateScheduler     *self,
+                       TelemetrySource     *source,
+                       TelemetrySampleFunc  func,
+                       gpointer             user_data)
+{
+  g_return_if_fail(UPDATE_IS_SCHEDULER(self));
+  g_return_if_fail(TELEMETRY_IS_SOURCE(source));
+  g_return_if_fail(func != NULL);
+
+  const gint64 start = g_get_monotonic_time();
+  const gint64 deadline = start + self->budget_us;
+
+  self->func      = func;
+  self->user_data = user_data;
+
+  gauge_model_begin_batch();
+  telemetry_source_drain(source, push_sample, self);
+  gauge_model_end_batch();
+
+  apply_queue(self, self->queues[UPDATE_PRIORITY_CRITICAL], start, 0);
+  for (guint p = UPDATE_PRIORITY_NORMAL; p < UPDATE_N_PRIORITIES; p++)
+    apply_queue(self, self->queues[p], start, deadline);
+
+  self->func      = NULL;
+  self->user_data = NULL;
+
+  self->stats.last_apply_us = g_get_monotonic_time() - start;
+  self->stats.max_apply_us  = MAX(self->stats.max_apply_us, self->stats.last_apply_us);
+}
+
+void
+update_scheduler_get_stats(UpdateScheduler *self, UpdateSchedulerStats *stats)
+{
+  g_return_if_fail(UPDATE_IS_SCHEDULER(self));
+  g_return_if_fail(stats != NULL);
+
+  *stats = self->stats;
+  stats->pending = 0;
+  for (guint p = 0; p < UPDATE_N_PRIORITIES; p++)
+    stats->pending += self->queues[p]->len;
+}
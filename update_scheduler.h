@@ -0,0 +1,73 @@
+#pragma once
+#include <glib-object.h>
+#include "alarm_engine.h"
+#include "telemetry_source.h"
+
+G_BEGIN_DECLS
+
+#define UPDATE_TYPE_SCHEDULER (update_scheduler_get_type())
+#define UPDATE_TYPE_PRIORITY  (update_priority_get_type())
+
+/* Order in which pending channel updates are applied. CRITICAL updates
+ * are applied every frame; the others while the frame budget lasts, plus
+ * a small chunk per class and frame so none starves. */
+typedef enum {
+  UPDATE_PRIORITY_CRITICAL,
+  UPDATE_PRIORITY_NORMAL,
+  UPDATE_PRIORITY_BACKGROUND,
+} UpdatePriority;
+
+#define UPDATE_N_PRIORITIES (UPDATE_PRIORITY_BACKGROUND + 1)
+
+GType update_priority_get_type(void);
+
+typedef struct {
+  guint64 applied;        /* updates handed to the pages */
+  guint64 coalesced;      /* samples replaced by a newer one before being applied */
+  guint64 deferred;       /* times an update waited for a later frame's budget */
+  guint64 rate_limited;   /* times an update waited for its channel's max rate */
+  guint   pending;        /* channels waiting now */
+  gint64  last_apply_us;  /* cost of the last frame's updates */
+  gint64  max_apply_us;
+} UpdateSchedulerStats;
+
+/* Sits between the telemetry source and the models on the main thread.
+ * Each frame, the source is drained, but only the newest sample per
+ * channel is kept. Those are then applied in priority order, in small
+ * model batches, until the frame budget is spent. Whatever is left waits
+ * for the next frame, still coalescing. Sources bound what one drain
+ * hands out (about one ring's worth) and keep the rest for later too, so
+ * an overloaded input costs a bounded slice of each frame and input
+ * handling keeps the rest. Main thread only. */
+G_DECLARE_FINAL_TYPE(UpdateScheduler, update_scheduler, UPDATE, SCHEDULER, GObject)
+
+UpdateScheduler *update_scheduler_new(guint n_channels);
+
+/* Channels default to NORMAL with no rate limit */
+void     update_scheduler_set_priority(UpdateScheduler *self, guint channel, UpdatePriority priority);
+
+/* At most @max_rate applied updates per second; 0 for no limit */
+void     update_scheduler_set_max_rate(UpdateScheduler *self, guint channel, double max_rate);
+
+/* Time per frame for NORMAL and BACKGROUND updates; default 4 ms */
+void     update_scheduler_set_budget(UpdateScheduler *self, gint64 budget_us);
+
+/* Channels with any alarm in @engine count as CRITICAL */
+void     update_scheduler_set_alarm_engine(UpdateScheduler *self, AlarmEngine *engine);
+
+/* Key file with an optional [scheduler] group (frame-budget in ms), an
+ * optional [default] group and [channel N] groups that override it, with
+ * keys priority (critical, normal or background) and max-rate (Hz) */
+gboolean update_scheduler_load_policy(UpdateScheduler *self, const char *path, GError **error);
+
+/* Drain @source, then apply what the budget allows through @func, each
+ * chunk inside a gauge model batch. Samples of channels beyond
+ * n_channels are applied at once. */
+void     update_scheduler_drain(UpdateScheduler     *self,
+                                TelemetrySource     *source,
+                                TelemetrySampleFunc  func,
+                                gpointer             user_data);
+
+void     update_scheduler_get_stats(UpdateScheduler *self, UpdateSchedulerStats *stats);
+
+G_END_DECLS
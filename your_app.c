@@ -3,15 +3,49 @@
 #include <glib/gi18n.h>
 #include <gtk/gtk.h>
 #include <adwaita.h>
+#include <stdio.h>
 
 #include "your_app.h"
+#include "alarm_engine.h"
 #include "main_window.h"
+#include "dashboard_export.h"
+#include "memory_budget.h"
+#include "quality_governor.h"
+#include "startup_trace.h"
+#include "telemetry_aggregator.h"
+#include "telemetry_stream.h"
+#include "telemetry_recorder.h"
+#include "telemetry_replay.h"
+#include "telemetry_shm_source.h"
+#include "update_scheduler.h"
 
 struct _YourAppApplication
 {
   AdwApplication parent_instance;
+
+  char            *telemetry_path;  /* --telemetry */
+  char            *shm_name;        /* --telemetry-shm */
+  char            *record_path;     /* --record */
+  char            *replay_path;     /* --replay */
+  double           replay_speed;    /* --replay-speed */
+  int              memory_budget;   /* --memory-budget, MiB; -1: default */
+  char            *alarm_limits;    /* --alarm-limits */
+  char            *aggregate;       /* --aggregate, TelemetryReduction nick */
+  double           aggregate_ms;    /* --aggregate-interval */
+  DashboardLayout *layout;          /* --layout; NULL: the bundled one */
+  char            *update_policy;   /* --update-policy */
+  TelemetrySource *telemetry;       /* NULL: dashboard uses demo data */
+  AlarmEngine     *alarms;          /* NULL without --alarm-limits */
+  UpdateScheduler *scheduler;       /* paces telemetry into the pages */
 };
 
+/* Channels the alarm engine evaluates; samples beyond are ignored */
+#define YOUR_APP_ALARM_CHANNELS 65536
+/* Channels the aggregation stage reduces; samples beyond are ignored */
+#define YOUR_APP_AGGREGATE_CHANNELS 65536
+/* Channels the update scheduler paces; samples beyond are applied at once */
+#define YOUR_APP_SCHEDULER_CHANNELS 65536
+
 G_DEFINE_FINAL_TYPE (YourAppApplication, your_app_application, ADW_TYPE_APPLICATION)
 
 YourAppApplication*
@@ -26,13 +60,10 @@ your_app_application_new (const char *application_id, GApplicationFlags flags)
       NULL);
 }
 
-/* Load global CSS once at application startup */
+/* Global CSS, for the windows of the application and for export */
 static void
-your_app_application_startup (GApplication *app)
+your_app_load_css (void)
 {
-  /* Chain up to parent startup */
-  G_APPLICATION_CLASS (your_app_application_parent_class)->startup (app);
-
   GtkCssProvider *provider = gtk_css_provider_new ();
   gtk_css_provider_load_from_resource (provider, "/org/gnome/Example/gtk.css");
 
@@ -42,6 +73,347 @@ your_app_application_startup (GApplication *app)
       GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
 }
 
+/* Only entering a critical level is worth interrupting the user for */
+static void
+your_app_application_alarm_transitions (AlarmEngine           *engine,
+                                        const AlarmTransition *transitions,
+                                        guint                  n_transitions,
+                                        YourAppApplication    *self)
+{
+  guint n_critical = 0;
+  guint first = 0;
+
+  for (guint i = 0; i < n_transitions; i++)
+  {
+    const AlarmTransition *t = &transitions[i];
+
+    if ((t->new_alarm & GAUGE_ALARM_CRITICAL) && !(t->old_alarm & GAUGE_ALARM_CRITICAL))
+    {
+      if (n_critical++ == 0)
+        first = i;
+    }
+  }
+
+  if (n_critical == 0)
+    return;
+
+  g_autoptr(GNotification) notification = g_notification_new (_("Critical alarm"));
+  g_autofree char *body = NULL;
+
+  if (n_critical == 1)
+    body = g_strdup_printf (_("Channel %u is at %g"),
+                            transitions[first].channel, transitions[first].value);
+  else
+    body = g_strdup_printf (_("Channel %u and %u more channels entered a critical alarm"),
+                            transitions[first].channel, n_critical - 1);
+
+  g_notification_set_body (notification, body);
+  g_notification_set_priority (notification, G_NOTIFICATION_PRIORITY_URGENT);
+  g_application_send_notification (G_APPLICATION (self), "alarm", notification);
+}
+
+/* A bad policy file leaves the defaults: everything normal, 4 ms a frame */
+static void
+your_app_application_start_scheduler (YourAppApplication *self)
+{
+  g_autoptr(GError) error = NULL;
+
+  self->scheduler = update_scheduler_new (YOUR_APP_SCHEDULER_CHANNELS);
+  if (self->alarms)
+    update_scheduler_set_alarm_engine (self->scheduler, self->alarms);
+
+  if (self->update_policy != NULL &&
+      !update_scheduler_load_policy (self->scheduler, self->update_policy, &error))
+    g_warning ("Update policy ignored: %s", error->message);
+}
+
+static void
+your_app_application_start_alarms (YourAppApplication *self)
+{
+  g_autoptr(AlarmEngine) engine = alarm_engine_new (YOUR_APP_ALARM_CHANNELS);
+  g_autoptr(GError) error = NULL;
+
+  if (!alarm_engine_load_limits (engine, self->alarm_limits, &error) ||
+      !alarm_engine_start (engine, &error))
+  {
+    g_warning ("Alarms disabled: %s", error->message);
+    return;
+  }
+
+  g_signal_connect_object (engine, "transitions",
+                           G_CALLBACK (your_app_application_alarm_transitions),
+                           self, 0);
+  self->alarms = g_steal_pointer (&engine);
+}
+
+/* Load global CSS once at application startup */
+static void
+your_app_application_startup (GApplication *app)
+{
+  /* Chain up to parent startup */
+  G_APPLICATION_CLASS (your_app_application_parent_class)->startup (app);
+  startup_trace_mark ("application startup");
+
+  your_app_load_css ();
+  startup_trace_mark ("css loaded");
+
+  YourAppApplication *self = YOUR_APP_APPLICATION (app);
+
+  if (self->memory_budget >= 0)
+    memory_budget_set_limit ((gsize) self->memory_budget * 1024 * 1024);
+  memory_budget_watch_memory_monitor ();
+
+  if (self->alarm_limits != NULL)
+    your_app_application_start_alarms (self);
+
+  g_autoptr(GError) error = NULL;
+  TelemetrySource *source = NULL;
+
+  if (self->replay_path != NULL)
+  {
+    TelemetryReplay *replay = telemetry_replay_new (self->replay_path, &error);
+
+    if (replay)
+    {
+      telemetry_replay_set_speed (replay, self->replay_speed);
+      if (self->alarms)
+        telemetry_replay_set_tap (replay, alarm_engine_get_input (self->alarms));
+      source = TELEMETRY_SOURCE (replay);
+    }
+  }
+  else if (self->shm_name != NULL)
+  {
+    TelemetryShmSource *shm = telemetry_shm_source_new (self->shm_name, &error);
+
+    if (shm)
+    {
+      if (self->alarms)
+        telemetry_shm_source_set_tap (shm, alarm_engine_get_input (self->alarms));
+      source = TELEMETRY_SOURCE (shm);
+    }
+  }
+  else if (self->telemetry_path != NULL)
+  {
+    TelemetryStream *stream = telemetry_stream_new_for_path (self->telemetry_path, &error);
+
+    if (stream)
+    {
+      if (self->alarms)
+        telemetry_stream_set_tap (stream, alarm_engine_get_input (self->alarms));
+      source = TELEMETRY_SOURCE (stream);
+    }
+  }
+
+  if (source && self->record_path != NULL)
+  {
+    g_autoptr(GError) record_error = NULL;
+    TelemetryRecorder *recorder = telemetry_recorder_new (source, self->record_path, &record_error);
+
+    if (recorder)
+    {
+      g_object_unref (source);
+      source = TELEMETRY_SOURCE (recorder);
+    }
+    else
+      g_warning ("Recording disabled: %s", record_error->message);
+  }
+
+  /* Last, so the capture and the alarms still see every raw sample */
+  if (source && self->aggregate != NULL)
+  {
+    g_autoptr(GEnumClass) klass = g_type_class_ref (TELEMETRY_TYPE_REDUCTION);
+    GEnumValue *reduction = g_enum_get_value_by_nick (klass, self->aggregate);
+    TelemetryAggregator *aggregator = telemetry_aggregator_new (source, YOUR_APP_AGGREGATE_CHANNELS,
+                                                                reduction->value);
+
+    if (self->aggregate_ms > 0)
+      telemetry_aggregator_set_interval (aggregator, (gint64) (self->aggregate_ms * 1000));
+    g_object_unref (source);
+    source = TELEMETRY_SOURCE (aggregator);
+  }
+
+  if (source && telemetry_source_start (source, &error))
+  {
+    self->telemetry = source;
+    startup_trace_mark ("telemetry started");
+    your_app_application_start_scheduler (self);
+  }
+  else if (error != NULL)
+  {
+    g_warning ("Telemetry disabled: %s", error->message);
+    g_clear_object (&source);
+  }
+}
+
+static void
+your_app_application_shutdown (GApplication *app)
+{
+  YourAppApplication *self = YOUR_APP_APPLICATION (app);
+
+  if (self->telemetry != NULL)
+  {
+    telemetry_source_stop (self->telemetry);
+    g_clear_object (&self->telemetry);
+  }
+  g_clear_object (&self->scheduler);
+
+  /* After the source: its worker pushes into the engine's ring */
+  if (self->alarms != NULL)
+  {
+    alarm_engine_stop (self->alarms);
+    g_clear_object (&self->alarms);
+  }
+
+  G_APPLICATION_CLASS (your_app_application_parent_class)->shutdown (app);
+}
+
+/* --export: render frames of the --replay capture and exit, without
+ * registering the application or opening a window */
+static int
+your_app_application_export (YourAppApplication *self, GVariantDict *options)
+{
+  DashboardExportOptions export;
+  g_autofree char *output_dir = NULL;
+  const char *size = NULL;
+  double seconds;
+  g_autoptr(GError) error = NULL;
+
+  dashboard_export_options_init (&export);
+  g_variant_dict_lookup (options, "export", "^ay", &output_dir);
+  export.output_dir = output_dir;
+  export.capture_path = self->replay_path;
+
+  if (g_variant_dict_lookup (options, "export-start", "d", &seconds))
+    export.start = (gint64) (seconds * G_USEC_PER_SEC);
+  if (g_variant_dict_lookup (options, "export-end", "d", &seconds))
+    export.end = (gint64) (seconds * G_USEC_PER_SEC);
+  if (g_variant_dict_lookup (options, "export-step", "d", &seconds))
+    export.step = (gint64) (seconds * G_USEC_PER_SEC);
+  if (g_variant_dict_lookup (options, "export-size", "&s", &size) &&
+      sscanf (size, "%dx%d", &export.width, &export.height) != 2)
+  {
+    g_printerr ("Invalid --export-size %s, expected WIDTHxHEIGHT\n", size);
+    return 1;
+  }
+
+  if (export.capture_path == NULL)
+  {
+    g_printerr ("--export needs a capture to read values from: pass --replay=FILE\n");
+    return 1;
+  }
+  if (export.step <= 0)
+  {
+    g_printerr ("--export-step must be positive\n");
+    return 1;
+  }
+
+  /* No startup() for us: bring up GTK and the styling ourselves */
+  adw_init ();
+  your_app_load_css ();
+
+  guint n_frames = 0;
+  if (!dashboard_export_run (&export, &n_frames, &error))
+  {
+    g_printerr ("Export failed after %u frames: %s\n", n_frames, error->message);
+    return 1;
+  }
+
+  g_print ("Exported %u frames to %s\n", n_frames, export.output_dir);
+  return 0;
+}
+
+static int
+your_app_application_handle_local_options (GApplication *app, GVariantDict *options)
+{
+  YourAppApplication *self = YOUR_APP_APPLICATION (app);
+
+  g_variant_dict_lookup (options, "telemetry", "^ay", &self->telemetry_path);
+  g_variant_dict_lookup (options, "telemetry-shm", "s", &self->shm_name);
+  g_variant_dict_lookup (options, "record", "^ay", &self->record_path);
+  g_variant_dict_lookup (options, "replay", "^ay", &self->replay_path);
+  g_variant_dict_lookup (options, "replay-speed", "d", &self->replay_speed);
+  g_variant_dict_lookup (options, "memory-budget", "i", &self->memory_budget);
+  g_variant_dict_lookup (options, "alarm-limits", "^ay", &self->alarm_limits);
+  g_variant_dict_lookup (options, "aggregate", "s", &self->aggregate);
+  g_variant_dict_lookup (options, "aggregate-interval", "d", &self->aggregate_ms);
+  g_variant_dict_lookup (options, "update-policy", "^ay", &self->update_policy);
+
+  if (g_variant_dict_contains (options, "trace-startup"))
+    startup_trace_enable ();
+
+  g_autofree char *layout_path = NULL;
+  if (g_variant_dict_lookup (options, "layout", "^ay", &layout_path))
+  {
+    g_autoptr(GError) error = NULL;
+
+    self->layout = dashboard_layout_new_from_file (layout_path, &error);
+    if (self->layout == NULL)
+    {
+      g_printerr ("%s\n", error->message);
+      return 1;
+    }
+    startup_trace_mark ("layout mapped");
+  }
+
+  if (self->replay_path != NULL && (self->telemetry_path != NULL || self->shm_name != NULL))
+    g_warning ("--replay given, ignoring --telemetry and --telemetry-shm");
+  else if (self->shm_name != NULL && self->telemetry_path != NULL)
+    g_warning ("--telemetry-shm given, ignoring --telemetry");
+
+  const char *quality = NULL;
+  if (g_variant_dict_lookup (options, "quality", "&s", &quality))
+  {
+    g_autoptr(GEnumClass) klass = g_type_class_ref (GAUGE_TYPE_DETAIL);
+    GEnumValue *level = g_enum_get_value_by_nick (klass, quality);
+
+    if (level == NULL)
+    {
+      g_printerr ("Unknown quality level: %s\n", quality);
+      return 1;
+    }
+
+    /* auto adapts from full; anything else pins the level */
+    if (level->value == GAUGE_DETAIL_AUTO)
+      quality_governor_set_level (GAUGE_DETAIL_FULL, TRUE);
+    else
+      quality_governor_set_level (level->value, FALSE);
+  }
+
+  if (self->aggregate != NULL)
+  {
+    g_autoptr(GEnumClass) klass = g_type_class_ref (TELEMETRY_TYPE_REDUCTION);
+
+    if (g_enum_get_value_by_nick (klass, self->aggregate) == NULL)
+    {
+      g_printerr ("Unknown aggregation: %s\n", self->aggregate);
+      return 1;
+    }
+  }
+
+  if (g_variant_dict_contains (options, "export"))
+    return your_app_application_export (self, options);
+
+  /* Continue with the default processing */
+  return -1;
+}
+
+static void
+your_app_application_finalize (GObject *object)
+{
+  YourAppApplication *self = YOUR_APP_APPLICATION (object);
+
+  g_free (self->telemetry_path);
+  g_free (self->shm_name);
+  g_free (self->record_path);
+  g_free (self->replay_path);
+  g_free (self->alarm_limits);
+  g_free (self->aggregate);
+  g_free (self->update_policy);
+  g_clear_pointer (&self->layout, dashboard_layout_unref);
+
+  G_OBJECT_CLASS (your_app_application_parent_class)->finalize (object);
+}
+
 static void
 your_app_application_activate (GApplication *app)
 {
@@ -59,15 +431,21 @@ your_app_application_activate (GApplication *app)
   gtk_icon_theme_add_resource_path (theme, "/org/gnome/Example/images");
 
   gtk_window_present (window);
+  startup_trace_mark ("window presented");
 }
 
 static void
 your_app_application_class_init (YourAppApplicationClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GApplicationClass *app_class = G_APPLICATION_CLASS (klass);
 
+  object_class->finalize = your_app_application_finalize;
+
   app_class->startup = your_app_application_startup;
+  app_class->shutdown = your_app_application_shutdown;
   app_class->activate = your_app_application_activate;
+  app_class->handle_local_options = your_app_application_handle_local_options;
 }
 
 static void
@@ -107,10 +485,53 @@ static const GActionEntry app_actions[] = {
 	{ "about", your_app_application_about_action },
 };
 
+static const GOptionEntry app_options[] = {
+	{ "telemetry", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Read telemetry from a FIFO, Unix socket, file or - for stdin"), N_("PATH") },
+	{ "telemetry-shm", 0, 0, G_OPTION_ARG_STRING, NULL,
+	  N_("Poll the shared-memory telemetry segment NAME, e.g. /gauge-telemetry"), N_("NAME") },
+	{ "record", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Record the telemetry the dashboard receives to a capture file"), N_("FILE") },
+	{ "replay", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Play back a capture file instead of live telemetry"), N_("FILE") },
+	{ "replay-speed", 0, 0, G_OPTION_ARG_DOUBLE, NULL,
+	  N_("Replay speed: 1 real time, N times faster, 0 as fast as possible"), N_("SPEED") },
+	{ "memory-budget", 0, 0, G_OPTION_ARG_INT, NULL,
+	  N_("Cache memory of hidden pages before eviction, 0 for no limit"), N_("MIB") },
+	{ "alarm-limits", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Evaluate channel alarms against the limits in a key file"), N_("FILE") },
+	{ "aggregate", 0, 0, G_OPTION_ARG_STRING, NULL,
+	  N_("Reduce each channel to one value per display interval: last, mean, min, max or rms"), N_("MODE") },
+	{ "aggregate-interval", 0, 0, G_OPTION_ARG_DOUBLE, NULL,
+	  N_("Display interval of --aggregate, default 16.7"), N_("MS") },
+	{ "update-policy", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Channel priorities, rate limits and frame budget for applying telemetry, from a key file"), N_("FILE") },
+	{ "layout", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Show the gauges of a compiled dashboard layout on the Gauges page"), N_("FILE") },
+	{ "quality", 0, 0, G_OPTION_ARG_STRING, NULL,
+	  N_("Gauge detail: auto, full, reduced, flat, basic or minimal"), N_("LEVEL") },
+	{ "export", 0, 0, G_OPTION_ARG_FILENAME, NULL,
+	  N_("Render dashboard frames of the --replay capture to PNG files in DIR and exit"), N_("DIR") },
+	{ "export-start", 0, 0, G_OPTION_ARG_DOUBLE, NULL,
+	  N_("First exported instant, in seconds after the start of the capture"), N_("SECONDS") },
+	{ "export-end", 0, 0, G_OPTION_ARG_DOUBLE, NULL,
+	  N_("Last exported instant, in seconds after the start of the capture"), N_("SECONDS") },
+	{ "export-step", 0, 0, G_OPTION_ARG_DOUBLE, NULL,
+	  N_("Time between exported instants, default 1"), N_("SECONDS") },
+	{ "export-size", 0, 0, G_OPTION_ARG_STRING, NULL,
+	  N_("Size of exported frames, default the dashboard's natural size"), N_("WIDTHxHEIGHT") },
+	{ "trace-startup", 0, 0, G_OPTION_ARG_NONE, NULL,
+	  N_("Print timestamped startup phases to stderr"), NULL },
+	{ NULL }
+};
+
 
 static void
 your_app_application_init (YourAppApplication *self)
 {
+  self->replay_speed = 1.0;
+  self->memory_budget = -1;
+
   g_action_map_add_action_entries (G_ACTION_MAP (self),
 	                                 app_actions,
 	                                 G_N_ELEMENTS (app_actions),
@@ -118,4 +539,52 @@ your_app_application_init (YourAppApplication *self)
 	gtk_application_set_accels_for_action (GTK_APPLICATION (self),
 	                                       "app.quit",
 	                                       (const char *[]) { "<control>q", NULL });
+	gtk_application_set_accels_for_action (GTK_APPLICATION (self),
+	                                       "win.show-perf-hud",
+	                                       (const char *[]) { "F12", NULL });
+	g_application_add_main_option_entries (G_APPLICATION (self), app_options);
+}
+
+TelemetrySource *
+your_app_application_get_telemetry_source (YourAppApplication *self)
+{
+	g_return_val_if_fail (YOUR_APP_IS_APPLICATION (self), NULL);
+
+	return self->telemetry;
+}
+
+AlarmEngine *
+your_app_application_get_alarm_engine (YourAppApplication *self)
+{
+	g_return_val_if_fail (YOUR_APP_IS_APPLICATION (self), NULL);
+
+	return self->alarms;
+}
+
+UpdateScheduler *
+your_app_application_get_update_scheduler (YourAppApplication *self)
+{
+	g_return_val_if_fail (YOUR_APP_IS_APPLICATION (self), NULL);
+
+	return self->scheduler;
+}
+
+double
+your_app_application_get_sample_rate (YourAppApplication *self)
+{
+	g_return_val_if_fail (YOUR_APP_IS_APPLICATION (self), 0);
+
+	if (!TELEMETRY_IS_AGGREGATOR (self->telemetry))
+		return 0;
+
+	return (double) G_USEC_PER_SEC /
+	       telemetry_aggregator_get_interval (TELEMETRY_AGGREGATOR (self->telemetry));
+}
+
+DashboardLayout *
+your_app_application_get_layout (YourAppApplication *self)
+{
+	g_return_val_if_fail (YOUR_APP_IS_APPLICATION (self), NULL);
+
+	return self->layout;
 }
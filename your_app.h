@@ -1,6 +1,10 @@
 #pragma once
 
 #include <adwaita.h>
+#include "alarm_engine.h"
+#include "dashboard_layout.h"
+#include "telemetry_source.h"
+#include "update_scheduler.h"
 
 G_BEGIN_DECLS
 
@@ -10,4 +14,17 @@ G_DECLARE_FINAL_TYPE (YourAppApplication, your_app_application, YOUR_APP, APPLIC
 
 YourAppApplication *your_app_application_new (const char *application_id, GApplicationFlags flags);
 
+TelemetrySource    *your_app_application_get_telemetry_source (YourAppApplication *self);
+AlarmEngine        *your_app_application_get_alarm_engine (YourAppApplication *self);
+
+/* Set whenever the telemetry source is; pages drain the source through it */
+UpdateScheduler    *your_app_application_get_update_scheduler (YourAppApplication *self);
+
+/* Samples per second and channel the pages receive: one per display
+ * interval with --aggregate, 0 when the source does not say */
+double              your_app_application_get_sample_rate (YourAppApplication *self);
+
+/* --layout, or NULL for the bundled layout */
+DashboardLayout    *your_app_application_get_layout (YourAppApplication *self);
+
 G_END_DECLS